@@ -0,0 +1,91 @@
+#ifndef __BLOOM_H__
+#define __BLOOM_H__
+
+/**
+ *  @file bloom.h
+ *  @brief Cache line blocked Bloom filter for fast negative lookups.
+ *
+ *  @details  The filter answers "certainly absent" or "maybe present" for a key
+ *  hash. The bit array is split into 512 bit blocks, one cache line each: a key
+ *  hash picks one block and sets or tests all of its bits inside that block, so
+ *  every add or query touches a single cache line.
+ *
+ *  The filter works on hash values and not on keys, callers pass the value of
+ *  their HashFunction. Keys can not be removed.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include <stddef.h> /*< size_t >*/
+
+typedef struct Bloom Bloom;
+
+/**
+ * @brief Create an empty filter sized for a false positive rate.
+ * @param[in] _expectedItems - number of keys the filter is sized for
+ * @param[in] _fpRate - wanted false positive rate once _expectedItems were added, 0 < _fpRate < 1
+ * @return newly created filter or null on failure
+ */
+Bloom* BloomCreate(size_t _expectedItems, double _fpRate);
+
+/**
+ * @brief destroy the filter and set *_bloom to null
+ * @param[in] _bloom : filter to be destroyed
+ */
+void BloomDestroy(Bloom** _bloom);
+
+/**
+ * @brief Add a key hash to the filter
+ * @param[in] _bloom - filter to add to
+ * @param[in] _hash - hash value of the key
+ * @return DS_SUCCESS or DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error BloomAdd(Bloom* _bloom, size_t _hash);
+
+/**
+ * @brief Query a key hash
+ * @param[in] _bloom - filter to query
+ * @param[in] _hash - hash value of the key
+ * @return 0 if the key was certainly never added, none zero if it may have been
+ */
+int BloomMayContain(const Bloom* _bloom, size_t _hash);
+
+/**
+ * @brief Query many key hashes, the blocks of the whole batch are prefetched before they are tested
+ * @param[in] _bloom - filter to query
+ * @param[in] _hashes - hash values of the keys
+ * @param[in] _numOfHashes - number of hash values
+ * @param[out] _results - none zero for every hash that may be present
+ * @return number of hashes that may be present
+ */
+size_t BloomMayContainBatch(const Bloom* _bloom, const size_t* _hashes, size_t _numOfHashes, unsigned char* _results);
+
+/**
+ * @brief Get number of hashes added to the filter
+ */
+size_t BloomSize(const Bloom* _bloom);
+
+/**
+ * @brief Write the filter into a buffer
+ * @param[in] _bloom - filter to serialize
+ * @param[out] _buffer - where to write the filter
+ * @param[in] _bufferSize - size of _buffer
+ * @return number of bytes the serialized filter needs, 0 on invalid params.
+ *         If bigger than _bufferSize nothing was written.
+ *
+ * @warning the serialized form uses the native byte order
+ */
+size_t BloomSerialize(const Bloom* _bloom, void* _buffer, size_t _bufferSize);
+
+/**
+ * @brief Create a filter from a buffer written by BloomSerialize
+ * @param[in] _buffer - serialized filter
+ * @param[in] _bufferSize - size of _buffer
+ * @return newly created filter or null on failure or a corrupted buffer
+ */
+Bloom* BloomDeserialize(const void* _buffer, size_t _bufferSize);
+
+#endif /* __BLOOM_H__ */
@@ -0,0 +1,78 @@
+#ifndef __CUCKOO_FILTER_H__
+#define __CUCKOO_FILTER_H__
+
+/**
+ *  @file cuckoo_filter.h
+ *  @brief Cuckoo filter, an approximate membership set that supports removal.
+ *
+ *  @details  The filter keeps a 16 bit fingerprint per key in one of two
+ *  candidate buckets of four fingerprints. A bucket is one 64 bit word, so a
+ *  query compares all four fingerprints of a bucket at once and touches at
+ *  most two cache lines. When both buckets of a new key are full, resident
+ *  fingerprints are kicked to their other bucket, a bounded number of times.
+ *  The false positive rate is about 8 / 65536 at any load.
+ *
+ *  Like the Bloom filter it works on hash values and not on keys, callers pass
+ *  the value of their HashFunction. Only hashes that were added may be deleted.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include <stddef.h> /*< size_t >*/
+
+typedef struct CuckooFilter CuckooFilter;
+
+/**
+ * @brief Create an empty filter.
+ * @param[in] _expectedItems - number of keys the filter is sized for, at a load of at most 95%
+ * @return newly created filter or null on failure
+ */
+CuckooFilter* CuckooFilterCreate(size_t _expectedItems);
+
+/**
+ * @brief destroy the filter and set *_filter to null
+ * @param[in] _filter : filter to be destroyed
+ */
+void CuckooFilterDestroy(CuckooFilter** _filter);
+
+/**
+ * @brief Add a key hash to the filter, the same hash may be added more than once
+ * @param[in] _filter - filter to add to
+ * @param[in] _hash - hash value of the key
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_OVERFLOW_ERROR if the filter is full, nothing was added
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error CuckooFilterAdd(CuckooFilter* _filter, size_t _hash);
+
+/**
+ * @brief Query a key hash
+ * @param[in] _filter - filter to query
+ * @param[in] _hash - hash value of the key
+ * @return 0 if the key is certainly not in the filter, none zero if it may be
+ */
+int CuckooFilterContains(const CuckooFilter* _filter, size_t _hash);
+
+/**
+ * @brief Delete one copy of a key hash
+ * @param[in] _filter - filter to delete from
+ * @param[in] _hash - hash value of the key, must have been added
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if no matching fingerprint is in the filter
+ * @retval  DS_UNINITIALIZED_ERROR
+ *
+ * @warning deleting a hash that was never added may delete a colliding key instead
+ */
+aps_ds_error CuckooFilterDelete(CuckooFilter* _filter, size_t _hash);
+
+/**
+ * @brief Get number of hashes in the filter
+ */
+size_t CuckooFilterSize(const CuckooFilter* _filter);
+
+#endif /* __CUCKOO_FILTER_H__ */
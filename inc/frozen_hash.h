@@ -0,0 +1,138 @@
+#ifndef __FROZEN_HASH_H__
+#define __FROZEN_HASH_H__
+
+/**
+ *  @file frozen_hash.h
+ *  @brief Immutable hash map compiled from a HashMap with a minimal perfect hash.
+ *
+ *  @details  The pairs are laid out in one flat slot array of exactly
+ *  HashMapSize() entries. Slots are addressed with CHD (compress, hash and
+ *  displace): the key hash selects a bucket of about four keys, the bucket's
+ *  displacement pair selects the slot, so a lookup reads one displacement and
+ *  one slot and never probes a second one. The perfect hash is built over the
+ *  distinct hash values, keys whose hash equals another key's are chained in
+ *  slots after the hashed ones and told apart by the equality function.
+ *
+ *  The frozen form can be dumped to a file and loaded again with a single read,
+ *  or mapped with FrozenHashMapMap and served straight from the page cache.
+ *  Keys and values are written by user encode functions and are handed back
+ *  to the equality function as pointers into the loaded image, so the encoded
+ *  form must be usable as a key or value object as is (a NUL terminated string,
+ *  a struct without pointers, ...). A loaded image is checked to stay within
+ *  its own bounds, the encoded keys themselves are handed to the equality
+ *  function as they are.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include "hash.h"   /*< HashMap, HashFunction, EqualityFunction >*/
+#include <stddef.h> /*< size_t >*/
+
+typedef struct FrozenHashMap FrozenHashMap;
+
+/**
+ * @brief Encode a key or a value for FrozenHashMapDump.
+ * @param[in] _item - key or value to encode
+ * @param[out] _buffer - where to write the encoded bytes
+ * @param[in] _bufferSize - size of _buffer
+ * @return number of bytes the encoded form needs.
+ *         If bigger than _bufferSize nothing was written and the call is repeated with a larger buffer.
+ */
+typedef size_t (*FrozenEncodeFunction)(const void* _item, void* _buffer, size_t _bufferSize);
+
+/**
+ * @brief Compile the current contents of a map into an immutable FrozenHashMap.
+ * @details keys and values are not copied, they must outlive the frozen map.
+ * @param[in] _map - map to freeze, it is not changed
+ * @return newly created frozen map or NULL on failure or for a map of HashMapCreateSeeded
+ */
+FrozenHashMap* HashMapFreeze(const HashMap* _map);
+
+/**
+ * @brief destroy a frozen map and set *_frozen to null
+ * @details keys and values of a frozen map built by HashMapFreeze are not touched,
+ *          a loaded map releases its whole image.
+ * @param[in] _frozen - frozen map to destroy
+ */
+void FrozenHashMapDestroy(FrozenHashMap** _frozen);
+
+/**
+ * @brief Find a value by key with a single slot probe, keys of a shared hash follow its chain
+ * @param[in] _frozen - frozen map to use
+ * @param[in] _searchKey - key to serve as index for search
+ * @param[out] _pValue - pointer to variable that will get the value assoiciated with the search key.
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ * @retval  DS_GENERAL_ERROR if a probed slot of a loaded image has an offset outside its arena
+ */
+aps_ds_error FrozenHashMapFind(const FrozenHashMap* _frozen, const void* _searchKey, void** _pValue);
+
+/**
+ * @brief Get number of key-value pairs in the frozen map
+ */
+size_t FrozenHashMapSize(const FrozenHashMap* _frozen);
+
+/**
+ * @brief Write the frozen map to a file
+ * @param[in] _frozen - frozen map to dump
+ * @param[in] _fileName - file to create or truncate
+ * @param[in] _keyEncode - encodes each key into the image
+ * @param[in] _valEncode - encodes each value into the image
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_UNINITIALIZED_ERROR
+ * @retval  DS_ALLOCATION_ERROR
+ * @retval  DS_GENERAL_ERROR on I/O failure
+ *
+ * @warning the image uses the native word size and byte order
+ */
+aps_ds_error FrozenHashMapDump(const FrozenHashMap* _frozen, const char* _fileName,
+                               FrozenEncodeFunction _keyEncode, FrozenEncodeFunction _valEncode);
+
+/**
+ * @brief Load a frozen map written by FrozenHashMapDump with one read and no per entry allocation
+ * @details the header and the bounds of every region are checked against the image size,
+ *          the key and value offsets of a slot are checked when FrozenHashMapFind probes it.
+ * @param[in] _fileName - dumped image
+ * @param[in] _hashFunc - the same hashing function the map was frozen with
+ * @param[in] _keysEqualFunc - equality check function, gets the encoded keys
+ * @return loaded frozen map or NULL on failure or a corrupted image
+ */
+FrozenHashMap* FrozenHashMapLoad(const char* _fileName, HashFunction _hashFunc, EqualityFunction _keysEqualFunc);
+
+/**
+ * @brief Map an image written by FrozenHashMapDump or HashMapSave read only into memory.
+ * @details Lookups are served directly from the mapped pages: nothing is copied or
+ *          allocated per entry. Only the header is read here, slot, key and value
+ *          pages are faulted in on first use and each probed slot is checked then.
+ *          FrozenHashMapDestroy unmaps the image.
+ * @param[in] _fileName - dumped image
+ * @param[in] _hashFunc - the same hashing function the map was frozen with
+ * @param[in] _keysEqualFunc - equality check function, gets the encoded keys
+ * @return mapped frozen map or NULL on failure or a corrupted image
+ * @warning the file must not be truncated or rewritten while it is mapped
+ */
+FrozenHashMap* FrozenHashMapMap(const char* _fileName, HashFunction _hashFunc, EqualityFunction _keysEqualFunc);
+
+/**
+ * @brief Persist a HashMap as a frozen image, HashMapFreeze followed by FrozenHashMapDump.
+ * @param[in] _map - map to save, it is not changed
+ * @param[in] _fileName - file to create or truncate
+ * @param[in] _keyEncode - encodes each key into the image
+ * @param[in] _valEncode - encodes each value into the image
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_UNINITIALIZED_ERROR
+ * @retval  DS_ALLOCATION_ERROR
+ * @retval  DS_GENERAL_ERROR if the map can not be frozen or on I/O failure
+ */
+aps_ds_error HashMapSave(const HashMap* _map, const char* _fileName,
+                         FrozenEncodeFunction _keyEncode, FrozenEncodeFunction _valEncode);
+
+#endif /* __FROZEN_HASH_H__ */
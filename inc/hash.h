@@ -10,17 +10,36 @@
  *  size of allocated table will be the nearest prime number greater than requested capacity.
  *  Lists used for chaining will be allocated eagerly.
  *
+ *  Keys picked to collide, e.g. by an untrusted client, are detected on insert:
+ *  a chain far longer than the load factor makes the map draw a random seed,
+ *  mix it into every hash before the bucket is chosen and rehash, growing to
+ *  at least one bucket per pair. Until then the hash modulo the capacity picks
+ *  the bucket. Keys whose hashes are fully equal can not be scattered by any
+ *  seed mixed in after the hash function, and a lookup in their chain stays
+ *  linear: the map only knows key equality, so the chain can not be kept in
+ *  order. Such a flood is counted in Map_Stats numberOfFloodWarnings. A plain
+ *  HashFunction must not be used for keys from an untrusted source, for those
+ *  create the map with HashMapCreateSeeded and a seeded hash function such as
+ *  HashStringSeeded: the map's random seed goes into the hash of every key,
+ *  so colliding keys can not be picked without knowing it.
+ *
  *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
  *  @update Alexei Radashkovsky (alexeirada@gmail.com)
  *  @bug No known bugs.
  */
 
 #include "data_structure_defenitions.h"
+#include "bloom.h"
+#include "hash_itr_internal.h"
 #include <stddef.h>  /* size_t */
+#include <stdint.h>  /* uint64_t */
 
 typedef struct HashMap HashMap;
 
 typedef size_t (*HashFunction)(const void* _key);
+
+/* hashing function keyed by the map's secret seed, see HashMapCreateSeeded */
+typedef size_t (*SeededHashFunction)(const void* _key, uint64_t _seed);
 typedef int (*EqualityFunction)(const void* _firstKey, const void* _secondKey);
 typedef int	(*KeyValueActionFunction)(const void* _key, void* _value, void* _context);
 
@@ -35,6 +54,46 @@ typedef int	(*KeyValueActionFunction)(const void* _key, void* _value, void* _con
  */
 HashMap* HashMapCreate(size_t _capacity, HashFunction _hashFunc, EqualityFunction _keysEqualFunc);
 
+/**
+ * @brief Create a new hash map whose hash function is keyed by a random seed of its own.
+ * @details the seed is drawn once at create and passed with every key to _hashFunc,
+ *          a flood check is not needed and the map is never reseeded. Such a map can not
+ *          be frozen, a FrozenHashMap is looked up with a plain HashFunction.
+ * @param[in] _capacity - Expected max capacity, rounded to nearest larger prime number.
+ * @param[in] _hashFunc - seeded hashing function for keys, e.g. HashStringSeeded or HashSizeTSeeded
+ * @param[in] _keysEqualFunc - equality check function for keys.
+ * @return newly created map or null on failure
+ */
+HashMap* HashMapCreateSeeded(size_t _capacity, SeededHashFunction _hashFunc, EqualityFunction _keysEqualFunc);
+
+/**
+ * @brief Seeded hash of a NUL terminated string, eight bytes per round through a 64 bit mix.
+ * @details not a cryptographic MAC, but without the seed no two strings can be picked to collide.
+ */
+size_t HashStringSeeded(const void* _key, uint64_t _seed);
+
+/**
+ * @brief Seeded hash of a size_t key
+ */
+size_t HashSizeTSeeded(const void* _key, uint64_t _seed);
+
+/**
+ * @brief Create a hash map holding _numOfPairs pairs given as two parallel arrays, using several threads.
+ * @details the keys are hashed in parallel, the pairs are partitioned by contiguous
+ * bucket ranges, one per thread, and every thread fills the chains of its own range
+ * without locks. When a key appears more than once its first pair is kept, as
+ * inserting the pairs in order would.
+ * @param[in] _keys - _numOfPairs keys, none null
+ * @param[in] _values - _numOfPairs values matching the keys, none null
+ * @param[in] _numOfPairs - number of pairs, also the capacity of the new map
+ * @param[in] _numOfThreads - number of threads to use, 1 runs on the calling thread only, at most 64 are used
+ * @param[in] _hashFunc - hashing function for keys, called concurrently
+ * @param[in] _keysEqualFunc - equality check function for keys, called concurrently
+ * @return newly created map or null on failure or if a key or value is null
+ */
+HashMap* HashMapBuildFromArrays(void* const* _keys, void* const* _values, size_t _numOfPairs, size_t _numOfThreads,
+                                HashFunction _hashFunc, EqualityFunction _keysEqualFunc);
+
 
 /**
  * @brief destroy hash map and set *_map to null
@@ -50,7 +109,7 @@ void HashMapDestroy(HashMap** _map, void (*_keyDestroy)(void* _key), void (*_val
  * @brief Adjust map capacity and rehash all key/value pairs
  * @param[in] _map - existing map
  * @param[in] _newCapacity - new capacity shall be rounded to nearest larger prime number.
- * @return DS_SUCCESS or DS_ALLOCATION_ERROR
+ * @return DS_SUCCESS, DS_UNINITIALIZED_ERROR or DS_ALLOCATION_ERROR, the map is unchanged on failure
  */
 aps_ds_error HashMapRehash(HashMap *_map, size_t newCapacity);
 
@@ -68,6 +127,8 @@ aps_ds_error HashMapRehash(HashMap *_map, size_t newCapacity);
  * @retval  DS_UNINITIALIZED_ERROR
  * 
  * @warning key must be unique and destinct
+ * @details a map of a plain HashFunction may reseed and rehash when the chain of the key is found flooded,
+ *          a flood of fully equal hashes is counted in Map_Stats numberOfFloodWarnings instead
  */
 aps_ds_error HashMapInsert(HashMap* _map, const void* _key, const void* _value);
 
@@ -105,6 +166,17 @@ aps_ds_error HashMapRemove(HashMap* _map, const void* _searchKey, void** _pKey,
 aps_ds_error HashMapFind(const HashMap* _map, const void* __searchKey, void** _pValue);
 
 
+/**
+ * @brief Attach a Bloom filter that lets HashMapFind reject most absent keys without touching the table.
+ * @details the hashes of all keys already in the map are added to the filter,
+ *          every insert adds the hash of its key. Removed keys stay in the filter.
+ * @param[in] _map - Hash map to attach to
+ * @param[in] _bloom - filter, it is not owned by the map and must outlive it or be detached. NULL detaches.
+ * @return DS_SUCCESS or DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error HashMapAttachBloom(HashMap* _map, Bloom* _bloom);
+
+
 /**
  * @brief Get number of key-value pairs inserted into the hash map
  * @warning complexity can be O(?)
@@ -126,16 +198,132 @@ size_t HashMapSize(const HashMap* _map);
 size_t HashMapForEach(const HashMap* _map, KeyValueActionFunction _action, void* _context);
 
 
+/**
+ * @brief Iterate over all key-value pairs in parallel, the buckets are split
+ * into _numOfThreads contiguous ranges, one per thread.
+ * All threads stop soon after the called function returns a zero for some pair.
+ *
+ * @param[in] _map - Hash map to iterate over, must not be changed during the call.
+ * @param[in] _numOfThreads - number of threads to use, 1 runs on the calling thread only, at most 64 are used
+ * @param[in] _action - User provided function pointer to be invoked for each element
+ * @param[in] _context - User provided context shared by all threads
+ * @returns number of times the user functions was invoked
+ *
+ * @warning _action is called concurrently and must synchronize its use of _context
+ */
+size_t HashMapForEachParallel(const HashMap* _map, size_t _numOfThreads, KeyValueActionFunction _action, void* _context);
+
+
+/**
+ * @brief Position of a key-value pair during iteration.
+ * The members are private, use the HashMapItr functions only.
+ * Any insert or remove on the map invalidates all its iterators.
+ *
+ * for (itr = HashMapItrBegin(map); !HashMapItrIsEnd(itr); itr = HashMapItrNext(itr)) {
+ *     use(HashMapItrKey(itr), HashMapItrValue(itr));
+ * }
+ */
+typedef struct HashMapItr {
+    const HashMap* m_map;
+    size_t m_bucket;
+    void* m_node;
+} HashMapItr;
+
+/**
+ * @brief Get iterator to the first pair of the map, the end iterator if the map is empty
+ */
+HashMapItr HashMapItrBegin(const HashMap* _map);
+
+/**
+ * @brief Get iterator to the first pair in the bucket of _itr or a later one, the end iterator if none.
+ * @details called by HashMapItrNext when a chain is done, use HashMapItrBegin to start an iteration.
+ */
+HashMapItr HashMapItrSeekBucket(HashMapItr _itr);
+
+/**
+ * @brief Get iterator to the next pair, the end iterator after the last pair
+ */
+static __inline__ HashMapItr HashMapItrNext(HashMapItr _itr) {
+    Node* node = (Node*)_itr.m_node;
+    if (node == NULL) {
+        return _itr;
+    }
+
+    node = node->m_next;
+    if (node != node->m_next) {
+        _itr.m_node = node;
+        return _itr;
+    }
+
+    ++_itr.m_bucket;
+    return HashMapItrSeekBucket(_itr);
+}
+
+/**
+ * @brief none zero if _itr is past the last pair
+ */
+static __inline__ int HashMapItrIsEnd(HashMapItr _itr) {
+    return _itr.m_node == NULL;
+}
+
+/**
+ * @brief Get the key of the pair _itr points at, NULL for the end iterator
+ */
+static __inline__ const void* HashMapItrKey(HashMapItr _itr) {
+    if (_itr.m_node == NULL) {
+        return NULL;
+    }
+    return ((Elements*)((Node*)_itr.m_node)->m_item)->m_key;
+}
+
+/**
+ * @brief Get the value of the pair _itr points at, NULL for the end iterator
+ */
+static __inline__ void* HashMapItrValue(HashMapItr _itr) {
+    if (_itr.m_node == NULL) {
+        return NULL;
+    }
+    return ((Elements*)((Node*)_itr.m_node)->m_item)->m_value;
+}
+
+
 /*#ifndef NDEBUG*/
 
+#define MAP_STATS_HISTOGRAM_SIZE (8)
+
 typedef struct Map_Stats {
 	size_t numberOfBuckets;    /* empty + not empty buckets */
 	size_t numberOfChains;     /* none empty chains (having non zero length) */
 	size_t maxChainLength;     /* length of longest chain */
 	size_t averageChainLength; /* average length of none empty chains */
+	size_t numberOfItems;      /* key-value pairs in the map */
+	double loadFactor;         /* pairs per bucket */
+	double expectedProbesHit;  /* keys compared by an average successful find */
+	double expectedProbesMiss; /* keys compared by an average failed find */
+	size_t bytesAllocated;     /* map, table, chains and pairs */
+	size_t numberOfRehashes;   /* HashMapRehash calls since creation */
+	size_t numberOfFloodWarnings; /* floods of fully equal hashes no reseed could split, use HashMapCreateSeeded */
+	size_t chainLengthHistogram[MAP_STATS_HISTOGRAM_SIZE]; /* buckets per chain length, the last entry counts longer chains too */
 } Map_Stats;
 
+/**
+ * @brief Collect the statistics by walking the whole table
+ * @param[in] _map - Hash map to examine
+ * @return statistics, all zero for a NULL map
+ */
 Map_Stats HashMapGetStatistics(const HashMap* _map);
+
+/**
+ * @brief Estimate the statistics from _numOfSamples evenly spread buckets.
+ * @details cost is proportional to _numOfSamples and not to the map capacity.
+ *          Bucket and chain counts and the histogram are scaled to the whole table,
+ *          maxChainLength is the longest sampled chain. numberOfItems, loadFactor,
+ *          bytesAllocated, numberOfRehashes and numberOfFloodWarnings are exact.
+ * @param[in] _map - Hash map to examine
+ * @param[in] _numOfSamples - number of buckets to walk, the whole table if bigger than the capacity
+ * @return statistics, all zero for a NULL map
+ */
+Map_Stats HashMapSampleStatistics(const HashMap* _map, size_t _numOfSamples);
 /*
 #endif*/ /* NDEBUG */
 
@@ -0,0 +1,24 @@
+#ifndef __HASH_ITR_INTERNAL_H__
+#define __HASH_ITR_INTERNAL_H__
+
+/**
+ *  @file hash_itr_internal.h
+ *  @brief Layout of a HashMap chain, internal to the library.
+ *
+ *  @details  Lets the HashMapItr functions of hash.h be inlined into the
+ *  caller's loop: a chain is a List of Node, each holding one Elements pair.
+ *  Not part of the API: user code must go through the HashMapItr functions.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "list_node.h"
+
+typedef struct Elements {
+    void* m_value;
+    void* m_key;
+} Elements;
+
+#endif /* __HASH_ITR_INTERNAL_H__ */
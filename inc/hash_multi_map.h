@@ -0,0 +1,104 @@
+#ifndef __HASH_MULTI_MAP_H__
+#define __HASH_MULTI_MAP_H__
+
+/**
+ *  @file hash_multi_map.h
+ *  @brief Generic Hash map that keeps any number of values per key, implemented with separate chaining.
+ *
+ *  @details  The map shares the chaining engine of HashMap. Every distinct key
+ *  is one chained group holding the key and all of its values in one
+ *  contiguous, growing array, so a lookup returns the values as a span with
+ *  no pointer chase per value and a key with a single value costs a single
+ *  allocation. Fits secondary indexes where a few keys own most of the values.
+ *  size of allocated table will be the nearest prime number greater than requested capacity.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include "hash.h"   /*< HashFunction, EqualityFunction >*/
+#include <stddef.h> /*< size_t >*/
+
+typedef struct HashMultiMap HashMultiMap;
+
+/**
+ * @brief Values of one key in insertion order, valid until the next insert or remove of that key
+ */
+typedef struct MultiValues {
+    void* const* m_values;
+    size_t m_count;     /* 0 if the key is not in the map */
+} MultiValues;
+
+/**
+ * @brief Create a new multi map with given capcity and key characteristics.
+ * @param[in] _capacity - Expected max number of distinct keys
+ * 						  shall be rounded to nearest larger prime number.
+ * @param[in] _hashFunc - hashing function for keys
+ * @param[in] _keysEqualFunc - equality check function for keys.
+ * @return newly created map or null on failure
+ */
+HashMultiMap* HashMultiMapCreate(size_t _capacity, HashFunction _hashFunc, EqualityFunction _keysEqualFunc);
+
+/**
+ * @brief destroy the map and set *_map to null
+ * @param[in] _map : map to be destroyed
+ * @param[optional] _keyDestroy : pointer to function to destroy keys, called once per distinct key
+ * @param[optional] _valDestroy : pointer to function to destroy values
+ */
+void HashMultiMapDestroy(HashMultiMap** _map, void (*_keyDestroy)(void* _key), void (*_valDestroy)(void* _value));
+
+/**
+ * @brief Add a value to the values of a key, duplicate values are kept.
+ * @details the key given with the first value of a key is the one stored,
+ *          later inserts of an equal key do not keep their key pointer.
+ * @param[in] _map - map to insert to
+ * @param[in] _key - key to serve as index
+ * @param[in] _value - the value to add
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ALLOCATION_ERROR
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error HashMultiMapInsertMulti(HashMultiMap* _map, const void* _key, const void* _value);
+
+/**
+ * @brief Get all values of a key.
+ * @param[in] _map - map to use
+ * @param[in] _searchKey - key to search for
+ * @return the values of the key, an empty span if the key is not found
+ */
+MultiValues HashMultiMapFindAll(const HashMultiMap* _map, const void* _searchKey);
+
+/**
+ * @brief Get the number of values of a key, 0 if the key is not found
+ */
+size_t HashMultiMapCountKey(const HashMultiMap* _map, const void* _searchKey);
+
+/**
+ * @brief Remove a key with all its values.
+ * @param[in] _map - map to remove from
+ * @param[in] _searchKey - key to search for
+ * @param[out] _pKey - pointer to variable that will get the stored key
+ * @param[optional] _valDestroy - gets every removed value
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error HashMultiMapRemoveAll(HashMultiMap* _map, const void* _searchKey, void** _pKey, void (*_valDestroy)(void* _value));
+
+/**
+ * @brief Get number of values in the map, over all keys
+ */
+size_t HashMultiMapSize(const HashMultiMap* _map);
+
+/**
+ * @brief Get number of distinct keys in the map
+ */
+size_t HashMultiMapKeys(const HashMultiMap* _map);
+
+#endif /* __HASH_MULTI_MAP_H__ */
@@ -0,0 +1,131 @@
+#ifndef __HASH_SET_H__
+#define __HASH_SET_H__
+
+/**
+ *  @file hash_set.h
+ *  @brief Generic Hash set of distinct keys implemented with separate chaining using linked lists.
+ *
+ *  @details  The set shares the chaining engine of HashMap but chains the user
+ *  keys themselves, there is no key-value pair allocated per entry.
+ *  size of allocated table will be the nearest prime number greater than requested capacity.
+ *
+ *  The bulk operations work in place on the destination set and never copy keys,
+ *  a key added by HashSetUnion is shared by both sets.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include "hash.h"   /*< HashFunction, EqualityFunction >*/
+#include <stddef.h> /*< size_t >*/
+
+typedef struct HashSet HashSet;
+
+typedef int (*KeyActionFunction)(const void* _key, void* _context);
+
+/**
+ * @brief Create a new hash set with given capcity and key characteristics.
+ * @param[in] _capacity - Expected max capacity
+ * 						  shall be rounded to nearest larger prime number.
+ * @param[in] _hashFunc - hashing function for keys
+ * @param[in] _keysEqualFunc - equality check function for keys.
+ * @return newly created set or null on failure
+ */
+HashSet* HashSetCreate(size_t _capacity, HashFunction _hashFunc, EqualityFunction _keysEqualFunc);
+
+/**
+ * @brief destroy hash set and set *_set to null
+ * @param[in] _set : set to be destroyed
+ * @param[optional] _keyDestroy : pointer to function to destroy keys
+ */
+void HashSetDestroy(HashSet** _set, void (*_keyDestroy)(void* _key));
+
+/**
+ * @brief Insert a key into the hash set.
+ * @param[in] _set - Hash set to insert to, must be initialized
+ * @param[in] _key - key to insert
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_KEY_EXISTS_ERROR	if key already present in the set
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ALLOCATION_ERROR
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error HashSetInsert(HashSet* _set, const void* _key);
+
+/**
+ * @brief Check if a key is in the set
+ * @param[in] _set - Hash set to use
+ * @param[in] _searchKey - key to search for
+ * @return none zero if the key is in the set, 0 if not or on invalid params
+ */
+int HashSetContains(const HashSet* _set, const void* _searchKey);
+
+/**
+ * @brief Remove a key from the hash set.
+ * @param[in] _set - Hash set to remove key from, must be initialized
+ * @param[in] _searchKey - key to to search for in the set
+ * @param[out] _pKey - pointer to variable that will get the key stored in the set equaling _searchKey
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error HashSetRemove(HashSet* _set, const void* _searchKey, void** _pKey);
+
+/**
+ * @brief Get number of keys in the hash set
+ */
+size_t HashSetSize(const HashSet* _set);
+
+/**
+ * @brief Iterate over all keys in the set and call a function for each key
+ * Iteration will stop if the called function returns a zero for a given key
+ *
+ * @param[in] _set - Hash set to iterate over.
+ * @param[in] _action - User provided function pointer to be invoked for each key
+ * @param[in] _context - User provided context passed to _action
+ * @returns number of times the user functions was invoked
+ */
+size_t HashSetForEach(const HashSet* _set, KeyActionFunction _action, void* _context);
+
+/**
+ * @brief Add to _dest every key of _src it does not contain yet.
+ * @param[in] _dest - set to add keys to
+ * @param[in] _src - set to take keys from, it is not changed
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_ALLOCATION_ERROR, _dest holds the keys added so far
+ * @retval  DS_UNINITIALIZED_ERROR
+ *
+ * @warning both sets must use the same equality function
+ */
+aps_ds_error HashSetUnion(HashSet* _dest, const HashSet* _src);
+
+/**
+ * @brief Remove from _dest every key _src does not contain.
+ * @param[in] _dest - set to remove keys from
+ * @param[in] _src - set to check keys against, it is not changed
+ * @param[optional] _keyDestroy - called for each removed key
+ * @return DS_SUCCESS or DS_UNINITIALIZED_ERROR
+ *
+ * @warning both sets must use the same hashing and equality functions
+ */
+aps_ds_error HashSetIntersection(HashSet* _dest, const HashSet* _src, void (*_keyDestroy)(void* _key));
+
+/**
+ * @brief Remove from _dest every key _src contains.
+ * @details walks the smaller of the two sets.
+ * @param[in] _dest - set to remove keys from
+ * @param[in] _src - set of keys to remove, it is not changed
+ * @param[optional] _keyDestroy - called for each removed key
+ * @return DS_SUCCESS or DS_UNINITIALIZED_ERROR
+ *
+ * @warning both sets must use the same hashing and equality functions
+ */
+aps_ds_error HashSetDifference(HashSet* _dest, const HashSet* _src, void (*_keyDestroy)(void* _key));
+
+#endif /* __HASH_SET_H__ */
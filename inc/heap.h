@@ -3,9 +3,20 @@
 
 /** 
  *  @file heap.h
- *  @brief
+ *  @brief Generic binary heap of pointers ordered by a user compare function.
  *	
- *  @details  
+ *  @details  The items are kept in one array in level order, growing when full.
+ *  Push and pop move a hole along one path of the tree and write every item
+ *  once, with a single compare function call per level of a binary heap.
+ *  A heap may also be created 4 or 8 way, see HeapCreateEx.
+ *
+ *  Items pushed with HeapPushHandle can be found again by their handle, to be
+ *  removed or moved after their priority changed, in O(log n). The heap keeps
+ *  a position index from the first such push on.
+ *
+ *  A bounded heap, see HeapCreateBounded, keeps the best K items offered to
+ *  it in O(K) memory. Its top is the worst item kept, so an offered item that
+ *  cannot make the cut is turned away by a single compare with the top.
  *
  *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
  *  @update Alexei Radashkovsky (alexeirada@gmail.com)
@@ -17,6 +28,9 @@
 
 typedef struct Heap Heap;
 
+/* identifies an item pushed with HeapPushHandle while it is in the heap, a handle may be reused after that */
+typedef size_t HeapHandle;
+
 typedef enum _Heap_Type {
     HEAP_TYPE_ENUM_START,
     HEAP_TYPE_MIN,
@@ -46,6 +60,40 @@ typedef Compare_Result (*HeapDataCompareFunc)(const void*, const void*);
  */
 Heap* HeapCreate(size_t _heapSize, Heap_Type _heapType, HeapDataCompareFunc _comapreFunc);
 
+/**
+ * @brief Create a new heap with given size and number of children per node.
+ * @details a node of a 4 or 8 way heap has all its children on one cache line and
+ * the tree is log4 or log8 of n deep, a pop takes fewer cache misses on big heaps
+ * for up to 3 or 7 compares per level instead of one.
+ * @param[in] _heapSize - Expected max capacity.
+ * @param[in] _heapType - Heap type if store max or min
+ * @param[in] _comapreFunc - compare function for heap data
+ * @param[in] _arity - children per node, 2, 4 or 8. HeapCreate makes a 2 way heap.
+ * @return newly created heap or null on failure
+ */
+Heap* HeapCreateEx(size_t _heapSize, Heap_Type _heapType, HeapDataCompareFunc _comapreFunc, size_t _arity);
+
+/**
+ * @brief Create a heap that keeps at most _k items, offered items compete for a place with the top.
+ * @details the top of a min heap is the smallest item kept, so a bounded min heap keeps the _k
+ * biggest items offered and a bounded max heap the _k smallest. Push fails on a full bounded heap.
+ * @param[in] _k - number of items kept
+ * @param[in] _heapType - Heap type if store max or min
+ * @param[in] _comapreFunc - compare function for heap data
+ * @return newly created heap or null on failure
+ */
+Heap* HeapCreateBounded(size_t _k, Heap_Type _heapType, HeapDataCompareFunc _comapreFunc);
+
+/**
+ * @brief Create a new heap holding a copy of an array of items, built bottom up in O(n).
+ * @param[in] _items - items to put in the heap, none null. The array itself is not kept.
+ * @param[in] _numOfItems - number of items, 0 creates an empty heap
+ * @param[in] _heapType - Heap type if store max or min
+ * @param[in] _comapreFunc - compare function for heap data
+ * @return newly created heap or null on failure or if an item is null
+ */
+Heap* HeapCreateFrom(void* const* _items, size_t _numOfItems, Heap_Type _heapType, HeapDataCompareFunc _comapreFunc);
+
 /**
  * @brief Dynamically deallocate a previously allocated heap
  * @param[in] _heap - Heap to be deallocated.
@@ -63,6 +111,46 @@ void HeapDestroy(Heap** _heap, void (*_elementDestroy)(void* _item));
  */
 aps_ds_error HeapPush(Heap* _heap, void* _data);
 
+/**
+ * @brief insert new data into heap and get a handle to it
+ * @param[in] _heap - Heap.
+ * @param[in] _data - pointer to the data
+ * @param[out] _handle - handle of the data, valid until the data leaves the heap
+ * @return DS_SUCCESS, and other on error
+ */
+aps_ds_error HeapPushHandle(Heap* _heap, void* _data, HeapHandle* _handle);
+
+/**
+ * @brief insert many items into heap, when they are at least as many as the items
+ * already in the heap the whole heap is rebuilt bottom up in linear time
+ * @param[in] _heap - Heap.
+ * @param[in] _items - pointers to the data, none null
+ * @param[in] _numOfItems - number of items
+ * @param[out] _handles - optional, _numOfItems places for the handle of every item as with HeapPushHandle
+ * @return DS_SUCCESS, and other on error, on error no item was inserted
+ */
+aps_ds_error HeapPushBatch(Heap* _heap, void* const* _items, size_t _numOfItems, HeapHandle* _handles);
+
+/**
+ * @brief Offer an item to a bounded heap, a full heap keeps the better of the item and its top
+ * @details an item that belongs above the top is turned away after one compare, any other
+ * item replaces the top in O(log K). On a heap that is not bounded this is a push.
+ * @param[in] _heap - Heap.
+ * @param[in] _data - pointer to the data
+ * @param[out] _pEvicted - the item that did not make it: null if none, the old top, or _data itself
+ * @return DS_SUCCESS, and other on error
+ */
+aps_ds_error HeapOffer(Heap* _heap, void* _data, void** _pEvicted);
+
+/**
+ * @brief Empty the heap into an array, the last item a pop would return comes first
+ * @details for a bounded min heap the array holds the biggest item first
+ * @param[in] _heap - Heap.
+ * @param[out] _items - array of at least HeapSize items
+ * @return DS_SUCCESS, other error on failure
+ */
+aps_ds_error HeapExtractSorted(Heap* _heap, void** _items);
+
 /**
  * @brief Get the top value in heap do not remove the value
  * @param[in] _heap - Heap.
@@ -78,6 +166,32 @@ const void* HeapGetTopValue(const Heap* _heap);
  */
 aps_ds_error HeapPop(Heap* _heap, void** _pValue);
 
+/**
+ * @brief Restore the heap order after the priority of an item changed in any direction
+ * @param[in] _heap - Heap.
+ * @param[in] _handle - handle of the changed item
+ * @return DS_SUCCESS, DS_ELEMENT_NOT_FOUND_ERROR if the handle is not in the heap, other error on failure
+ */
+aps_ds_error HeapUpdate(Heap* _heap, HeapHandle _handle);
+
+/**
+ * @brief Restore the heap order after an item moved toward the top, smaller in a min heap or bigger in a max heap
+ * @details cheaper than HeapUpdate, only the path to the root is looked at
+ * @param[in] _heap - Heap.
+ * @param[in] _handle - handle of the changed item
+ * @return DS_SUCCESS, DS_ELEMENT_NOT_FOUND_ERROR if the handle is not in the heap, other error on failure
+ */
+aps_ds_error HeapDecreaseKey(Heap* _heap, HeapHandle _handle);
+
+/**
+ * @brief Remove an item from anywhere in the heap
+ * @param[in] _heap - Heap.
+ * @param[in] _handle - handle of the item to remove
+ * @param[out]_pValue - pointer where to store the pointer to the value
+ * @return DS_SUCCESS, DS_ELEMENT_NOT_FOUND_ERROR if the handle is not in the heap, other error on failure
+ */
+aps_ds_error HeapRemove(Heap* _heap, HeapHandle _handle, void** _pValue);
+
 /**
  * @brief Get the number of elements that inserted into heap
  * @param[in] _heap - Heap.
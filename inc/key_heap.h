@@ -0,0 +1,82 @@
+#ifndef __KEY_HEAP_H__
+#define __KEY_HEAP_H__
+
+/**
+ *  @file key_heap.h
+ *  @brief Heap of (uint64_t priority, pointer) pairs compared without a callback.
+ *
+ *  @details  The priority is stored inline next to the payload pointer, so the
+ *  heap never reads the user objects and never calls a compare function:
+ *  two priorities are compared as integers. The pairs are kept in one array
+ *  in level order, 4 children per node, and the array is aligned so that the
+ *  4 children of a node fill exactly one 64 byte cache line. A max heap stores
+ *  the complement of every priority and shares the min heap code.
+ *
+ *  Use it instead of Heap when the priority is a number, Heap remains the
+ *  choice for orders only a compare function can tell.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include "heap.h"
+#include <stddef.h> /*< size_t >*/
+#include <stdint.h> /*< uint64_t >*/
+#include <unistd.h> /*< ssize_t >*/
+
+typedef struct KeyHeap KeyHeap;
+
+/**
+ * @brief Create a new heap with given size.
+ * @param[in] _heapSize - Expected max capacity, the heap grows past it when needed.
+ * @param[in] _heapType - HEAP_TYPE_MIN pops the smallest priority first, HEAP_TYPE_MAX the biggest
+ * @return newly created heap or null on failure
+ */
+KeyHeap* KeyHeapCreate(size_t _heapSize, Heap_Type _heapType);
+
+/**
+ * @brief Dynamically deallocate a previously allocated heap
+ * @param[in] _heap - Heap to be deallocated.
+ * @param[in] _elementDestroy : A function pointer to be used to destroy all payloads in the heap
+ *             or a null if no such destroy is required
+ * @return void
+ */
+void KeyHeapDestroy(KeyHeap** _heap, void (*_elementDestroy)(void* _item));
+
+/**
+ * @brief insert a payload with its priority
+ * @param[in] _heap - Heap.
+ * @param[in] _priority - priority of the payload
+ * @param[in] _data - payload, may be null, the heap never looks at it
+ * @return DS_SUCCESS, and other on error
+ */
+aps_ds_error KeyHeapPush(KeyHeap* _heap, uint64_t _priority, void* _data);
+
+/**
+ * @brief Remove the pair from the top
+ * @param[in] _heap - Heap.
+ * @param[out] _pPriority - where to store the priority, may be null
+ * @param[out] _pValue - where to store the payload
+ * @return DS_SUCCESS, DS_OUT_OF_BOUNDS_ERROR if empty, other error on failure
+ */
+aps_ds_error KeyHeapPop(KeyHeap* _heap, uint64_t* _pPriority, void** _pValue);
+
+/**
+ * @brief Get the pair at the top without removing it
+ * @param[in] _heap - Heap.
+ * @param[out] _pPriority - where to store the priority, may be null
+ * @param[out] _pValue - where to store the payload
+ * @return DS_SUCCESS, DS_OUT_OF_BOUNDS_ERROR if empty, other error on failure
+ */
+aps_ds_error KeyHeapTop(const KeyHeap* _heap, uint64_t* _pPriority, void** _pValue);
+
+/**
+ * @brief Get the number of pairs in the heap
+ * @param[in] _heap - Heap.
+ * @return the size, -1 on failure
+ */
+ssize_t KeyHeapSize(const KeyHeap* _heap);
+
+#endif /* __KEY_HEAP_H__ */
@@ -0,0 +1,24 @@
+#ifndef __LIST_NODE_H__
+#define __LIST_NODE_H__
+
+/**
+ *  @file list_node.h
+ *  @brief Node of the doubly linked List, internal to the library.
+ *
+ *  @details  Shared by the List implementation and the inline HashMapItr
+ *  functions of hash.h, which walk the hash chains directly. Not part of the
+ *  API: user code must not touch a Node.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+typedef struct Node {
+    void* m_item;       /* pointer to items */
+    struct Node* m_next;/* Pointer to the next node */
+    struct Node* m_prev;/* Pointer to the previous node */
+
+} Node;
+
+#endif /* __LIST_NODE_H__ */
@@ -0,0 +1,124 @@
+#ifndef __LRU_CACHE_H__
+#define __LRU_CACHE_H__
+
+/**
+ *  @file lru_cache.h
+ *  @brief Generic least recently used cache of key-value pairs.
+ *
+ *  @details  Pairs are indexed by a HashMap and threaded on an intrusive
+ *  recency list: every entry carries its own list links, so a hit only relinks
+ *  the entry at the front of the list and never allocates or frees memory.
+ *  When a put makes the cache exceed its entry count or its total weight, the
+ *  least recently used pairs are evicted and handed to the evict function.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include "hash.h"   /*< HashFunction, EqualityFunction >*/
+#include <stddef.h> /*< size_t >*/
+
+typedef struct LRUCache LRUCache;
+
+/**
+ * @brief Weight of a pair, e.g. its size in bytes
+ */
+typedef size_t (*LRUWeightFunction)(const void* _key, const void* _value);
+
+/**
+ * @brief Called for every pair that leaves the cache without being removed by the user
+ * @details for a pair replaced by LRUCachePut a key or value that the new pair
+ *          reuses is passed as NULL, it is still in use by the cache
+ */
+typedef void (*LRUEvictFunction)(void* _key, void* _value, void* _context);
+
+typedef struct LRU_Stats {
+    size_t hits;      /* LRUCacheGet calls that found the key */
+    size_t misses;    /* LRUCacheGet calls that did not */
+    size_t evictions; /* pairs evicted to make room */
+    size_t size;      /* pairs in the cache */
+    size_t weight;    /* total weight of the pairs in the cache */
+} LRU_Stats;
+
+/**
+ * @brief Create an empty cache.
+ * @param[in] _maxEntries - max number of pairs, 0 for no limit on the count
+ * @param[in] _maxWeight - max total weight of the pairs, 0 for no limit on the weight
+ * @param[in] _hashFunc - hashing function for keys
+ * @param[in] _keysEqualFunc - equality check function for keys.
+ * @param[optional] _weightFunc - weight of a pair, NULL weighs every pair 1
+ * @param[optional] _evictFunc - gets every evicted or replaced pair, and every pair left on destroy
+ * @param[optional] _context - passed to _evictFunc
+ * @return newly created cache or null on failure or if both limits are 0
+ */
+LRUCache* LRUCacheCreate(size_t _maxEntries, size_t _maxWeight, HashFunction _hashFunc, EqualityFunction _keysEqualFunc,
+                         LRUWeightFunction _weightFunc, LRUEvictFunction _evictFunc, void* _context);
+
+/**
+ * @brief destroy the cache, hand every pair still in it to the evict function and set *_cache to null
+ * @param[in] _cache : cache to be destroyed
+ */
+void LRUCacheDestroy(LRUCache** _cache);
+
+/**
+ * @brief Find a value by key and mark the pair as the most recently used.
+ * @param[in] _cache - cache to use
+ * @param[in] _searchKey - key to search for
+ * @param[out] _pValue - pointer to variable that will get the value
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error LRUCacheGet(LRUCache* _cache, const void* _searchKey, void** _pValue);
+
+/**
+ * @brief Find a value by key without changing its recency or the hit and miss counters.
+ * @return same as LRUCacheGet
+ */
+aps_ds_error LRUCachePeek(const LRUCache* _cache, const void* _searchKey, void** _pValue);
+
+/**
+ * @brief Insert or replace a pair as the most recently used one and evict pairs until the limits hold.
+ * @details a replaced pair is handed to the evict function once the new pair is in place,
+ *          its key or value is passed as NULL if the new pair reuses the same pointer.
+ * @param[in] _cache - cache to insert to
+ * @param[in] _key - key to serve as index
+ * @param[in] _value - the value to associate with the key
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_OVERFLOW_ERROR if the pair alone weighs more than the weight limit
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ALLOCATION_ERROR
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error LRUCachePut(LRUCache* _cache, const void* _key, const void* _value);
+
+/**
+ * @brief Remove a pair, the evict function is not called.
+ * @param[in] _cache - cache to remove from
+ * @param[in] _searchKey - key to search for
+ * @param[out] _pKey - pointer to variable that will get the stored key
+ * @param[out] _pValue - pointer to variable that will get the stored value
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error LRUCacheRemove(LRUCache* _cache, const void* _searchKey, void** _pKey, void** _pValue);
+
+/**
+ * @brief Get number of pairs in the cache
+ */
+size_t LRUCacheSize(const LRUCache* _cache);
+
+/**
+ * @brief Get the hit, miss and eviction counters and the current size and weight
+ */
+LRU_Stats LRUCacheGetStatistics(const LRUCache* _cache);
+
+#endif /* __LRU_CACHE_H__ */
@@ -0,0 +1,89 @@
+#ifndef __MIN_MAX_HEAP_H__
+#define __MIN_MAX_HEAP_H__
+
+/**
+ *  @file min_max_heap.h
+ *  @brief Double ended heap of pointers, both the smallest and the biggest item are at hand.
+ *
+ *  @details  The items are kept in one array laid out as a binary tree whose
+ *  levels alternate: an item on an even level, the root's level, is not bigger
+ *  than anything below it and an item on an odd level is not smaller. The
+ *  smallest item is the root and the biggest is one of its two children, so
+ *  both are read in O(1). Push and both pops move an item along one path
+ *  comparing it with grandparents or grandchildren, O(log n).
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include "heap.h"
+#include <stddef.h> /*< size_t >*/
+#include <unistd.h> /*< ssize_t >*/
+
+typedef struct MinMaxHeap MinMaxHeap;
+
+/**
+ * @brief Create a new heap with given size.
+ * @param[in] _heapSize - Expected max capacity, the heap grows past it when needed.
+ * @param[in] _comapreFunc - compare function for heap data
+ * @return newly created heap or null on failure
+ */
+MinMaxHeap* MinMaxHeapCreate(size_t _heapSize, HeapDataCompareFunc _comapreFunc);
+
+/**
+ * @brief Dynamically deallocate a previously allocated heap
+ * @param[in] _heap - Heap to be deallocated.
+ * @param[in] _elementDestroy : A function pointer to be used to destroy all elements in the heap
+ *             or a null if no such destroy is required
+ * @return void
+ */
+void MinMaxHeapDestroy(MinMaxHeap** _heap, void (*_elementDestroy)(void* _item));
+
+/**
+ * @brief insert new data into heap
+ * @param[in] _heap - Heap.
+ * @param[in] _data - pointer to the data
+ * @return DS_SUCCESS, and other on error
+ */
+aps_ds_error MinMaxHeapPush(MinMaxHeap* _heap, void* _data);
+
+/**
+ * @brief Get the smallest value in heap do not remove the value
+ * @param[in] _heap - Heap.
+ * @return the address to the value on success, NULL on failure
+ */
+const void* MinMaxHeapGetMin(const MinMaxHeap* _heap);
+
+/**
+ * @brief Get the biggest value in heap do not remove the value
+ * @param[in] _heap - Heap.
+ * @return the address to the value on success, NULL on failure
+ */
+const void* MinMaxHeapGetMax(const MinMaxHeap* _heap);
+
+/**
+ * @brief Remove the smallest element
+ * @param[in] _heap - Heap.
+ * @param[out]_pValue - pointer where to store the pointer to the value
+ * @return DS_SUCCESS, DS_OUT_OF_BOUNDS_ERROR if empty, other error on failure
+ */
+aps_ds_error MinMaxHeapPopMin(MinMaxHeap* _heap, void** _pValue);
+
+/**
+ * @brief Remove the biggest element
+ * @param[in] _heap - Heap.
+ * @param[out]_pValue - pointer where to store the pointer to the value
+ * @return DS_SUCCESS, DS_OUT_OF_BOUNDS_ERROR if empty, other error on failure
+ */
+aps_ds_error MinMaxHeapPopMax(MinMaxHeap* _heap, void** _pValue);
+
+/**
+ * @brief Get the number of elements that inserted into heap
+ * @param[in] _heap - Heap.
+ * @return the size, -1 on failure
+ */
+ssize_t MinMaxHeapSize(const MinMaxHeap* _heap);
+
+#endif /* __MIN_MAX_HEAP_H__ */
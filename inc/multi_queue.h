@@ -0,0 +1,83 @@
+#ifndef __MULTI_QUEUE_H__
+#define __MULTI_QUEUE_H__
+
+/**
+ *  @file multi_queue.h
+ *  @brief Relaxed concurrent priority queue of (uint64_t priority, pointer) pairs.
+ *
+ *  @details  The queue is a set of lanes, each a KeyHeap behind its own mutex.
+ *  A push locks one random lane. A pop looks at the tops of two random lanes
+ *  without locking, then locks and pops the better one. Threads rarely meet on
+ *  a lane, so no single lock serializes them, in exchange a pop returns one of
+ *  the best few items and not always the very best. Give it two to four lanes
+ *  per thread.
+ *
+ *  A pop of an empty looking lane pair falls back to searching every lane, so
+ *  a pop only fails when the whole queue is empty.
+ *
+ *  There is no lock-free skiplist variant. The epoch reclamation of rcu_hash.c
+ *  retires nodes from one writer at a time, under the map's write mutex, while
+ *  a skiplist popped by every thread would have to retire nodes concurrently.
+ *  That code would need to become a shared multi-writer component first.
+ *
+ *  src/multi_queue_bench.c measures push and pop pairs per second against one
+ *  Heap behind a mutex, from 1 to 64 threads. It has only been run on a single
+ *  core so far, where the threads take turns and no contention can show, so
+ *  there are no multi-core throughput numbers yet.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include "heap.h"
+#include <stddef.h> /*< size_t >*/
+#include <stdint.h> /*< uint64_t >*/
+#include <unistd.h> /*< ssize_t >*/
+
+typedef struct MultiQueue MultiQueue;
+
+/**
+ * @brief Create an empty queue.
+ * @param[in] _numOfLanes - number of locked heaps, 2 to 4 per thread using the queue
+ * @param[in] _laneSize - expected number of items per lane, lanes grow past it when needed
+ * @param[in] _heapType - HEAP_TYPE_MIN pops small priorities first, HEAP_TYPE_MAX big ones
+ * @return newly created queue or null on failure
+ */
+MultiQueue* MultiQueueCreate(size_t _numOfLanes, size_t _laneSize, Heap_Type _heapType);
+
+/**
+ * @brief Destroy the queue and set *_queue to null, no thread may be using it
+ * @param[in] _queue - queue to be destroyed
+ * @param[in] _elementDestroy : A function pointer to be used to destroy all payloads in the queue
+ *             or a null if no such destroy is required
+ */
+void MultiQueueDestroy(MultiQueue** _queue, void (*_elementDestroy)(void* _item));
+
+/**
+ * @brief insert a payload with its priority, thread safe
+ * @param[in] _queue - queue.
+ * @param[in] _priority - priority of the payload
+ * @param[in] _data - payload, may be null
+ * @return DS_SUCCESS, and other on error
+ */
+aps_ds_error MultiQueuePush(MultiQueue* _queue, uint64_t _priority, void* _data);
+
+/**
+ * @brief Remove one of the best pairs, thread safe
+ * @param[in] _queue - queue.
+ * @param[out] _pPriority - where to store the priority, may be null
+ * @param[out] _pValue - where to store the payload
+ * @return DS_SUCCESS, DS_OUT_OF_BOUNDS_ERROR if every lane was empty, other error on failure
+ */
+aps_ds_error MultiQueuePop(MultiQueue* _queue, uint64_t* _pPriority, void** _pValue);
+
+/**
+ * @brief Get the number of pairs in the queue, a snapshot while other threads change it
+ * @param[in] _queue - queue.
+ * @return the size, -1 on failure
+ */
+ssize_t MultiQueueSize(const MultiQueue* _queue);
+
+#endif /* __MULTI_QUEUE_H__ */
@@ -0,0 +1,98 @@
+#ifndef __PAIRING_HEAP_H__
+#define __PAIRING_HEAP_H__
+
+/**
+ *  @file pairing_heap.h
+ *  @brief Meldable heap of pointers, a pairing heap with O(1) push and meld.
+ *
+ *  @details  Every item sits in a tree node, a node keeps its children in a
+ *  list. Push and meld link two trees under the better root with one compare.
+ *  Pop links the children of the root in pairs from the left and then merges
+ *  the pairs from the right, amortized O(log n). Moving an item toward the top
+ *  cuts its subtree off and links it to the root.
+ *
+ *  Nodes come from pools of nodes allocated in growing chunks, a popped node
+ *  is reused by the next push. A meld hands the pools of one heap to the other
+ *  so nodes never change hands one at a time.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include "heap.h"
+#include <stddef.h> /*< size_t >*/
+#include <unistd.h> /*< ssize_t >*/
+
+typedef struct PairingHeap PairingHeap;
+
+/* node of a pushed item, valid while the item is in the heap, also after a meld */
+typedef struct PairingNode PairingNode;
+
+/**
+ * @brief Create an empty heap.
+ * @param[in] _poolSize - number of nodes allocated up front, later chunks double in size
+ * @param[in] _heapType - Heap type if store max or min
+ * @param[in] _comapreFunc - compare function for heap data
+ * @return newly created heap or null on failure
+ */
+PairingHeap* PairingHeapCreate(size_t _poolSize, Heap_Type _heapType, HeapDataCompareFunc _comapreFunc);
+
+/**
+ * @brief Dynamically deallocate a previously allocated heap
+ * @param[in] _heap - Heap to be deallocated.
+ * @param[in] _elementDestroy : A function pointer to be used to destroy all elements in the heap
+ *             or a null if no such destroy is required
+ * @return void
+ */
+void PairingHeapDestroy(PairingHeap** _heap, void (*_elementDestroy)(void* _item));
+
+/**
+ * @brief insert new data into heap in O(1)
+ * @param[in] _heap - Heap.
+ * @param[in] _data - pointer to the data
+ * @param[out] _pNode - where to store the node of the data, may be null
+ * @return DS_SUCCESS, and other on error
+ */
+aps_ds_error PairingHeapPush(PairingHeap* _heap, void* _data, PairingNode** _pNode);
+
+/**
+ * @brief Get the top value in heap do not remove the value
+ * @param[in] _heap - Heap.
+ * @return the address to the value on success, NULL on failure
+ */
+const void* PairingHeapGetTopValue(const PairingHeap* _heap);
+
+/**
+ * @brief Remove element from the top, amortized O(log n)
+ * @param[in] _heap - Heap.
+ * @param[out]_pValue - pointer where to store the pointer to the value
+ * @return DS_SUCCESS, DS_OUT_OF_BOUNDS_ERROR if empty, other error on failure
+ */
+aps_ds_error PairingHeapPop(PairingHeap* _heap, void** _pValue);
+
+/**
+ * @brief Restore the heap order after an item moved toward the top, smaller in a min heap or bigger in a max heap
+ * @param[in] _heap - Heap holding the node.
+ * @param[in] _node - node of the changed item
+ * @return DS_SUCCESS, other error on failure
+ */
+aps_ds_error PairingHeapDecreaseKey(PairingHeap* _heap, PairingNode* _node);
+
+/**
+ * @brief Move all items of _source into _dest in O(1), _source is left empty and may be reused
+ * @param[in] _dest - Heap receiving the items.
+ * @param[in] _source - Heap of the same type and compare function.
+ * @return DS_SUCCESS, DS_INVALID_PARAM_ERROR if the heaps do not order the same way, other error on failure
+ */
+aps_ds_error PairingHeapMeld(PairingHeap* _dest, PairingHeap* _source);
+
+/**
+ * @brief Get the number of elements that inserted into heap
+ * @param[in] _heap - Heap.
+ * @return the size, -1 on failure
+ */
+ssize_t PairingHeapSize(const PairingHeap* _heap);
+
+#endif /* __PAIRING_HEAP_H__ */
@@ -0,0 +1,70 @@
+#ifndef __RADIX_HEAP_H__
+#define __RADIX_HEAP_H__
+
+/**
+ *  @file radix_heap.h
+ *  @brief Min heap of (uint64_t key, pointer) pairs for keys that never go below the last popped key.
+ *
+ *  @details  A pair is put in the bucket of the highest bit in which its key
+ *  differs from the last popped key, bucket 0 holding keys equal to it. Push
+ *  is O(1) and compares no keys. A pop from an empty bucket 0 takes the lowest
+ *  bucket that is not empty, makes its smallest key the new last key and
+ *  spreads the bucket over the buckets below it. A pair only ever moves to a
+ *  lower bucket, so a pop is amortized O(log C) for keys spanning C values.
+ *
+ *  Suits event simulations and shortest path searches, where every new key is
+ *  at least the key just popped. A key below the last popped one is refused.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include <stddef.h> /*< size_t >*/
+#include <stdint.h> /*< uint64_t >*/
+#include <unistd.h> /*< ssize_t >*/
+
+typedef struct RadixHeap RadixHeap;
+
+/**
+ * @brief Create an empty heap, the last popped key starts at 0.
+ * @return newly created heap or null on failure
+ */
+RadixHeap* RadixHeapCreate(void);
+
+/**
+ * @brief Dynamically deallocate a previously allocated heap
+ * @param[in] _heap - Heap to be deallocated.
+ * @param[in] _elementDestroy : A function pointer to be used to destroy all payloads in the heap
+ *             or a null if no such destroy is required
+ * @return void
+ */
+void RadixHeapDestroy(RadixHeap** _heap, void (*_elementDestroy)(void* _item));
+
+/**
+ * @brief insert a payload with its key
+ * @param[in] _heap - Heap.
+ * @param[in] _key - key of the payload, at least the last popped key
+ * @param[in] _data - payload, may be null
+ * @return DS_SUCCESS, DS_INVALID_PARAM_ERROR if _key is below the last popped key, other error on failure
+ */
+aps_ds_error RadixHeapPush(RadixHeap* _heap, uint64_t _key, void* _data);
+
+/**
+ * @brief Remove a pair of the smallest key
+ * @param[in] _heap - Heap.
+ * @param[out] _pKey - where to store the key, may be null
+ * @param[out] _pValue - where to store the payload
+ * @return DS_SUCCESS, DS_OUT_OF_BOUNDS_ERROR if empty, other error on failure
+ */
+aps_ds_error RadixHeapPop(RadixHeap* _heap, uint64_t* _pKey, void** _pValue);
+
+/**
+ * @brief Get the number of pairs in the heap
+ * @param[in] _heap - Heap.
+ * @return the size, -1 on failure
+ */
+ssize_t RadixHeapSize(const RadixHeap* _heap);
+
+#endif /* __RADIX_HEAP_H__ */
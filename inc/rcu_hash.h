@@ -0,0 +1,143 @@
+#ifndef __RCU_HASH_H__
+#define __RCU_HASH_H__
+
+/**
+ *  @file rcu_hash.h
+ *  @brief Read-mostly hash map with a lock-free lookup path.
+ *
+ *  @details  Buckets are singly linked chains of immutable nodes hanging off an
+ *  atomically published table. Readers never take a lock: they announce the
+ *  current epoch in a private, cache line sized reader slot, walk the chain and
+ *  clear the slot again. Writers serialize on one mutex, publish new nodes with
+ *  a release store and retire unlinked nodes (and old tables after a rehash)
+ *  to a limbo list that is reclaimed once no reader slot still holds an older epoch.
+ *
+ *  Every reading thread attaches its own RCUReader once and passes it to
+ *  RCUHashMapFind. Removed keys and values are destroyed by the destroy
+ *  functions given on creation, only after all readers that could see them left.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include "hash.h"   /*< HashFunction, EqualityFunction >*/
+#include <stddef.h> /*< size_t >*/
+
+typedef struct RCUHashMap RCUHashMap;
+typedef struct RCUReader RCUReader;
+
+/**
+ * @brief Create a new read-mostly hash map.
+ * @param[in] _capacity - Expected max capacity, rounded to nearest larger prime number.
+ * @param[in] _maxReaders - Max number of reader handles attached at the same time.
+ * @param[in] _hashFunc - hashing function for keys
+ * @param[in] _keysEqualFunc - equality check function for keys.
+ * @param[optional] _keyDestroy - called for a removed key once it is safe to free it
+ * @param[optional] _valDestroy - called for a removed value once it is safe to free it
+ * @return newly created map or null on failure
+ */
+RCUHashMap* RCUHashMapCreate(size_t _capacity, size_t _maxReaders, HashFunction _hashFunc, EqualityFunction _keysEqualFunc,
+                             ElementDestroy _keyDestroy, ElementDestroy _valDestroy);
+
+/**
+ * @brief destroy the map, all pairs still in it and set *_map to null
+ * @param[in] _map : map to be destroyed
+ * @warning no reader may be inside RCUHashMapFind while the map is destroyed
+ */
+void RCUHashMapDestroy(RCUHashMap** _map);
+
+/**
+ * @brief Attach a reader handle for the calling thread.
+ * @param[in] _map - map to read from
+ * @return reader handle or NULL if all _maxReaders slots are taken
+ * @warning a handle must be used by one thread at a time
+ */
+RCUReader* RCUHashMapReaderAttach(RCUHashMap* _map);
+
+/**
+ * @brief Release a reader handle and set *_reader to null
+ * @param[in] _reader - handle returned by RCUHashMapReaderAttach
+ */
+void RCUHashMapReaderDetach(RCUReader** _reader);
+
+/**
+ * @brief Enter a read-side critical section.
+ * @details Values returned by RCUHashMapFind stay valid until the matching
+ *          RCUHashMapReadEnd. Sections may nest.
+ * @param[in] _reader - reader handle
+ */
+void RCUHashMapReadBegin(RCUReader* _reader);
+
+/**
+ * @brief Leave a read-side critical section.
+ * @param[in] _reader - reader handle
+ */
+void RCUHashMapReadEnd(RCUReader* _reader);
+
+/**
+ * @brief Find a value by key without taking any lock.
+ * @param[in] _reader - reader handle of the calling thread
+ * @param[in] _searchKey - key to serve as index for search
+ * @param[out] _pValue - pointer to variable that will get the value assoiciated with the search key.
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ *
+ * @warning outside RCUHashMapReadBegin/End the value may be destroyed by a
+ *          concurrent remove as soon as the function returns.
+ */
+aps_ds_error RCUHashMapFind(RCUReader* _reader, const void* _searchKey, void** _pValue);
+
+/**
+ * @brief Insert a key-value pair, serialized against other writers.
+ * @param[in] _map - map to insert to
+ * @param[in] _key - key to serve as index
+ * @param[in] _value - the value to associate with the key
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_KEY_EXISTS_ERROR	if key already present in the map
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ALLOCATION_ERROR
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error RCUHashMapInsert(RCUHashMap* _map, const void* _key, const void* _value);
+
+/**
+ * @brief Remove a key-value pair, serialized against other writers.
+ * @details the pair is handed to the destroy functions once no reader can reach it.
+ * @param[in] _map - map to remove pair from
+ * @param[in] _searchKey - key to to search for in the map
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error RCUHashMapRemove(RCUHashMap* _map, const void* _searchKey);
+
+/**
+ * @brief Publish a new table with the given capacity and retire the old one.
+ * @param[in] _map - existing map
+ * @param[in] _newCapacity - new capacity shall be rounded to nearest larger prime number.
+ * @return DS_SUCCESS or DS_ALLOCATION_ERROR
+ */
+aps_ds_error RCUHashMapRehash(RCUHashMap* _map, size_t _newCapacity);
+
+/**
+ * @brief Wait until every reader that was inside a critical section has left
+ *        and reclaim everything retired so far.
+ * @param[in] _map - existing map
+ * @warning must not be called from inside a read-side critical section
+ */
+void RCUHashMapSynchronize(RCUHashMap* _map);
+
+/**
+ * @brief Get number of key-value pairs inserted into the map
+ */
+size_t RCUHashMapSize(const RCUHashMap* _map);
+
+#endif /* __RCU_HASH_H__ */
@@ -0,0 +1,110 @@
+#ifndef __STR_MAP_H__
+#define __STR_MAP_H__
+
+/**
+ *  @file str_map.h
+ *  @brief Hash map of string keys to generic values implemented with open addressing.
+ *
+ *  @details  Keys are copied into the map: keys up to STR_MAP_INLINE_KEY bytes
+ *  are stored inside their slot, longer keys in an internal arena that is
+ *  released with the map. Once removed keys take more of the arena than the
+ *  keys still in the map, the live keys are copied into a fresh arena. Every
+ *  slot keeps the key length and hash, so a probe compares the hash and the
+ *  length first and runs memcmp only on a likely match, and looking up a short
+ *  key never reads memory outside the table.
+ *  Keys are byte strings of a given length, they may hold any byte and need no
+ *  terminating NUL.
+ *
+ *  Collisions are resolved by linear probing, the table is a power of two and
+ *  doubles when it is three quarters full.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include <stddef.h> /*< size_t >*/
+
+#define STR_MAP_INLINE_KEY (20)
+
+typedef struct StrMap StrMap;
+
+typedef int (*StrActionFunction)(const char* _key, size_t _keyLength, void* _value, void* _context);
+
+/**
+ * @brief Create a new map.
+ * @param[in] _capacity - Expected number of pairs, the table is sized so they fit without growing.
+ * @return newly created map or null on failure
+ */
+StrMap* StrMapCreate(size_t _capacity);
+
+/**
+ * @brief destroy the map with all its key copies and set *_map to null
+ * @param[in] _map : map to be destroyed
+ * @param[optional] _valDestroy : pointer to function to destroy values
+ */
+void StrMapDestroy(StrMap** _map, void (*_valDestroy)(void* _value));
+
+/**
+ * @brief Copy a key into the map and associate it with a value.
+ * @param[in] _map - map to insert to
+ * @param[in] _key - key bytes, copied
+ * @param[in] _keyLength - number of bytes in _key
+ * @param[in] _value - the value to associate with the key
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_KEY_EXISTS_ERROR	if key already present in the map
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ALLOCATION_ERROR
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error StrMapInsert(StrMap* _map, const char* _key, size_t _keyLength, const void* _value);
+
+/**
+ * @brief Remove a key-value pair from the map.
+ * @details the arena space of removed long keys is reclaimed by compacting the arena
+ *          when it outweighs the live keys and the table, which may move the map's key copies.
+ * @param[in] _map - map to remove pair from
+ * @param[in] _key - key bytes to search for
+ * @param[in] _keyLength - number of bytes in _key
+ * @param[out] _pValue - optional, gets the value of the removed pair
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error StrMapRemove(StrMap* _map, const char* _key, size_t _keyLength, void** _pValue);
+
+/**
+ * @brief Find a value by key
+ * @param[in] _map - map to use
+ * @param[in] _key - key bytes to search for
+ * @param[in] _keyLength - number of bytes in _key
+ * @param[out] _pValue - gets the value assoiciated with the key
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error StrMapFind(const StrMap* _map, const char* _key, size_t _keyLength, void** _pValue);
+
+/**
+ * @brief Get number of key-value pairs in the map
+ */
+size_t StrMapSize(const StrMap* _map);
+
+/**
+ * @brief Iterate over all key-value pairs in the map and call a function for each pair
+ * Iteration will stop if the called function returns a zero for a given pair
+ *
+ * @param[in] _map - map to iterate over, must not be changed during the iteration
+ * @param[in] _action - gets the map's copy of each key, valid until the map changes
+ * @param[in] _context - User provided context passed to _action
+ * @returns number of times the user functions was invoked
+ */
+size_t StrMapForEach(const StrMap* _map, StrActionFunction _action, void* _context);
+
+#endif /* __STR_MAP_H__ */
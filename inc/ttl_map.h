@@ -0,0 +1,118 @@
+#ifndef __TTL_MAP_H__
+#define __TTL_MAP_H__
+
+/**
+ *  @file ttl_map.h
+ *  @brief Generic hash map whose pairs expire after a per pair time to live.
+ *
+ *  @details  Lookups go through a HashMap, expiry through a hierarchical timing
+ *  wheel of four levels of 64 slots. Every pair is linked into the slot of its
+ *  expiry time at the coarsest level that can still tell it apart, and moves
+ *  one level down each time that slot comes due, so inserting, removing and
+ *  expiring a pair are amortized O(1) and no pass over all pairs is ever made.
+ *
+ *  Time is an integer tick count owned by the caller: nothing expires on its
+ *  own, TTLMapTick(now) advances the wheel and hands every pair whose expiry
+ *  time is <= now to the expire function. Tests can drive time deterministically.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include "hash.h"   /*< HashFunction, EqualityFunction >*/
+#include <stddef.h> /*< size_t >*/
+#include <stdint.h> /*< uint64_t >*/
+
+typedef struct TTLMap TTLMap;
+
+/**
+ * @brief Called for every pair that expires
+ */
+typedef void (*TTLExpireFunction)(void* _key, void* _value, void* _context);
+
+/**
+ * @brief Create an empty map.
+ * @param[in] _capacity - Expected max capacity, rounded to nearest larger prime number.
+ * @param[in] _now - current time in ticks
+ * @param[in] _hashFunc - hashing function for keys
+ * @param[in] _keysEqualFunc - equality check function for keys.
+ * @param[optional] _expireFunc - gets every expired pair
+ * @param[optional] _context - passed to _expireFunc
+ * @param[in] _lazyExpiry - none zero to expire a pair found out of date by TTLMapFind right away
+ *                          instead of on the next TTLMapTick
+ * @return newly created map or null on failure
+ */
+TTLMap* TTLMapCreate(size_t _capacity, uint64_t _now, HashFunction _hashFunc, EqualityFunction _keysEqualFunc,
+                     TTLExpireFunction _expireFunc, void* _context, int _lazyExpiry);
+
+/**
+ * @brief destroy the map and set *_map to null, the expire function is not called
+ * @param[in] _map : map to be destroyed
+ * @param[optional] _keyDestroy : pointer to function to destroy keys
+ * @param[optional] _valDestroy : pointer to function to destroy values
+ */
+void TTLMapDestroy(TTLMap** _map, void (*_keyDestroy)(void* _key), void (*_valDestroy)(void* _value));
+
+/**
+ * @brief Insert a pair that expires _ttl ticks after the time of the last TTLMapTick
+ * @param[in] _map - map to insert to
+ * @param[in] _key - key to serve as index
+ * @param[in] _value - the value to associate with the key
+ * @param[in] _ttl - time to live in ticks, 0 expires on the next tick
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_KEY_EXISTS_ERROR	if key already present in the map
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ALLOCATION_ERROR
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error TTLMapInsert(TTLMap* _map, const void* _key, const void* _value, uint64_t _ttl);
+
+/**
+ * @brief Find a value by key, a pair whose expiry time is <= _now is not found.
+ * @details with lazy expiry such a pair is also expired before the call returns,
+ *          otherwise it stays until the TTLMapTick that reaches it.
+ * @param[in] _map - map to use
+ * @param[in] _searchKey - key to search for
+ * @param[in] _now - current time in ticks
+ * @param[out] _pValue - pointer to variable that will get the value
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found or expired
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error TTLMapFind(TTLMap* _map, const void* _searchKey, uint64_t _now, void** _pValue);
+
+/**
+ * @brief Remove a pair before it expires, the expire function is not called.
+ * @param[in] _map - map to remove from
+ * @param[in] _searchKey - key to search for
+ * @param[out] _pKey - pointer to variable that will get the stored key
+ * @param[out] _pValue - pointer to variable that will get the stored value
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_INVALID_PARAM_ERROR
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error TTLMapRemove(TTLMap* _map, const void* _searchKey, void** _pKey, void** _pValue);
+
+/**
+ * @brief Advance the time to _now and expire every pair whose expiry time is <= _now.
+ * @details cost is one slot step per elapsed tick plus the expired and cascaded pairs,
+ *          an empty map jumps to _now at once. A _now earlier than the current time is ignored.
+ * @param[in] _map - map to advance
+ * @param[in] _now - current time in ticks
+ * @return number of expired pairs
+ */
+size_t TTLMapTick(TTLMap* _map, uint64_t _now);
+
+/**
+ * @brief Get number of pairs in the map, expired pairs not yet reached by a tick included
+ */
+size_t TTLMapSize(const TTLMap* _map);
+
+#endif /* __TTL_MAP_H__ */
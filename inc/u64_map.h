@@ -0,0 +1,94 @@
+#ifndef __U64_MAP_H__
+#define __U64_MAP_H__
+
+/**
+ *  @file u64_map.h
+ *  @brief Hash map of uint64_t keys to uint64_t values implemented with open addressing.
+ *
+ *  @details  Keys and values are stored inline in one flat slot array, there is
+ *  no allocation per pair and no user hash or equality function: keys are
+ *  spread by a built-in integer mixer and compared directly. Collisions are
+ *  resolved by linear probing, removal shifts the following slots back instead
+ *  of leaving tombstones. The table is a power of two and doubles when it is
+ *  three quarters full.
+ *
+ *  @author Author Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @update Alexei Radashkovsky (alexeirada@gmail.com)
+ *  @bug No known bugs.
+ */
+
+#include "data_structure_defenitions.h"
+#include <stddef.h> /*< size_t >*/
+#include <stdint.h> /*< uint64_t >*/
+
+typedef struct U64Map U64Map;
+
+typedef int (*U64ActionFunction)(uint64_t _key, uint64_t _value, void* _context);
+
+/**
+ * @brief Create a new map.
+ * @param[in] _capacity - Expected number of pairs, the table is sized so they fit without growing.
+ * @return newly created map or null on failure
+ */
+U64Map* U64MapCreate(size_t _capacity);
+
+/**
+ * @brief destroy the map and set *_map to null
+ * @param[in] _map : map to be destroyed
+ */
+void U64MapDestroy(U64Map** _map);
+
+/**
+ * @brief Insert a key-value pair into the map.
+ * @param[in] _map - map to insert to
+ * @param[in] _key - key to serve as index, any value including 0
+ * @param[in] _value - the value to associate with the key
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_KEY_EXISTS_ERROR	if key already present in the map
+ * @retval  DS_ALLOCATION_ERROR if the table had to grow and could not
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error U64MapInsert(U64Map* _map, uint64_t _key, uint64_t _value);
+
+/**
+ * @brief Remove a key-value pair from the map.
+ * @param[in] _map - map to remove pair from
+ * @param[in] _key - key to to search for in the map
+ * @param[out] _pValue - optional, gets the value of the removed pair
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error U64MapRemove(U64Map* _map, uint64_t _key, uint64_t* _pValue);
+
+/**
+ * @brief Find a value by key
+ * @param[in] _map - map to use
+ * @param[in] _key - key to serve as index for search
+ * @param[out] _pValue - gets the value assoiciated with the key
+ * @return Success indicator
+ * @retval  DS_SUCCESS	on success
+ * @retval  DS_ELEMENT_NOT_FOUND_ERROR if key not found
+ * @retval  DS_UNINITIALIZED_ERROR
+ */
+aps_ds_error U64MapFind(const U64Map* _map, uint64_t _key, uint64_t* _pValue);
+
+/**
+ * @brief Get number of key-value pairs in the map
+ */
+size_t U64MapSize(const U64Map* _map);
+
+/**
+ * @brief Iterate over all key-value pairs in the map and call a function for each pair
+ * Iteration will stop if the called function returns a zero for a given pair
+ *
+ * @param[in] _map - map to iterate over, must not be changed during the iteration
+ * @param[in] _action - User provided function pointer to be invoked for each pair
+ * @param[in] _context - User provided context passed to _action
+ * @returns number of times the user functions was invoked
+ */
+size_t U64MapForEach(const U64Map* _map, U64ActionFunction _action, void* _context);
+
+#endif /* __U64_MAP_H__ */
@@ -15,3 +15,18 @@ SRCS += list_itr.$(SUFFIX)
 SRCS += list_operations.$(SUFFIX)
 SRCS += binary_tree.$(SUFFIX)
 SRCS += sorts.$(SUFFIX)
+SRCS += rcu_hash.$(SUFFIX)
+SRCS += frozen_hash.$(SUFFIX)
+SRCS += hash_set.$(SUFFIX)
+SRCS += bloom.$(SUFFIX)
+SRCS += u64_map.$(SUFFIX)
+SRCS += str_map.$(SUFFIX)
+SRCS += lru_cache.$(SUFFIX)
+SRCS += ttl_map.$(SUFFIX)
+SRCS += hash_multi_map.$(SUFFIX)
+SRCS += cuckoo_filter.$(SUFFIX)
+SRCS += key_heap.$(SUFFIX)
+SRCS += pairing_heap.$(SUFFIX)
+SRCS += multi_queue.$(SUFFIX)
+SRCS += min_max_heap.$(SUFFIX)
+SRCS += radix_heap.$(SUFFIX)
@@ -0,0 +1,255 @@
+#include "bloom.h"
+#include "hash_internal.h"
+#include <stdint.h> /*< uint64_t >*/
+#include <stdlib.h> /*< malloc >*/
+#include <string.h> /*< memcpy >*/
+
+#define BLOOM_MAGIC "APSBLM01"
+#define BLOOM_CACHE_LINE (64)
+#define BLOOM_WORDS_PER_BLOCK (BLOOM_CACHE_LINE / sizeof(uint64_t))
+#define BLOOM_BITS_PER_BLOCK (BLOOM_CACHE_LINE * 8)
+#define BLOOM_MAX_HASHES (16)
+#define BLOOM_LOG2E (1.4426950408889634)
+
+typedef struct BloomHeader {
+    char m_magic[8];
+    uint64_t m_numOfBlocks;
+    uint64_t m_numOfHashes;
+    uint64_t m_numOfItems;
+} BloomHeader;
+
+struct Bloom {
+    uint64_t* m_blocks;    /*< cache line aligned, BLOOM_WORDS_PER_BLOCK words per block >*/
+    void* m_memory;        /*< unaligned allocation of m_blocks >*/
+    size_t m_numOfBlocks;
+    size_t m_numOfHashes;  /*< bits set per key >*/
+    size_t m_numOfItems;
+};
+
+static Bloom* _CreateBloom(size_t _numOfBlocks, size_t _numOfHashes);
+static double _MinusLog2(double _x);
+static const uint64_t* _Block(const Bloom* _bloom, uint64_t _mixed);
+static uint64_t _MulHigh(uint64_t _first, uint64_t _second);
+static int _TestBlock(const uint64_t* _block, uint64_t _mixed, size_t _numOfHashes);
+
+Bloom* BloomCreate(size_t _expectedItems, double _fpRate) {
+    double bitsPerKey;
+    double numOfBits;
+    size_t numOfHashes;
+
+    if (_expectedItems == 0 || !(_fpRate > 0 && _fpRate < 1)) {
+        return NULL;
+    }
+
+    /* optimal filter: k = -log2(p) hashes, k / ln 2 bits per key */
+    bitsPerKey = _MinusLog2(_fpRate) * BLOOM_LOG2E;
+    numOfHashes = (size_t)(_MinusLog2(_fpRate) + 0.5);
+    if (numOfHashes == 0) {
+        numOfHashes = 1;
+    } else if (numOfHashes > BLOOM_MAX_HASHES) {
+        numOfHashes = BLOOM_MAX_HASHES;
+    }
+
+    numOfBits = bitsPerKey * (double)_expectedItems;
+    return _CreateBloom((size_t)(numOfBits / BLOOM_BITS_PER_BLOCK) + 1, numOfHashes);
+}
+
+void BloomDestroy(Bloom** _bloom) {
+    if (_bloom == NULL || *_bloom == NULL) {
+        return;
+    }
+
+    free((*_bloom)->m_memory);
+    free(*_bloom);
+    *_bloom = NULL;
+}
+
+aps_ds_error BloomAdd(Bloom* _bloom, size_t _hash) {
+    uint64_t mixed;
+    uint64_t* block;
+    size_t first;
+    size_t step;
+    size_t bit;
+    size_t i;
+
+    if (_bloom == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    mixed = HashMix64(_hash);
+    block = (uint64_t*)_Block(_bloom, mixed);
+    first = (size_t)(mixed & 0x1ff);
+    step = (size_t)((mixed >> 9) & 0x7fffff) | 1;
+    for (i = 0; i < _bloom->m_numOfHashes; ++i) {
+        bit = (first + i * step) % BLOOM_BITS_PER_BLOCK;
+        block[bit / 64] |= (uint64_t)1 << (bit % 64);
+    }
+
+    ++_bloom->m_numOfItems;
+    return DS_SUCCESS;
+}
+
+int BloomMayContain(const Bloom* _bloom, size_t _hash) {
+    uint64_t mixed;
+
+    if (_bloom == NULL) {
+        return 0;
+    }
+
+    mixed = HashMix64(_hash);
+    return _TestBlock(_Block(_bloom, mixed), mixed, _bloom->m_numOfHashes);
+}
+
+size_t BloomMayContainBatch(const Bloom* _bloom, const size_t* _hashes, size_t _numOfHashes, unsigned char* _results) {
+    size_t i;
+    size_t count = 0;
+
+    if (_bloom == NULL || _hashes == NULL || _results == NULL) {
+        return 0;
+    }
+
+    /* issue all the cache misses first, they overlap instead of being paid one by one */
+    for (i = 0; i < _numOfHashes; ++i) {
+        __builtin_prefetch(_Block(_bloom, HashMix64(_hashes[i])));
+    }
+
+    for (i = 0; i < _numOfHashes; ++i) {
+        _results[i] = (unsigned char)BloomMayContain(_bloom, _hashes[i]);
+        count += _results[i];
+    }
+    return count;
+}
+
+size_t BloomSize(const Bloom* _bloom) {
+    if (_bloom == NULL) {
+        return 0;
+    }
+    return _bloom->m_numOfItems;
+}
+
+size_t BloomSerialize(const Bloom* _bloom, void* _buffer, size_t _bufferSize) {
+    BloomHeader header;
+    size_t blocksSize;
+
+    if (_bloom == NULL) {
+        return 0;
+    }
+
+    blocksSize = _bloom->m_numOfBlocks * BLOOM_CACHE_LINE;
+    if (_buffer == NULL || _bufferSize < sizeof(BloomHeader) + blocksSize) {
+        return sizeof(BloomHeader) + blocksSize;
+    }
+
+    memcpy(header.m_magic, BLOOM_MAGIC, sizeof(header.m_magic));
+    header.m_numOfBlocks = _bloom->m_numOfBlocks;
+    header.m_numOfHashes = _bloom->m_numOfHashes;
+    header.m_numOfItems = _bloom->m_numOfItems;
+    memcpy(_buffer, &header, sizeof(BloomHeader));
+    memcpy((char*)_buffer + sizeof(BloomHeader), _bloom->m_blocks, blocksSize);
+    return sizeof(BloomHeader) + blocksSize;
+}
+
+Bloom* BloomDeserialize(const void* _buffer, size_t _bufferSize) {
+    BloomHeader header;
+    Bloom* bloom;
+
+    if (_buffer == NULL || _bufferSize < sizeof(BloomHeader)) {
+        return NULL;
+    }
+
+    memcpy(&header, _buffer, sizeof(BloomHeader));
+    if (memcmp(header.m_magic, BLOOM_MAGIC, sizeof(header.m_magic)) != 0
+        || header.m_numOfBlocks == 0
+        || header.m_numOfHashes == 0 || header.m_numOfHashes > BLOOM_MAX_HASHES
+        || header.m_numOfBlocks > (_bufferSize - sizeof(BloomHeader)) / BLOOM_CACHE_LINE
+        || header.m_numOfBlocks * BLOOM_CACHE_LINE != _bufferSize - sizeof(BloomHeader)) {
+        return NULL;
+    }
+
+    bloom = _CreateBloom((size_t)header.m_numOfBlocks, (size_t)header.m_numOfHashes);
+    if (bloom == NULL) {
+        return NULL;
+    }
+
+    memcpy(bloom->m_blocks, (const char*)_buffer + sizeof(BloomHeader), bloom->m_numOfBlocks * BLOOM_CACHE_LINE);
+    bloom->m_numOfItems = (size_t)header.m_numOfItems;
+    return bloom;
+}
+
+static Bloom* _CreateBloom(size_t _numOfBlocks, size_t _numOfHashes) {
+    Bloom* bloom;
+
+    bloom = (Bloom*)malloc(sizeof(Bloom));
+    if (bloom == NULL) {
+        return NULL;
+    }
+
+    bloom->m_memory = calloc(_numOfBlocks + 1, BLOOM_CACHE_LINE);
+    if (bloom->m_memory == NULL) {
+        free(bloom);
+        return NULL;
+    }
+
+    bloom->m_blocks = (uint64_t*)(((size_t)bloom->m_memory + BLOOM_CACHE_LINE - 1) & ~(size_t)(BLOOM_CACHE_LINE - 1));
+    bloom->m_numOfBlocks = _numOfBlocks;
+    bloom->m_numOfHashes = _numOfHashes;
+    bloom->m_numOfItems = 0;
+    return bloom;
+}
+
+/* -log2(_x) for 0 < _x < 1 without libm, log2(1 + f) is fitted by f * (1.3465 - 0.3465 * f) */
+static double _MinusLog2(double _x) {
+    double exponent = 0;
+    double fraction;
+
+    while (_x < 1) {
+        _x *= 2;
+        ++exponent;
+    }
+    fraction = _x - 1;
+    return exponent - fraction * (1.3465 - 0.3465 * fraction);
+}
+
+/* the high half of the mixed hash picks the block, the low half the bits inside it.
+ * Past 2^32 blocks the high half alone can not reach every block and the whole
+ * word is scaled, smaller filters keep the mapping their saved images were built with */
+static const uint64_t* _Block(const Bloom* _bloom, uint64_t _mixed) {
+    uint64_t numOfBlocks = (uint64_t)_bloom->m_numOfBlocks;
+    uint64_t idx;
+
+    if (0 == numOfBlocks >> 32) {
+        idx = ((_mixed >> 32) * numOfBlocks) >> 32;
+    } else {
+        idx = _MulHigh(_mixed, numOfBlocks);
+    }
+    return _bloom->m_blocks + idx * BLOOM_WORDS_PER_BLOCK;
+}
+
+/* high 64 bits of the 128 bit product, from 32 bit halves */
+static uint64_t _MulHigh(uint64_t _first, uint64_t _second) {
+    uint64_t firstLow = _first & 0xffffffffUL;
+    uint64_t firstHigh = _first >> 32;
+    uint64_t secondLow = _second & 0xffffffffUL;
+    uint64_t secondHigh = _second >> 32;
+    uint64_t lowLow = firstLow * secondLow;
+    uint64_t highLow = firstHigh * secondLow;
+    uint64_t lowHigh = firstLow * secondHigh;
+    uint64_t middle = (lowLow >> 32) + (highLow & 0xffffffffUL) + lowHigh;
+
+    return firstHigh * secondHigh + (highLow >> 32) + (middle >> 32);
+}
+
+static int _TestBlock(const uint64_t* _block, uint64_t _mixed, size_t _numOfHashes) {
+    size_t first = (size_t)(_mixed & 0x1ff);
+    size_t step = (size_t)((_mixed >> 9) & 0x7fffff) | 1;
+    size_t bit;
+    size_t i;
+
+    for (i = 0; i < _numOfHashes; ++i) {
+        bit = (first + i * step) % BLOOM_BITS_PER_BLOCK;
+        if (0 == (_block[bit / 64] & ((uint64_t)1 << (bit % 64)))) {
+            return 0;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,221 @@
+#include "cuckoo_filter.h"
+#include "hash_internal.h"
+#include <stdint.h> /*< uint64_t >*/
+#include <stdlib.h> /*< calloc >*/
+
+#define CUCKOO_SLOTS (4)
+#define CUCKOO_SLOT_BITS (16)
+#define CUCKOO_SLOT_MASK ((uint64_t)0xffff)
+#define CUCKOO_MAX_KICKS (500)
+/* fingerprint 0 marks an empty slot */
+#define CUCKOO_EMPTY (0)
+#define CUCKOO_LOW_BITS HASH_U64(0x00010001, 0x00010001)
+#define CUCKOO_HIGH_BITS HASH_U64(0x80008000, 0x80008000)
+
+struct CuckooFilter {
+    uint64_t* m_buckets;    /*< CUCKOO_SLOTS fingerprints of CUCKOO_SLOT_BITS per bucket >*/
+    size_t m_mask;          /*< number of buckets - 1, a power of two minus one >*/
+    size_t m_numOfItems;
+    uint64_t m_random;      /*< state of the generator picking the fingerprint to kick >*/
+    uint64_t m_victim;      /*< fingerprint left without a bucket by a failed add, CUCKOO_EMPTY if none >*/
+    size_t m_victimBucket;
+};
+
+static void _IndexAndFingerprint(const CuckooFilter* _filter, size_t _hash, size_t* _bucket, uint64_t* _fingerprint);
+static size_t _AltBucket(const CuckooFilter* _filter, size_t _bucket, uint64_t _fingerprint);
+static int _HasFingerprint(uint64_t _bucket, uint64_t _fingerprint);
+static int _PutInBucket(uint64_t* _bucket, uint64_t _fingerprint);
+static int _TakeFromBucket(uint64_t* _bucket, uint64_t _fingerprint);
+
+CuckooFilter* CuckooFilterCreate(size_t _expectedItems) {
+    CuckooFilter* filter;
+    size_t needed;
+    size_t numOfBuckets = 2;
+
+    if (_expectedItems == 0 || _expectedItems > ((size_t)-1) / 100) {
+        return NULL;
+    }
+
+    /* a table of 4 way buckets fills to about 95% before adds start to fail */
+    needed = (_expectedItems * 100 + 379) / 380;
+    while (numOfBuckets < needed) {
+        if (numOfBuckets > ((size_t)-1) / 2 / sizeof(uint64_t)) {
+            return NULL;
+        }
+        numOfBuckets *= 2;
+    }
+
+    filter = (CuckooFilter*)malloc(sizeof(CuckooFilter));
+    if (filter == NULL) {
+        return NULL;
+    }
+
+    filter->m_buckets = (uint64_t*)calloc(numOfBuckets, sizeof(uint64_t));
+    if (filter->m_buckets == NULL) {
+        free(filter);
+        return NULL;
+    }
+
+    filter->m_mask = numOfBuckets - 1;
+    filter->m_numOfItems = 0;
+    filter->m_random = HASH_U64(0x9e3779b9, 0x7f4a7c15);
+    filter->m_victim = CUCKOO_EMPTY;
+    filter->m_victimBucket = 0;
+    return filter;
+}
+
+void CuckooFilterDestroy(CuckooFilter** _filter) {
+    if (_filter == NULL || *_filter == NULL) {
+        return;
+    }
+
+    free((*_filter)->m_buckets);
+    free(*_filter);
+    *_filter = NULL;
+}
+
+aps_ds_error CuckooFilterAdd(CuckooFilter* _filter, size_t _hash) {
+    size_t bucket;
+    uint64_t fingerprint;
+    uint64_t kicked;
+    size_t slot;
+    size_t kick;
+
+    if (_filter == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    /* the homeless fingerprint of the last failed add must be placed before anything else */
+    if (_filter->m_victim != CUCKOO_EMPTY) {
+        return DS_OVERFLOW_ERROR;
+    }
+
+    _IndexAndFingerprint(_filter, _hash, &bucket, &fingerprint);
+    ++_filter->m_numOfItems;
+    if (_PutInBucket(&_filter->m_buckets[bucket], fingerprint)) {
+        return DS_SUCCESS;
+    }
+
+    bucket = _AltBucket(_filter, bucket, fingerprint);
+    for (kick = 0; kick < CUCKOO_MAX_KICKS; ++kick) {
+        if (_PutInBucket(&_filter->m_buckets[bucket], fingerprint)) {
+            return DS_SUCCESS;
+        }
+
+        /* xorshift64 */
+        _filter->m_random ^= _filter->m_random << 13;
+        _filter->m_random ^= _filter->m_random >> 7;
+        _filter->m_random ^= _filter->m_random << 17;
+        slot = (size_t)(_filter->m_random % CUCKOO_SLOTS) * CUCKOO_SLOT_BITS;
+
+        kicked = (_filter->m_buckets[bucket] >> slot) & CUCKOO_SLOT_MASK;
+        _filter->m_buckets[bucket] &= ~(CUCKOO_SLOT_MASK << slot);
+        _filter->m_buckets[bucket] |= fingerprint << slot;
+        fingerprint = kicked;
+        bucket = _AltBucket(_filter, bucket, fingerprint);
+    }
+
+    /* the new key is in, some older one is not: keep it aside so it is never falsely reported absent */
+    _filter->m_victim = fingerprint;
+    _filter->m_victimBucket = bucket;
+    return DS_SUCCESS;
+}
+
+int CuckooFilterContains(const CuckooFilter* _filter, size_t _hash) {
+    size_t bucket;
+    uint64_t fingerprint;
+    size_t alt;
+
+    if (_filter == NULL) {
+        return 0;
+    }
+
+    _IndexAndFingerprint(_filter, _hash, &bucket, &fingerprint);
+    alt = _AltBucket(_filter, bucket, fingerprint);
+    return _HasFingerprint(_filter->m_buckets[bucket], fingerprint)
+        || _HasFingerprint(_filter->m_buckets[alt], fingerprint)
+        || (_filter->m_victim == fingerprint && (_filter->m_victimBucket == bucket || _filter->m_victimBucket == alt));
+}
+
+aps_ds_error CuckooFilterDelete(CuckooFilter* _filter, size_t _hash) {
+    size_t bucket;
+    uint64_t fingerprint;
+    size_t alt;
+
+    if (_filter == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    _IndexAndFingerprint(_filter, _hash, &bucket, &fingerprint);
+    alt = _AltBucket(_filter, bucket, fingerprint);
+    if (_filter->m_victim == fingerprint && (_filter->m_victimBucket == bucket || _filter->m_victimBucket == alt)) {
+        _filter->m_victim = CUCKOO_EMPTY;
+    } else if (!_TakeFromBucket(&_filter->m_buckets[bucket], fingerprint)
+               && !_TakeFromBucket(&_filter->m_buckets[alt], fingerprint)) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+    --_filter->m_numOfItems;
+
+    /* the freed slot may be one of the victim's buckets */
+    if (_filter->m_victim != CUCKOO_EMPTY) {
+        if (_PutInBucket(&_filter->m_buckets[_filter->m_victimBucket], _filter->m_victim)
+            || _PutInBucket(&_filter->m_buckets[_AltBucket(_filter, _filter->m_victimBucket, _filter->m_victim)], _filter->m_victim)) {
+            _filter->m_victim = CUCKOO_EMPTY;
+        }
+    }
+    return DS_SUCCESS;
+}
+
+size_t CuckooFilterSize(const CuckooFilter* _filter) {
+    if (_filter == NULL) {
+        return 0;
+    }
+    return _filter->m_numOfItems;
+}
+
+/* the low bits of the mixed hash pick the bucket, the high bits make the fingerprint */
+static void _IndexAndFingerprint(const CuckooFilter* _filter, size_t _hash, size_t* _bucket, uint64_t* _fingerprint) {
+    uint64_t mixed = HashMix64(_hash);
+    *_bucket = (size_t)mixed & _filter->m_mask;
+    *_fingerprint = (mixed >> 48) & CUCKOO_SLOT_MASK;
+    if (*_fingerprint == CUCKOO_EMPTY) {
+        *_fingerprint = 1;
+    }
+}
+
+/* partial key cuckoo hashing: the other bucket follows from a bucket and the fingerprint alone,
+ * and applying it twice gives the first bucket back */
+static size_t _AltBucket(const CuckooFilter* _filter, size_t _bucket, uint64_t _fingerprint) {
+    return (_bucket ^ (size_t)HashMix64(_fingerprint)) & _filter->m_mask;
+}
+
+/* all four slots are compared at once: a slot equal to the fingerprint becomes a zero lane */
+static int _HasFingerprint(uint64_t _bucket, uint64_t _fingerprint) {
+    uint64_t lanes = _bucket ^ (_fingerprint * CUCKOO_LOW_BITS);
+    return ((lanes - CUCKOO_LOW_BITS) & ~lanes & CUCKOO_HIGH_BITS) != 0;
+}
+
+static int _PutInBucket(uint64_t* _bucket, uint64_t _fingerprint) {
+    size_t slot;
+
+    if (!_HasFingerprint(*_bucket, CUCKOO_EMPTY)) {
+        return 0;
+    }
+
+    for (slot = 0; ((*_bucket >> slot) & CUCKOO_SLOT_MASK) != CUCKOO_EMPTY; slot += CUCKOO_SLOT_BITS) {
+    }
+    *_bucket |= _fingerprint << slot;
+    return 1;
+}
+
+static int _TakeFromBucket(uint64_t* _bucket, uint64_t _fingerprint) {
+    size_t slot;
+
+    for (slot = 0; slot < CUCKOO_SLOTS * CUCKOO_SLOT_BITS; slot += CUCKOO_SLOT_BITS) {
+        if (((*_bucket >> slot) & CUCKOO_SLOT_MASK) == _fingerprint) {
+            *_bucket &= ~(CUCKOO_SLOT_MASK << slot);
+            return 1;
+        }
+    }
+    return 0;
+}
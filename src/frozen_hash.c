@@ -0,0 +1,747 @@
+#include "frozen_hash.h"
+#include "hash_internal.h"
+#include <fcntl.h>    /*< open >*/
+#include <stdint.h>   /*< uint64_t >*/
+#include <stdio.h>    /*< FILE >*/
+#include <stdlib.h>   /*< malloc >*/
+#include <string.h>   /*< memcmp >*/
+#include <sys/mman.h> /*< mmap >*/
+#include <sys/stat.h> /*< fstat >*/
+#include <unistd.h>   /*< close >*/
+
+#define FROZEN_MAGIC "APSFHM02"
+#define FROZEN_KEYS_PER_BUCKET (4)
+#define FROZEN_MAX_SEEDS (16)
+#define FROZEN_MAX_TRIES ((size_t)1 << 22)
+#define FROZEN_ALIGN (8)
+#define FROZEN_ENCODE_BUFFER (256)
+
+typedef struct FrozenSlot {
+    size_t m_hash;
+    size_t m_key;   /*< address, or offset from m_base in a loaded image >*/
+    size_t m_value; /*< address, or offset from m_base in a loaded image >*/
+    size_t m_next;  /*< index + 1 of the next slot of the same hash, 0 for none >*/
+} FrozenSlot;
+
+/* image layout: header | displacements | key/value arena | slots.
+ * The perfect hash maps each distinct hash to one of the first m_numOfHashes slots,
+ * keys sharing a hash with another key follow in the slots after those */
+typedef struct FrozenHeader {
+    char m_magic[8];
+    uint64_t m_wordSize;
+    uint64_t m_numOfItems;
+    uint64_t m_numOfHashes;
+    uint64_t m_numOfBuckets;
+    uint64_t m_seed;
+    uint64_t m_displacementsOffset;
+    uint64_t m_slotsOffset;
+    uint64_t m_imageSize;
+} FrozenHeader;
+
+struct FrozenHashMap {
+    size_t m_base;                 /*< 0, or the address of a loaded image >*/
+    const size_t* m_displacements; /*< (d0, d1) pair per bucket >*/
+    const FrozenSlot* m_slots;
+    size_t m_numOfItems;
+    size_t m_numOfHashes;          /*< distinct hashes, slots reached by the perfect hash >*/
+    size_t m_numOfBuckets;
+    size_t m_seed;
+    size_t m_arenaBegin;           /*< key and value offsets of a loaded image lie in [begin, end) >*/
+    size_t m_arenaEnd;
+    HashFunction m_hashFunc;
+    EqualityFunction m_keysEqualFunc;
+    void* m_memory;                /*< owned block holding the arrays or the image >*/
+    size_t m_mappedSize;           /*< none zero when m_memory is a mapping of the image >*/
+};
+
+typedef struct FrozenBuild {
+    const FrozenSlot* m_pairs;
+    size_t* m_bucketOf;
+    size_t* m_first;     /*< f1 per key >*/
+    size_t* m_step;      /*< f2 per key >*/
+    size_t* m_bucketStart;
+    size_t* m_keysByBucket;
+    size_t* m_bucketsBySize;
+    size_t* m_positions;
+    char* m_occupied;
+    size_t m_numOfItems;
+    size_t m_numOfBuckets;
+} FrozenBuild;
+
+static FrozenHashMap* _CreateFrozen(size_t _numOfItems, size_t _numOfHashes, HashFunction _hashFunc, EqualityFunction _keysEqualFunc);
+static void _MixHash(size_t _hash, size_t _seed, size_t _numOfItems, size_t _numOfBuckets, size_t* _bucket, size_t* _first, size_t* _step);
+static FrozenSlot* _CollectPairs(const HashMap* _map);
+static int _CompareHash(const void* _first, const void* _second);
+static size_t _CountHashes(const FrozenSlot* _pairs, size_t _numOfItems);
+static void _SplitEqualHashes(FrozenSlot* _pairs, size_t _numOfItems, size_t _numOfHashes, FrozenSlot* _slots);
+static int _AllocBuild(FrozenBuild* _build, const FrozenSlot* _pairs, size_t _numOfItems, size_t _numOfBuckets);
+static void _FreeBuild(FrozenBuild* _build);
+static int _TryBuild(FrozenBuild* _build, size_t _seed, size_t* _displacements, FrozenSlot* _slots);
+static void _GroupByBucket(FrozenBuild* _build);
+static int _PlaceBucket(FrozenBuild* _build, size_t _bucket, size_t* _displacement);
+static int _FitsBucket(FrozenBuild* _build, const size_t* _keys, size_t _numOfKeys, size_t _d0, size_t _d1);
+static FrozenHashMap* _FromImage(void* _image, size_t _imageSize, HashFunction _hashFunc, EqualityFunction _keysEqualFunc);
+static int _FitsImage(uint64_t _offset, uint64_t _count, size_t _itemSize, uint64_t _imageSize);
+static int _SlotIsValid(const FrozenHashMap* _frozen, const FrozenSlot* _slot);
+static int _WriteAligned(FILE* _fp, const void* _data, size_t _size, size_t* _offset);
+static int _WriteEncoded(FILE* _fp, FrozenEncodeFunction _encode, const void* _item, char** _buffer, size_t* _bufferSize, size_t* _offset);
+
+FrozenHashMap* HashMapFreeze(const HashMap* _map) {
+    FrozenHashMap* frozen;
+    FrozenSlot* pairs;
+    FrozenBuild build;
+    size_t numOfHashes;
+    size_t seed;
+
+    /* a seeded map's hashes depend on its secret seed, a frozen map is looked up with a plain HashFunction */
+    if (NULL == _map || NULL == _map->m_hashFunc) {
+        return NULL;
+    }
+
+    pairs = _CollectPairs(_map);
+    if (NULL == pairs) {
+        return NULL;
+    }
+
+    /* keys of equal hashes can not be told apart by the perfect hash, only the first of
+     * each hash is placed by it and the others are chained behind it */
+    qsort(pairs, _map->m_size, sizeof(FrozenSlot), _CompareHash);
+    numOfHashes = _CountHashes(pairs, _map->m_size);
+
+    frozen = _CreateFrozen(_map->m_size, numOfHashes, _map->m_hashFunc, _map->m_keysEqualFunc);
+    if (NULL == frozen) {
+        free(pairs);
+        return NULL;
+    }
+    _SplitEqualHashes(pairs, _map->m_size, numOfHashes, (FrozenSlot*)frozen->m_slots);
+
+    if (0 != _AllocBuild(&build, pairs, numOfHashes, frozen->m_numOfBuckets)) {
+        free(pairs);
+        FrozenHashMapDestroy(&frozen);
+        return NULL;
+    }
+
+    for (seed = 0; seed < FROZEN_MAX_SEEDS; ++seed) {
+        if (0 == _TryBuild(&build, seed, (size_t*)frozen->m_displacements, (FrozenSlot*)frozen->m_slots)) {
+            frozen->m_seed = seed;
+            break;
+        }
+    }
+
+    _FreeBuild(&build);
+    free(pairs);
+    if (FROZEN_MAX_SEEDS == seed) {
+        FrozenHashMapDestroy(&frozen);
+    }
+    return frozen;
+}
+
+void FrozenHashMapDestroy(FrozenHashMap** _frozen) {
+    if (NULL == _frozen || NULL == *_frozen) {
+        return;
+    }
+
+    if (0 != (*_frozen)->m_mappedSize) {
+        munmap((*_frozen)->m_memory, (*_frozen)->m_mappedSize);
+    } else {
+        free((*_frozen)->m_memory);
+    }
+    free(*_frozen);
+    *_frozen = NULL;
+}
+
+aps_ds_error FrozenHashMapFind(const FrozenHashMap* _frozen, const void* _searchKey, void** _pValue) {
+    const FrozenSlot* slot;
+    const size_t* displacement;
+    size_t hash;
+    size_t bucket;
+    size_t first;
+    size_t step;
+
+    if (NULL == _frozen || NULL == _pValue) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (NULL == _searchKey) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    if (0 == _frozen->m_numOfHashes) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    hash = _frozen->m_hashFunc(_searchKey);
+    _MixHash(hash, _frozen->m_seed, _frozen->m_numOfHashes, _frozen->m_numOfBuckets, &bucket, &first, &step);
+    displacement = _frozen->m_displacements + 2 * bucket;
+    slot = _frozen->m_slots + (first + (displacement[0] * step) % _frozen->m_numOfHashes + displacement[1]) % _frozen->m_numOfHashes;
+
+    if (slot->m_hash != hash) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    /* only the slots a lookup reads are checked, loading an image touches none of them */
+    if (!_SlotIsValid(_frozen, slot)) {
+        return DS_GENERAL_ERROR;
+    }
+    while (!_frozen->m_keysEqualFunc(_searchKey, (const void*)(_frozen->m_base + slot->m_key))) {
+        if (0 == slot->m_next) {
+            return DS_ELEMENT_NOT_FOUND_ERROR;
+        }
+        slot = _frozen->m_slots + slot->m_next - 1;
+        if (!_SlotIsValid(_frozen, slot)) {
+            return DS_GENERAL_ERROR;
+        }
+    }
+
+    *_pValue = (void*)(_frozen->m_base + slot->m_value);
+    return DS_SUCCESS;
+}
+
+size_t FrozenHashMapSize(const FrozenHashMap* _frozen) {
+    if (NULL == _frozen) {
+        return 0;
+    }
+    return _frozen->m_numOfItems;
+}
+
+aps_ds_error FrozenHashMapDump(const FrozenHashMap* _frozen, const char* _fileName,
+                               FrozenEncodeFunction _keyEncode, FrozenEncodeFunction _valEncode) {
+    FrozenHeader header;
+    FrozenSlot* slots;
+    char* buffer;
+    size_t bufferSize = FROZEN_ENCODE_BUFFER;
+    size_t offset = 0;
+    size_t i;
+    int ioError = 0;
+    FILE* fp;
+
+    if (NULL == _frozen || NULL == _fileName || NULL == _keyEncode || NULL == _valEncode) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    slots = (FrozenSlot*)malloc((_frozen->m_numOfItems + 1) * sizeof(FrozenSlot));
+    buffer = (char*)malloc(bufferSize);
+    if (NULL == slots || NULL == buffer) {
+        free(slots);
+        free(buffer);
+        return DS_ALLOCATION_ERROR;
+    }
+
+    fp = fopen(_fileName, "wb");
+    if (NULL == fp) {
+        free(slots);
+        free(buffer);
+        return DS_GENERAL_ERROR;
+    }
+
+    memset(&header, 0, sizeof(header));
+    ioError |= _WriteAligned(fp, &header, sizeof(header), &offset);
+    header.m_displacementsOffset = offset;
+    ioError |= _WriteAligned(fp, _frozen->m_displacements, 2 * _frozen->m_numOfBuckets * sizeof(size_t), &offset);
+
+    for (i = 0; i < _frozen->m_numOfItems && 0 == ioError; ++i) {
+        slots[i].m_hash = _frozen->m_slots[i].m_hash;
+        slots[i].m_next = _frozen->m_slots[i].m_next;
+        slots[i].m_key = offset;
+        ioError |= _WriteEncoded(fp, _keyEncode, (const void*)(_frozen->m_base + _frozen->m_slots[i].m_key), &buffer, &bufferSize, &offset);
+        slots[i].m_value = offset;
+        ioError |= _WriteEncoded(fp, _valEncode, (const void*)(_frozen->m_base + _frozen->m_slots[i].m_value), &buffer, &bufferSize, &offset);
+    }
+
+    header.m_slotsOffset = offset;
+    ioError |= _WriteAligned(fp, slots, _frozen->m_numOfItems * sizeof(FrozenSlot), &offset);
+
+    memcpy(header.m_magic, FROZEN_MAGIC, sizeof(header.m_magic));
+    header.m_wordSize = sizeof(size_t);
+    header.m_numOfItems = _frozen->m_numOfItems;
+    header.m_numOfHashes = _frozen->m_numOfHashes;
+    header.m_numOfBuckets = _frozen->m_numOfBuckets;
+    header.m_seed = _frozen->m_seed;
+    header.m_imageSize = offset;
+    if (0 != fseek(fp, 0, SEEK_SET) || 1 != fwrite(&header, sizeof(header), 1, fp)) {
+        ioError = 1;
+    }
+
+    ioError |= (0 != fclose(fp));
+    free(slots);
+    free(buffer);
+    return (0 == ioError) ? DS_SUCCESS : DS_GENERAL_ERROR;
+}
+
+aps_ds_error HashMapSave(const HashMap* _map, const char* _fileName,
+                         FrozenEncodeFunction _keyEncode, FrozenEncodeFunction _valEncode) {
+    FrozenHashMap* frozen;
+    aps_ds_error result;
+
+    if (NULL == _map || NULL == _fileName || NULL == _keyEncode || NULL == _valEncode) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    frozen = HashMapFreeze(_map);
+    if (NULL == frozen) {
+        return DS_GENERAL_ERROR;
+    }
+
+    result = FrozenHashMapDump(frozen, _fileName, _keyEncode, _valEncode);
+    FrozenHashMapDestroy(&frozen);
+    return result;
+}
+
+FrozenHashMap* FrozenHashMapLoad(const char* _fileName, HashFunction _hashFunc, EqualityFunction _keysEqualFunc) {
+    FrozenHashMap* frozen;
+    char* image;
+    long imageSize;
+    FILE* fp;
+
+    if (NULL == _fileName || NULL == _hashFunc || NULL == _keysEqualFunc) {
+        return NULL;
+    }
+
+    fp = fopen(_fileName, "rb");
+    if (NULL == fp) {
+        return NULL;
+    }
+
+    if (0 != fseek(fp, 0, SEEK_END) || (imageSize = ftell(fp)) < (long)sizeof(FrozenHeader) || 0 != fseek(fp, 0, SEEK_SET)) {
+        fclose(fp);
+        return NULL;
+    }
+
+    image = (char*)malloc((size_t)imageSize);
+    if (NULL == image) {
+        fclose(fp);
+        return NULL;
+    }
+
+    if (1 != fread(image, (size_t)imageSize, 1, fp)) {
+        fclose(fp);
+        free(image);
+        return NULL;
+    }
+    fclose(fp);
+
+    frozen = _FromImage(image, (size_t)imageSize, _hashFunc, _keysEqualFunc);
+    if (NULL == frozen) {
+        free(image);
+    }
+    return frozen;
+}
+
+FrozenHashMap* FrozenHashMapMap(const char* _fileName, HashFunction _hashFunc, EqualityFunction _keysEqualFunc) {
+    FrozenHashMap* frozen;
+    struct stat fileStat;
+    void* image;
+    int fd;
+
+    if (NULL == _fileName || NULL == _hashFunc || NULL == _keysEqualFunc) {
+        return NULL;
+    }
+
+    fd = open(_fileName, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (0 != fstat(fd, &fileStat) || fileStat.st_size < (off_t)sizeof(FrozenHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    /* the mapping keeps the file referenced, the descriptor is not needed any more */
+    image = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == image) {
+        return NULL;
+    }
+
+    frozen = _FromImage(image, (size_t)fileStat.st_size, _hashFunc, _keysEqualFunc);
+    if (NULL == frozen) {
+        munmap(image, (size_t)fileStat.st_size);
+        return NULL;
+    }
+
+    frozen->m_mappedSize = (size_t)fileStat.st_size;
+    return frozen;
+}
+
+/* every region must lie inside the image, the sums are checked against what is left of the
+ * image so a crafted offset can not wrap around. The slots are left unread, Find checks each
+ * slot it probes so mapping a large image costs no per entry work */
+static FrozenHashMap* _FromImage(void* _image, size_t _imageSize, HashFunction _hashFunc, EqualityFunction _keysEqualFunc) {
+    const FrozenHeader* header = (const FrozenHeader*)_image;
+    FrozenHashMap* frozen;
+    uint64_t arenaOffset;
+
+    if (0 != memcmp(header->m_magic, FROZEN_MAGIC, sizeof(header->m_magic)) ||
+        sizeof(size_t) != header->m_wordSize ||
+        (uint64_t)_imageSize != header->m_imageSize ||
+        0 == header->m_numOfBuckets ||
+        header->m_numOfHashes > header->m_numOfItems ||
+        (0 == header->m_numOfHashes) != (0 == header->m_numOfItems) ||
+        header->m_displacementsOffset < sizeof(FrozenHeader) ||
+        0 != header->m_displacementsOffset % sizeof(size_t) ||
+        0 != header->m_slotsOffset % sizeof(size_t) ||
+        !_FitsImage(header->m_displacementsOffset, header->m_numOfBuckets, 2 * sizeof(size_t), header->m_imageSize)) {
+        return NULL;
+    }
+
+    arenaOffset = header->m_displacementsOffset + header->m_numOfBuckets * 2 * sizeof(size_t);
+    if (header->m_slotsOffset < arenaOffset ||
+        !_FitsImage(header->m_slotsOffset, header->m_numOfItems, sizeof(FrozenSlot), header->m_imageSize)) {
+        return NULL;
+    }
+
+    frozen = (FrozenHashMap*)malloc(sizeof(FrozenHashMap));
+    if (NULL == frozen) {
+        return NULL;
+    }
+
+    frozen->m_base = (size_t)_image;
+    frozen->m_displacements = (const size_t*)((const char*)_image + header->m_displacementsOffset);
+    frozen->m_slots = (const FrozenSlot*)((const char*)_image + header->m_slotsOffset);
+    frozen->m_numOfItems = header->m_numOfItems;
+    frozen->m_numOfHashes = header->m_numOfHashes;
+    frozen->m_numOfBuckets = header->m_numOfBuckets;
+    frozen->m_seed = header->m_seed;
+    frozen->m_arenaBegin = (size_t)arenaOffset;
+    frozen->m_arenaEnd = (size_t)header->m_slotsOffset;
+    frozen->m_hashFunc = _hashFunc;
+    frozen->m_keysEqualFunc = _keysEqualFunc;
+    frozen->m_memory = _image;
+    frozen->m_mappedSize = 0;
+    return frozen;
+}
+
+/* none zero if _count items of _itemSize bytes from _offset end inside the image */
+static int _FitsImage(uint64_t _offset, uint64_t _count, size_t _itemSize, uint64_t _imageSize) {
+    return _offset <= _imageSize && _count <= (_imageSize - _offset) / _itemSize;
+}
+
+/* keys and values are written between the displacements and the slots,
+ * a chain only moves forward into the slots after the hashed ones */
+static int _SlotIsValid(const FrozenHashMap* _frozen, const FrozenSlot* _slot) {
+    size_t index = (size_t)(_slot - _frozen->m_slots);
+    return _slot->m_key >= _frozen->m_arenaBegin && _slot->m_key < _frozen->m_arenaEnd &&
+           _slot->m_value >= _frozen->m_arenaBegin && _slot->m_value < _frozen->m_arenaEnd &&
+           (0 == _slot->m_next || (_slot->m_next > index + 1 && _slot->m_next > _frozen->m_numOfHashes &&
+                                   _slot->m_next <= _frozen->m_numOfItems));
+}
+
+static FrozenHashMap* _CreateFrozen(size_t _numOfItems, size_t _numOfHashes, HashFunction _hashFunc, EqualityFunction _keysEqualFunc) {
+    FrozenHashMap* frozen;
+    size_t numOfBuckets = _numOfHashes / FROZEN_KEYS_PER_BUCKET + 1;
+    char* memory;
+
+    frozen = (FrozenHashMap*)malloc(sizeof(FrozenHashMap));
+    if (NULL == frozen) {
+        return NULL;
+    }
+
+    memory = (char*)calloc(2 * numOfBuckets * sizeof(size_t) + _numOfItems * sizeof(FrozenSlot), 1);
+    if (NULL == memory) {
+        free(frozen);
+        return NULL;
+    }
+
+    frozen->m_base = 0;
+    frozen->m_displacements = (const size_t*)memory;
+    frozen->m_slots = (const FrozenSlot*)(memory + 2 * numOfBuckets * sizeof(size_t));
+    frozen->m_numOfItems = _numOfItems;
+    frozen->m_numOfHashes = _numOfHashes;
+    frozen->m_numOfBuckets = numOfBuckets;
+    frozen->m_seed = 0;
+    frozen->m_arenaBegin = 0;
+    frozen->m_arenaEnd = (size_t)-1;
+    frozen->m_hashFunc = _hashFunc;
+    frozen->m_keysEqualFunc = _keysEqualFunc;
+    frozen->m_memory = memory;
+    frozen->m_mappedSize = 0;
+    return frozen;
+}
+
+/* bucket from the first mix, f1 and f2 from the two halves of the second */
+static void _MixHash(size_t _hash, size_t _seed, size_t _numOfItems, size_t _numOfBuckets, size_t* _bucket, size_t* _first, size_t* _step) {
+    uint64_t x = HashMix64((uint64_t)_hash + (uint64_t)_seed * HASH_U64(0x9e3779b9, 0x7f4a7c15));
+    uint64_t y = HashMix64(x);
+    *_bucket = (size_t)(x % _numOfBuckets);
+    *_first = (size_t)(y % _numOfItems);
+    *_step = (size_t)((y >> 32) % _numOfItems);
+}
+
+static FrozenSlot* _CollectPairs(const HashMap* _map) {
+    FrozenSlot* pairs;
+    Elements* elements;
+    ListItr itr;
+    ListItr end;
+    size_t count = 0;
+    size_t idx;
+
+    pairs = (FrozenSlot*)malloc((_map->m_size + 1) * sizeof(FrozenSlot));
+    if (NULL == pairs) {
+        return NULL;
+    }
+
+    for (idx = 0; idx < _map->m_capacity; ++idx) {
+        end = ListItr_End(_map->m_lists[idx]);
+        for (itr = ListItr_Begin(_map->m_lists[idx]); itr != end; itr = ListItr_Next(itr)) {
+            elements = (Elements*)ListItr_Get(itr);
+            pairs[count].m_hash = _map->m_hashFunc(elements->m_key);
+            pairs[count].m_key = (size_t)elements->m_key;
+            pairs[count].m_value = (size_t)elements->m_value;
+            ++count;
+        }
+    }
+    return pairs;
+}
+
+static int _CompareHash(const void* _first, const void* _second) {
+    size_t first = ((const FrozenSlot*)_first)->m_hash;
+    size_t second = ((const FrozenSlot*)_second)->m_hash;
+    return (first > second) - (first < second);
+}
+
+/* _pairs are sorted by hash */
+static size_t _CountHashes(const FrozenSlot* _pairs, size_t _numOfItems) {
+    size_t count = 0;
+    size_t i;
+
+    for (i = 0; i < _numOfItems; ++i) {
+        count += (0 == i || _pairs[i].m_hash != _pairs[i - 1].m_hash);
+    }
+    return count;
+}
+
+/* packs the first pair of every hash to the front of _pairs and moves the others to
+ * _slots[_numOfHashes..], each chained from the pair before it of the same hash */
+static void _SplitEqualHashes(FrozenSlot* _pairs, size_t _numOfItems, size_t _numOfHashes, FrozenSlot* _slots) {
+    FrozenSlot* last = NULL;
+    size_t numOfHeads = 0;
+    size_t extra = _numOfHashes;
+    size_t i;
+
+    for (i = 0; i < _numOfItems; ++i) {
+        if (0 == numOfHeads || _pairs[i].m_hash != _pairs[numOfHeads - 1].m_hash) {
+            _pairs[numOfHeads] = _pairs[i];
+            last = _pairs + numOfHeads++;
+        } else {
+            _slots[extra] = _pairs[i];
+            last->m_next = extra + 1;
+            last = _slots + extra++;
+        }
+        last->m_next = 0;
+    }
+}
+
+static int _AllocBuild(FrozenBuild* _build, const FrozenSlot* _pairs, size_t _numOfItems, size_t _numOfBuckets) {
+    size_t n = _numOfItems + 1;
+    _build->m_pairs = _pairs;
+    _build->m_numOfItems = _numOfItems;
+    _build->m_numOfBuckets = _numOfBuckets;
+    _build->m_bucketOf = (size_t*)malloc(n * sizeof(size_t));
+    _build->m_first = (size_t*)malloc(n * sizeof(size_t));
+    _build->m_step = (size_t*)malloc(n * sizeof(size_t));
+    _build->m_keysByBucket = (size_t*)malloc(n * sizeof(size_t));
+    _build->m_positions = (size_t*)malloc(n * sizeof(size_t));
+    _build->m_bucketStart = (size_t*)malloc((_numOfBuckets + 1) * sizeof(size_t));
+    _build->m_bucketsBySize = (size_t*)malloc(_numOfBuckets * sizeof(size_t));
+    _build->m_occupied = (char*)malloc(n);
+
+    if (NULL == _build->m_bucketOf || NULL == _build->m_first || NULL == _build->m_step ||
+        NULL == _build->m_keysByBucket || NULL == _build->m_positions || NULL == _build->m_bucketStart ||
+        NULL == _build->m_bucketsBySize || NULL == _build->m_occupied) {
+        _FreeBuild(_build);
+        return -1;
+    }
+    return 0;
+}
+
+static void _FreeBuild(FrozenBuild* _build) {
+    free(_build->m_bucketOf);
+    free(_build->m_first);
+    free(_build->m_step);
+    free(_build->m_keysByBucket);
+    free(_build->m_positions);
+    free(_build->m_bucketStart);
+    free(_build->m_bucketsBySize);
+    free(_build->m_occupied);
+}
+
+static int _TryBuild(FrozenBuild* _build, size_t _seed, size_t* _displacements, FrozenSlot* _slots) {
+    const size_t* displacement;
+    size_t n = _build->m_numOfItems;
+    size_t freeSlot = 0;
+    size_t bucket;
+    size_t key;
+    size_t i;
+
+    if (0 == n) {
+        return 0;
+    }
+
+    for (i = 0; i < n; ++i) {
+        _MixHash(_build->m_pairs[i].m_hash, _seed, n, _build->m_numOfBuckets,
+                 _build->m_bucketOf + i, _build->m_first + i, _build->m_step + i);
+    }
+    _GroupByBucket(_build);
+    memset(_build->m_occupied, 0, n);
+
+    /* biggest buckets first while the table is empty, single keys take any free slot */
+    for (i = 0; i < _build->m_numOfBuckets; ++i) {
+        bucket = _build->m_bucketsBySize[i];
+        switch (_build->m_bucketStart[bucket + 1] - _build->m_bucketStart[bucket]) {
+            case 0:
+                _displacements[2 * bucket] = 0;
+                _displacements[2 * bucket + 1] = 0;
+                break;
+            case 1:
+                key = _build->m_keysByBucket[_build->m_bucketStart[bucket]];
+                while (_build->m_occupied[freeSlot]) {
+                    ++freeSlot;
+                }
+                _build->m_occupied[freeSlot] = 1;
+                _displacements[2 * bucket] = 0;
+                _displacements[2 * bucket + 1] = (freeSlot + n - _build->m_first[key]) % n;
+                break;
+            default:
+                if (0 != _PlaceBucket(_build, bucket, _displacements + 2 * bucket)) {
+                    return -1;
+                }
+                break;
+        }
+    }
+
+    for (i = 0; i < n; ++i) {
+        displacement = _displacements + 2 * _build->m_bucketOf[i];
+        _slots[(_build->m_first[i] + (displacement[0] * _build->m_step[i]) % n + displacement[1]) % n] = _build->m_pairs[i];
+    }
+    return 0;
+}
+
+/* counting sort of keys by bucket and of buckets by descending size */
+static void _GroupByBucket(FrozenBuild* _build) {
+    size_t* bucketStart = _build->m_bucketStart;
+    size_t* sizeStart;
+    size_t maxSize = 0;
+    size_t size;
+    size_t i;
+
+    memset(bucketStart, 0, (_build->m_numOfBuckets + 1) * sizeof(size_t));
+    for (i = 0; i < _build->m_numOfItems; ++i) {
+        ++bucketStart[_build->m_bucketOf[i] + 1];
+    }
+    for (i = 0; i < _build->m_numOfBuckets; ++i) {
+        maxSize = MAX(maxSize, bucketStart[i + 1]);
+        bucketStart[i + 1] += bucketStart[i];
+    }
+
+    /* m_positions is free here and serves as the fill cursor per bucket */
+    memcpy(_build->m_positions, bucketStart, _build->m_numOfBuckets * sizeof(size_t));
+    for (i = 0; i < _build->m_numOfItems; ++i) {
+        _build->m_keysByBucket[_build->m_positions[_build->m_bucketOf[i]]++] = i;
+    }
+
+    sizeStart = (size_t*)calloc(maxSize + 2, sizeof(size_t));
+    if (NULL == sizeStart) {
+        /* unsorted order still places multi key buckets, just less often on the first seed */
+        for (i = 0; i < _build->m_numOfBuckets; ++i) {
+            _build->m_bucketsBySize[i] = i;
+        }
+        return;
+    }
+
+    for (i = 0; i < _build->m_numOfBuckets; ++i) {
+        size = bucketStart[i + 1] - bucketStart[i];
+        ++sizeStart[maxSize - size + 1];
+    }
+    for (i = 0; i <= maxSize; ++i) {
+        sizeStart[i + 1] += sizeStart[i];
+    }
+    for (i = 0; i < _build->m_numOfBuckets; ++i) {
+        size = bucketStart[i + 1] - bucketStart[i];
+        _build->m_bucketsBySize[sizeStart[maxSize - size]++] = i;
+    }
+    free(sizeStart);
+}
+
+static int _PlaceBucket(FrozenBuild* _build, size_t _bucket, size_t* _displacement) {
+    const size_t* keys = _build->m_keysByBucket + _build->m_bucketStart[_bucket];
+    size_t numOfKeys = _build->m_bucketStart[_bucket + 1] - _build->m_bucketStart[_bucket];
+    size_t n = _build->m_numOfItems;
+    size_t tries = 0;
+    size_t d0;
+    size_t d1;
+    size_t i;
+
+    for (d0 = 0; d0 < n; ++d0) {
+        for (d1 = 0; d1 < n; ++d1) {
+            if (++tries > FROZEN_MAX_TRIES) {
+                return -1;
+            }
+
+            if (_FitsBucket(_build, keys, numOfKeys, d0, d1)) {
+                for (i = 0; i < numOfKeys; ++i) {
+                    _build->m_occupied[_build->m_positions[i]] = 1;
+                }
+                _displacement[0] = d0;
+                _displacement[1] = d1;
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+/* fills m_positions, none zero if every key of the bucket lands on its own free slot */
+static int _FitsBucket(FrozenBuild* _build, const size_t* _keys, size_t _numOfKeys, size_t _d0, size_t _d1) {
+    size_t n = _build->m_numOfItems;
+    size_t position;
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < _numOfKeys; ++i) {
+        position = (_build->m_first[_keys[i]] + (_d0 * _build->m_step[_keys[i]]) % n + _d1) % n;
+        if (_build->m_occupied[position]) {
+            return 0;
+        }
+
+        for (j = 0; j < i; ++j) {
+            if (_build->m_positions[j] == position) {
+                return 0;
+            }
+        }
+        _build->m_positions[i] = position;
+    }
+    return 1;
+}
+
+static int _WriteAligned(FILE* _fp, const void* _data, size_t _size, size_t* _offset) {
+    static const char padding[FROZEN_ALIGN] = {0};
+    size_t pad = (FROZEN_ALIGN - _size % FROZEN_ALIGN) % FROZEN_ALIGN;
+
+    if (0 != _size && 1 != fwrite(_data, _size, 1, _fp)) {
+        return 1;
+    }
+    if (0 != pad && 1 != fwrite(padding, pad, 1, _fp)) {
+        return 1;
+    }
+    *_offset += _size + pad;
+    return 0;
+}
+
+static int _WriteEncoded(FILE* _fp, FrozenEncodeFunction _encode, const void* _item, char** _buffer, size_t* _bufferSize, size_t* _offset) {
+    size_t size = _encode(_item, *_buffer, *_bufferSize);
+    char* bigger;
+
+    if (size > *_bufferSize) {
+        bigger = (char*)realloc(*_buffer, size);
+        if (NULL == bigger) {
+            return 1;
+        }
+        *_buffer = bigger;
+        *_bufferSize = size;
+        if (_encode(_item, *_buffer, *_bufferSize) != size) {
+            return 1;
+        }
+    }
+    return _WriteAligned(_fp, *_buffer, size, _offset);
+}
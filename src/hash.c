@@ -1,78 +1,243 @@
 #include "hash.h"
 #include "list.h"
+#include "hash_internal.h"
+#include "listInternal.h"
 #include <stdlib.h> /*< malloc >*/
+#include <stdio.h> /*< fopen >*/
+#include <time.h> /*< time, clock >*/
+#include <pthread.h> /*< pthread_create >*/
 
 #define INSERT (666)
 #define REMOVE (42)
 
-struct HashMap {
-    List** m_lists;
-    size_t m_capacity;
-    HashFunction m_hashFunc;
-    EqualityFunction m_keysEqualFunc;
-};
+/* a chain longer than this plus twice the load factor is taken for a flood */
+#define HASH_FLOOD_CHAIN (16)
 
-typedef struct Elements {
-    void* m_value;
-    void* m_key;
-} Elements;
+/* a reseed waits for this fraction of the pairs to be inserted since the last one */
+#define HASH_FLOOD_CREDIT (4)
+
+/* the parallel calls use at most this many threads, the build keeps a count per thread pair */
+#define HASH_MAX_THREADS (64)
 
 typedef struct SearchStruct {
     void* m_searchKey;
     EqualityFunction m_keyEqual;
+    HashKeyOf m_keyOf;
+    size_t m_probes;    /*< keys compared so far, the chain length on a miss >*/
 } SearchStruct;
 
 typedef struct ForEachStruct {
+    const HashMap* m_map;
+    size_t m_fromBucket;
+    size_t m_toBucket;
     void* m_context;
     KeyValueActionFunction m_KeyValFunc;
+    int* m_stop;        /*< shared by all ranges of one call >*/
+    size_t m_count;
 } ForEachStruct;
 
-static HashMap* _InitHashMap(HashMap* _hash, List** _pLists, size_t _capacity, HashFunction _hashFunc, EqualityFunction _keysEqualFunc);
+/* one thread of HashMapBuildFromArrays, its pairs are [m_from, m_to) of the input in the
+ * hash and scatter phases and [m_from, m_to) of m_order in the fill phase */
+typedef struct BuildStruct {
+    HashMap* m_map;
+    void* const* m_keys;
+    void* const* m_values;
+    size_t* m_hashes;   /*< shared, hash of every pair >*/
+    size_t* m_order;    /*< shared, pair indices grouped by partition >*/
+    size_t* m_offsets;  /*< per partition count, then next free place in m_order >*/
+    size_t m_numOfParts;
+    size_t m_from;
+    size_t m_to;
+    size_t m_inserted;
+    int m_failed;
+} BuildStruct;
+
 static void _InitMapStats(Map_Stats* _stats, size_t _capacity);
-static size_t _FindNextPrime(size_t _capacity);
 static int _PrimeNumCheck(size_t _n);
 static Elements* _CreateNewPair(const void* _key, const void* _value);
-static ListItr _CalcIndexSearchKey(const HashMap* _map, const void* _key);
+static const void* _PairKey(const void* _item);
 static int _SearchKey(void* _item, void* _context);
-static int _ActionOnPair(void* _item, void* _context);
+static ListItr _ChainFind(const HashMap* _map, const void* _key, size_t _hash, HashKeyOf _keyOf, size_t* _pProbes);
+static void _CheckFlood(HashMap* _map, size_t _hash, size_t _chainLength);
+static void _ReadSeedBase(void);
+static uint64_t _NewSeed(const HashMap* _map);
+static void* _ForEachRange(void* _forEach);
+static size_t _PartOf(const HashMap* _map, size_t _hash, size_t _numOfParts);
+static void* _BuildHash(void* _build);
+static void* _BuildScatter(void* _build);
+static void* _BuildFill(void* _build);
+static void _RunBuildPhase(void* (*_phase)(void*), BuildStruct* _builds, pthread_t* _threads, int* _started);
 static void _DestroyList(List* _list, void (*_keyDestroy)(void* _key), void (*_valDestroy)(void* _value));
 
 static void _CheckMax(size_t* _maxChainLength, size_t _listSize);
 
+/* read from the random device once per process, every seed is derived from it */
+static pthread_once_t s_seedOnce = PTHREAD_ONCE_INIT;
+static uint64_t s_seedBase;
+static uint64_t s_seedCount;
+
 HashMap* HashMapCreate(size_t _capacity, HashFunction _hashFunc, EqualityFunction _keysEqualFunc) {
     HashMap* hash;
-    List** pLists;
-    size_t i;
 
     if (_hashFunc == NULL || _keysEqualFunc == NULL) {
         return NULL;
     }
 
-    _capacity = _FindNextPrime(_capacity);
     hash = (HashMap*)malloc(sizeof(HashMap));
     if (hash == NULL) {
         return NULL;
     }
 
-    pLists = (List**)malloc(_capacity * sizeof(List*));
-    if (NULL == pLists) {
+    if (DS_SUCCESS != HashTableInit(hash, _capacity, _hashFunc, _keysEqualFunc)) {
         free(hash);
         return NULL;
     }
+    return hash;
+}
 
-    for (i = 0; i < _capacity; ++i) {
-        pLists[i] = ListCreate();
-        if (pLists[i] == NULL) {
-            while (i > 0) {
-                free(pLists[--i]);
+HashMap* HashMapCreateSeeded(size_t _capacity, SeededHashFunction _hashFunc, EqualityFunction _keysEqualFunc) {
+    HashMap* hash;
+
+    if (_hashFunc == NULL || _keysEqualFunc == NULL) {
+        return NULL;
+    }
+
+    hash = (HashMap*)malloc(sizeof(HashMap));
+    if (hash == NULL) {
+        return NULL;
+    }
+
+    if (DS_SUCCESS != HashTableInit(hash, _capacity, NULL, _keysEqualFunc)) {
+        free(hash);
+        return NULL;
+    }
+    hash->m_seededHashFunc = _hashFunc;
+    hash->m_seed = _NewSeed(hash);
+    return hash;
+}
+
+size_t HashStringSeeded(const void* _key, uint64_t _seed) {
+    const unsigned char* str = (const unsigned char*)_key;
+    uint64_t hash = HashMix64(_seed ^ HASH_U64(0x9e3779b9, 0x7f4a7c15));
+    uint64_t word = 0;
+    size_t length = 0;
+
+    for (; *str != '\0'; ++str) {
+        word = (word << 8) | *str;
+        if (0 == ++length % sizeof(word)) {
+            hash = HashMix64(hash ^ word);
+            word = 0;
+        }
+    }
+    /* the length ends the string, a trailing zero byte would look like a shorter word */
+    return (size_t)HashMix64(hash ^ word ^ ((uint64_t)length << 56) ^ _seed);
+}
+
+size_t HashSizeTSeeded(const void* _key, uint64_t _seed) {
+    return (size_t)HashMix64(HashMix64((uint64_t)*(const size_t*)_key ^ _seed) ^ _seed);
+}
+
+HashMap* HashMapBuildFromArrays(void* const* _keys, void* const* _values, size_t _numOfPairs, size_t _numOfThreads,
+                                HashFunction _hashFunc, EqualityFunction _keysEqualFunc) {
+    HashMap* map;
+    BuildStruct* builds;
+    pthread_t* threads;
+    int* started;
+    size_t* offsets;
+    size_t* partBegin;
+    size_t place = 0;
+    size_t count;
+    size_t part;
+    size_t i;
+    int failed = 0;
+
+    if (_keys == NULL || _values == NULL || _numOfThreads == 0
+        || _numOfPairs > ((size_t)-1) / 2 / sizeof(size_t) - 1) {
+        return NULL;
+    }
+
+    map = HashMapCreate(_numOfPairs, _hashFunc, _keysEqualFunc);
+    if (map == NULL) {
+        return NULL;
+    }
+
+    if (_numOfThreads > HASH_MAX_THREADS) {
+        _numOfThreads = HASH_MAX_THREADS;
+    }
+    if (_numOfThreads > map->m_capacity) {
+        _numOfThreads = map->m_capacity;
+    }
+
+    builds = (BuildStruct*)malloc(_numOfThreads * (sizeof(BuildStruct) + sizeof(pthread_t) + sizeof(int)
+                                                   + (_numOfThreads + 1) * sizeof(size_t)));
+    if (builds == NULL) {
+        HashMapDestroy(&map, NULL, NULL);
+        return NULL;
+    }
+    threads = (pthread_t*)(builds + _numOfThreads);
+    offsets = (size_t*)(threads + _numOfThreads);
+    partBegin = offsets + _numOfThreads * _numOfThreads;
+    started = (int*)(partBegin + _numOfThreads);
+
+    builds[0].m_hashes = (size_t*)malloc((_numOfPairs + 1) * 2 * sizeof(size_t));
+    if (builds[0].m_hashes == NULL) {
+        free(builds);
+        HashMapDestroy(&map, NULL, NULL);
+        return NULL;
+    }
+
+    for (i = 0; i < _numOfThreads; ++i) {
+        builds[i].m_map = map;
+        builds[i].m_keys = _keys;
+        builds[i].m_values = _values;
+        builds[i].m_hashes = builds[0].m_hashes;
+        builds[i].m_order = builds[0].m_hashes + _numOfPairs;
+        builds[i].m_offsets = offsets + i * _numOfThreads;
+        builds[i].m_numOfParts = _numOfThreads;
+        builds[i].m_from = _numOfPairs * i / _numOfThreads;
+        builds[i].m_to = _numOfPairs * (i + 1) / _numOfThreads;
+        builds[i].m_inserted = 0;
+        builds[i].m_failed = 0;
+    }
+
+    _RunBuildPhase(_BuildHash, builds, threads, started);
+    for (i = 0; i < _numOfThreads; ++i) {
+        failed |= builds[i].m_failed;
+    }
+
+    if (!failed) {
+        /* partition major, thread minor: every thread scatters its pairs in input order after the pairs
+         * of the threads before it, so each partition lists its pairs in input order */
+        for (part = 0; part < _numOfThreads; ++part) {
+            partBegin[part] = place;
+            for (i = 0; i < _numOfThreads; ++i) {
+                count = builds[i].m_offsets[part];
+                builds[i].m_offsets[part] = place;
+                place += count;
             }
-            free(hash);
-            free(pLists);
-            return NULL;
         }
+        _RunBuildPhase(_BuildScatter, builds, threads, started);
+
+        for (part = 0; part < _numOfThreads; ++part) {
+            builds[part].m_from = partBegin[part];
+            builds[part].m_to = (part + 1 < _numOfThreads) ? partBegin[part + 1] : _numOfPairs;
+        }
+        _RunBuildPhase(_BuildFill, builds, threads, started);
     }
 
-    return _InitHashMap(hash, pLists, _capacity, _hashFunc, _keysEqualFunc);
+    for (i = 0; i < _numOfThreads; ++i) {
+        failed |= builds[i].m_failed;
+        map->m_size += builds[i].m_inserted;
+    }
+    /* every pair counts towards the next flood check as if inserted one by one */
+    map->m_floodCredit = map->m_size;
+    free(builds[0].m_hashes);
+    free(builds);
+
+    if (failed) {
+        HashMapDestroy(&map, NULL, NULL);
+    }
+    return map;
 }
 
 void HashMapDestroy(HashMap** _map, void (*_keyDestroy)(void* _key),
@@ -84,27 +249,56 @@ void HashMapDestroy(HashMap** _map, void (*_keyDestroy)(void* _key),
 
     for (i = (*_map)->m_capacity; i > 0; --i) {
         _DestroyList((*_map)->m_lists[i - 1], _keyDestroy, _valDestroy);
-        ListDestroy(&((*_map)->m_lists[i - 1]), NULL);
     }
-    free((*_map)->m_lists);
+    HashChainsDestroy((*_map)->m_lists, (*_map)->m_capacity);
     free(*_map);
     *_map = NULL;
 }
 
 aps_ds_error HashMapRehash(HashMap* _map, size_t newCapacity) {
-    List** tempList;
-    newCapacity = _FindNextPrime(newCapacity);
-    tempList = (List**)realloc(_map->m_lists, newCapacity * sizeof(List*));
-    if (tempList == NULL) {
+    List** oldLists;
+    List** newLists;
+    size_t oldCapacity;
+    size_t idx;
+    List* chain;
+    List* target;
+    Node* node;
+
+    if (_map == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    newCapacity = HashNextPrime(newCapacity);
+    newLists = HashChainsCreate(newCapacity);
+    if (newLists == NULL) {
         return DS_ALLOCATION_ERROR;
     }
-    _map->m_lists = tempList;
+
+    oldLists = _map->m_lists;
+    oldCapacity = _map->m_capacity;
+    _map->m_lists = newLists;
+    _map->m_capacity = newCapacity;
+
+    /* the nodes are relinked, no pair is allocated or freed */
+    for (idx = 0; idx < oldCapacity; ++idx) {
+        chain = oldLists[idx];
+        while (chain->m_head.m_next != &chain->m_tail) {
+            node = chain->m_head.m_next;
+            PopNode(&chain->m_head, node->m_next);
+            target = newLists[HashBucketOf(_map, HashKeyHash(_map, ((Elements*)node->m_item)->m_key))];
+            PushNode(target->m_tail.m_prev, node);
+        }
+    }
+    HashChainsDestroy(oldLists, oldCapacity);
+    ++_map->m_rehashCount;
     return DS_SUCCESS;
 }
 
 aps_ds_error HashMapInsert(HashMap* _map, const void* _key, const void* _value) {
     ListItr itr;
     Elements* elements;
+    size_t hash;
+    size_t chainLength;
 
     if (_map == NULL || _value == NULL) {
         return DS_UNINITIALIZED_ERROR;
@@ -114,7 +308,8 @@ aps_ds_error HashMapInsert(HashMap* _map, const void* _key, const void* _value)
         return DS_INVALID_PARAM_ERROR;
     }
 
-    itr = _CalcIndexSearchKey(_map, _key);
+    hash = HashKeyHash(_map, _key);
+    itr = _ChainFind(_map, _key, hash, _PairKey, &chainLength);
     if (itr != ListItr_Next(itr)) {
         return DS_KEY_EXISTS_ERROR;
     }
@@ -126,9 +321,16 @@ aps_ds_error HashMapInsert(HashMap* _map, const void* _key, const void* _value)
 
     itr = ListItr_InsertBefore(itr, elements);
     if (itr == NULL) {
+        free(elements);
         return DS_ALLOCATION_ERROR;
     }
 
+    if (_map->m_bloom != NULL) {
+        BloomAdd(_map->m_bloom, hash);
+    }
+    ++_map->m_size;
+    ++_map->m_floodCredit;
+    _CheckFlood(_map, hash, chainLength + 1);
     return DS_SUCCESS;
 }
 
@@ -145,7 +347,7 @@ aps_ds_error HashMapRemove(HashMap* _map, const void* _searchKey, void** _pKey,
         return DS_INVALID_PARAM_ERROR;
     }
 
-    itr = _CalcIndexSearchKey(_map, _searchKey);
+    itr = HashChainFind(_map, _searchKey, HashKeyHash(_map, _searchKey), _PairKey);
     if (itr == ListItr_Next(itr)) {
         return DS_ELEMENT_NOT_FOUND_ERROR;
     }
@@ -154,6 +356,7 @@ aps_ds_error HashMapRemove(HashMap* _map, const void* _searchKey, void** _pKey,
     *_pValue = elements->m_value;
     *_pKey = elements->m_key;
     free(elements);
+    --_map->m_size;
     return DS_SUCCESS;
 }
 
@@ -161,6 +364,7 @@ aps_ds_error HashMapFind(const HashMap* _map, const void* __searchKey,
                        void** _pValue) {
     ListItr itr;
     Elements* elements;
+    size_t hash;
 
     if (_map == NULL || _pValue == NULL) {
         return DS_UNINITIALIZED_ERROR;
@@ -170,7 +374,12 @@ aps_ds_error HashMapFind(const HashMap* _map, const void* __searchKey,
         return DS_INVALID_PARAM_ERROR;
     }
 
-    itr = _CalcIndexSearchKey(_map, __searchKey);
+    hash = HashKeyHash(_map, __searchKey);
+    if (_map->m_bloom != NULL && !BloomMayContain(_map->m_bloom, hash)) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    itr = HashChainFind(_map, __searchKey, hash, _PairKey);
 
     if (itr == ListItr_Next(itr)) {
         return DS_ELEMENT_NOT_FOUND_ERROR;
@@ -181,57 +390,178 @@ aps_ds_error HashMapFind(const HashMap* _map, const void* __searchKey,
     return DS_SUCCESS;
 }
 
+aps_ds_error HashMapAttachBloom(HashMap* _map, Bloom* _bloom) {
+    HashMapItr itr;
+
+    if (_map == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    for (itr = HashMapItrBegin(_map); _bloom != NULL && !HashMapItrIsEnd(itr); itr = HashMapItrNext(itr)) {
+        BloomAdd(_bloom, HashKeyHash(_map, HashMapItrKey(itr)));
+    }
+    _map->m_bloom = _bloom;
+    return DS_SUCCESS;
+}
+
 size_t HashMapSize(const HashMap* _map) {
     if (_map == NULL) {
         return 0;
     }
-    return _map->m_capacity;
+    return _map->m_size;
 }
 
 size_t HashMapForEach(const HashMap* _map, KeyValueActionFunction _action,
                       void* _context) {
-    size_t idx;
-    ListItr itr;
-    ListItr begin;
-    ListItr end;
-    ForEachStruct sForEach;
-    if (_map == NULL || _action == NULL) {
-        return DS_UNINITIALIZED_ERROR;
+    return HashMapForEachParallel(_map, 1, _action, _context);
+}
+
+size_t HashMapForEachParallel(const HashMap* _map, size_t _numOfThreads,
+                              KeyValueActionFunction _action, void* _context) {
+    ForEachStruct* ranges;
+    pthread_t* threads;
+    int* started;
+    int stop = 0;
+    size_t count = 0;
+    size_t i;
+
+    if (_map == NULL || _action == NULL || _numOfThreads == 0) {
+        return 0;
+    }
+
+    if (_numOfThreads > HASH_MAX_THREADS) {
+        _numOfThreads = HASH_MAX_THREADS;
+    }
+    if (_numOfThreads > _map->m_capacity) {
+        _numOfThreads = _map->m_capacity;
+    }
+
+    ranges = (ForEachStruct*)malloc(_numOfThreads * (sizeof(ForEachStruct) + sizeof(pthread_t) + sizeof(int)));
+    if (ranges == NULL) {
+        _numOfThreads = 1;
+        ranges = (ForEachStruct*)malloc(sizeof(ForEachStruct) + sizeof(pthread_t) + sizeof(int));
+        if (ranges == NULL) {
+            return 0;
+        }
+    }
+    threads = (pthread_t*)(ranges + _numOfThreads);
+    started = (int*)(threads + _numOfThreads);
+
+    for (i = 0; i < _numOfThreads; ++i) {
+        ranges[i].m_map = _map;
+        ranges[i].m_fromBucket = _map->m_capacity * i / _numOfThreads;
+        ranges[i].m_toBucket = _map->m_capacity * (i + 1) / _numOfThreads;
+        ranges[i].m_context = _context;
+        ranges[i].m_KeyValFunc = _action;
+        ranges[i].m_stop = &stop;
+        ranges[i].m_count = 0;
     }
 
-    sForEach.m_context = _context;
-    sForEach.m_KeyValFunc = _action;
-    for (idx = 0; idx < _map->m_capacity; ++idx) {
-        begin = ListItr_Begin(_map->m_lists[idx]);
-        end = ListItr_End(_map->m_lists[idx]);
-        itr = ListItr_ForEach(begin, end, _ActionOnPair, &sForEach);
-        if (end != itr) {
-            return idx;
+    /* the calling thread takes the first range and any range a thread could not be started for */
+    for (i = 1; i < _numOfThreads; ++i) {
+        started[i] = (0 == pthread_create(&threads[i], NULL, _ForEachRange, &ranges[i]));
+    }
+    _ForEachRange(&ranges[0]);
+    for (i = 1; i < _numOfThreads; ++i) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            _ForEachRange(&ranges[i]);
+        }
+    }
+
+    for (i = 0; i < _numOfThreads; ++i) {
+        count += ranges[i].m_count;
+    }
+    free(ranges);
+    return count;
+}
+
+HashMapItr HashMapItrBegin(const HashMap* _map) {
+    HashMapItr itr;
+    itr.m_map = _map;
+    itr.m_bucket = 0;
+    itr.m_node = NULL;
+    if (_map == NULL) {
+        return itr;
+    }
+    return HashMapItrSeekBucket(itr);
+}
+
+/* moves _itr to the first pair at or after its bucket */
+HashMapItr HashMapItrSeekBucket(HashMapItr _itr) {
+    Node* node;
+    for (; _itr.m_bucket < _itr.m_map->m_capacity; ++_itr.m_bucket) {
+        node = _itr.m_map->m_lists[_itr.m_bucket]->m_head.m_next;
+        if (node != node->m_next) {
+            _itr.m_node = node;
+            return _itr;
         }
     }
-    return idx;
+    _itr.m_node = NULL;
+    return _itr;
 }
 
 Map_Stats HashMapGetStatistics(const HashMap* _map) {
+    if (_map == NULL) {
+        return HashMapSampleStatistics(NULL, 0);
+    }
+    return HashMapSampleStatistics(_map, _map->m_capacity);
+}
+
+Map_Stats HashMapSampleStatistics(const HashMap* _map, size_t _numOfSamples) {
     Map_Stats stats;
     size_t idx;
-    ListItr begin;
-    ListItr end;
+    size_t i;
     size_t sumAllLength = 0;
+    size_t sumAllProbes = 0;
     size_t tempListSize;
+    double scale;
+
+    _InitMapStats(&stats, 0);
+    if (_map == NULL) {
+        return stats;
+    }
 
-    _InitMapStats(&stats, _map->m_capacity);
-    for (idx = 0; idx < _map->m_capacity; ++idx) {
-        begin = ListItr_Begin(_map->m_lists[idx]);
-        end = ListItr_End(_map->m_lists[idx]);
-        if (end != begin) {
+    stats.numberOfBuckets = _map->m_capacity;
+    if (_numOfSamples == 0 || _numOfSamples > _map->m_capacity) {
+        _numOfSamples = _map->m_capacity;
+    }
+
+    for (i = 0; i < _numOfSamples; ++i) {
+        idx = _map->m_capacity * i / _numOfSamples;
+        tempListSize = ListSize(_map->m_lists[idx]);
+        ++stats.chainLengthHistogram[(tempListSize < MAP_STATS_HISTOGRAM_SIZE) ? tempListSize : MAP_STATS_HISTOGRAM_SIZE - 1];
+        if (tempListSize != 0) {
             ++(stats.numberOfChains);
-            tempListSize = ListSize(_map->m_lists[idx]);
             _CheckMax(&(stats.maxChainLength), tempListSize);
             sumAllLength += tempListSize;
+            /* the k-th key of a chain is found after k compares */
+            sumAllProbes += tempListSize * (tempListSize + 1) / 2;
         }
     }
-    stats.averageChainLength = sumAllLength / (stats.numberOfChains);
+
+    if (stats.numberOfChains != 0) {
+        stats.averageChainLength = sumAllLength / stats.numberOfChains;
+        stats.expectedProbesHit = (double)sumAllProbes / (double)sumAllLength;
+    }
+    /* a failed find compares against the whole chain of its bucket */
+    stats.expectedProbesMiss = (double)sumAllLength / (double)_numOfSamples;
+
+    if (_numOfSamples != _map->m_capacity) {
+        scale = (double)_map->m_capacity / (double)_numOfSamples;
+        stats.numberOfChains = (size_t)(stats.numberOfChains * scale + 0.5);
+        for (i = 0; i < MAP_STATS_HISTOGRAM_SIZE; ++i) {
+            stats.chainLengthHistogram[i] = (size_t)(stats.chainLengthHistogram[i] * scale + 0.5);
+        }
+    }
+
+    stats.numberOfItems = _map->m_size;
+    stats.loadFactor = (double)_map->m_size / (double)_map->m_capacity;
+    stats.numberOfRehashes = _map->m_rehashCount;
+    stats.numberOfFloodWarnings = _map->m_floodWarnings;
+    stats.bytesAllocated = sizeof(HashMap) + _map->m_capacity * (sizeof(List*) + sizeof(List))
+                         + _map->m_size * (sizeof(Node) + sizeof(Elements));
     return stats;
 }
 
@@ -241,11 +571,110 @@ static void _CheckMax(size_t* _maxChainLength, size_t _listSize) {
     }
 }
 
-static int _ActionOnPair(void* _item, void* _context) {
-    ForEachStruct* sForEach = _context;
-    Elements* element = _item;
-    return sForEach->m_KeyValFunc(element->m_key, element->m_value,
-                                  sForEach->m_context);
+/* walks the chains of one bucket range, the tail sentinel of a chain points at itself */
+static void* _ForEachRange(void* _forEach) {
+    ForEachStruct* range = _forEach;
+    Elements* element;
+    Node* node;
+    size_t idx;
+
+    for (idx = range->m_fromBucket; idx < range->m_toBucket; ++idx) {
+        if (__atomic_load_n(range->m_stop, __ATOMIC_RELAXED)) {
+            return NULL;
+        }
+
+        for (node = range->m_map->m_lists[idx]->m_head.m_next; node != node->m_next; node = node->m_next) {
+            element = node->m_item;
+            ++range->m_count;
+            if (range->m_KeyValFunc(element->m_key, element->m_value, range->m_context) == 0) {
+                __atomic_store_n(range->m_stop, 1, __ATOMIC_RELAXED);
+                return NULL;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* partitions are contiguous bucket ranges of about equal size */
+static size_t _PartOf(const HashMap* _map, size_t _hash, size_t _numOfParts) {
+    return (size_t)((uint64_t)HashBucketOf(_map, _hash) * _numOfParts / _map->m_capacity);
+}
+
+static void* _BuildHash(void* _build) {
+    BuildStruct* build = (BuildStruct*)_build;
+    size_t i;
+
+    for (i = 0; i < build->m_numOfParts; ++i) {
+        build->m_offsets[i] = 0;
+    }
+
+    for (i = build->m_from; i < build->m_to; ++i) {
+        if (build->m_keys[i] == NULL || build->m_values[i] == NULL) {
+            build->m_failed = 1;
+            return NULL;
+        }
+        build->m_hashes[i] = HashKeyHash(build->m_map, build->m_keys[i]);
+        ++build->m_offsets[_PartOf(build->m_map, build->m_hashes[i], build->m_numOfParts)];
+    }
+    return NULL;
+}
+
+static void* _BuildScatter(void* _build) {
+    BuildStruct* build = (BuildStruct*)_build;
+    size_t i;
+
+    for (i = build->m_from; i < build->m_to; ++i) {
+        build->m_order[build->m_offsets[_PartOf(build->m_map, build->m_hashes[i], build->m_numOfParts)]++] = i;
+    }
+    return NULL;
+}
+
+/* only the buckets of this partition are touched, no two threads share a chain */
+static void* _BuildFill(void* _build) {
+    BuildStruct* build = (BuildStruct*)_build;
+    ListItr itr;
+    Elements* elements;
+    size_t pair;
+    size_t i;
+
+    for (i = build->m_from; i < build->m_to; ++i) {
+        pair = build->m_order[i];
+        itr = HashChainFind(build->m_map, build->m_keys[pair], build->m_hashes[pair], _PairKey);
+        if (itr != ListItr_Next(itr)) {
+            continue;
+        }
+
+        elements = _CreateNewPair(build->m_keys[pair], build->m_values[pair]);
+        if (elements == NULL) {
+            build->m_failed = 1;
+            return NULL;
+        }
+
+        if (ListItr_InsertBefore(itr, elements) == NULL) {
+            free(elements);
+            build->m_failed = 1;
+            return NULL;
+        }
+        ++build->m_inserted;
+    }
+    return NULL;
+}
+
+/* the calling thread takes the first build and any build a thread could not be started for */
+static void _RunBuildPhase(void* (*_phase)(void*), BuildStruct* _builds, pthread_t* _threads, int* _started) {
+    size_t i;
+
+    for (i = 1; i < _builds[0].m_numOfParts; ++i) {
+        _started[i] = (0 == pthread_create(&_threads[i], NULL, _phase, &_builds[i]));
+    }
+    _phase(&_builds[0]);
+    for (i = 1; i < _builds[0].m_numOfParts; ++i) {
+        if (_started[i]) {
+            pthread_join(_threads[i], NULL);
+        } else {
+            _phase(&_builds[i]);
+        }
+    }
 }
 
 static Elements* _CreateNewPair(const void* _key, const void* _value) {
@@ -260,32 +689,152 @@ static Elements* _CreateNewPair(const void* _key, const void* _value) {
     return elements;
 }
 
-static ListItr _CalcIndexSearchKey(const HashMap* _map, const void* _key) {
+aps_ds_error HashTableInit(HashMap* _map, size_t _capacity, HashFunction _hashFunc, EqualityFunction _keysEqualFunc) {
+    _map->m_capacity = HashNextPrime(_capacity);
+    _map->m_lists = HashChainsCreate(_map->m_capacity);
+    if (NULL == _map->m_lists) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    _map->m_size = 0;
+    _map->m_rehashCount = 0;
+    _map->m_hashFunc = _hashFunc;
+    _map->m_seededHashFunc = NULL;
+    _map->m_keysEqualFunc = _keysEqualFunc;
+    _map->m_bloom = NULL;
+    _map->m_seed = 0;
+    _map->m_floodCredit = 0;
+    _map->m_floodWarnings = 0;
+
+    /* the random device is read here, never on the insert path */
+    pthread_once(&s_seedOnce, _ReadSeedBase);
+    return DS_SUCCESS;
+}
+
+List** HashChainsCreate(size_t _capacity) {
+    List** pLists;
+    size_t i;
+
+    pLists = (List**)malloc(_capacity * sizeof(List*));
+    if (NULL == pLists) {
+        return NULL;
+    }
+
+    for (i = 0; i < _capacity; ++i) {
+        pLists[i] = ListCreate();
+        if (pLists[i] == NULL) {
+            HashChainsDestroy(pLists, i);
+            return NULL;
+        }
+    }
+    return pLists;
+}
+
+void HashChainsDestroy(List** _lists, size_t _capacity) {
+    while (_capacity > 0) {
+        ListDestroy(&_lists[--_capacity], NULL);
+    }
+    free(_lists);
+}
+
+ListItr HashChainFind(const HashMap* _map, const void* _key, size_t _hash, HashKeyOf _keyOf) {
+    size_t probes;
+    return _ChainFind(_map, _key, _hash, _keyOf, &probes);
+}
+
+static ListItr _ChainFind(const HashMap* _map, const void* _key, size_t _hash, HashKeyOf _keyOf, size_t* _pProbes) {
     size_t idx;
     ListItr itr;
     ListItr begin;
     ListItr end;
     SearchStruct search;
 
-    idx = _map->m_hashFunc(_key);
+    idx = HashBucketOf(_map, _hash);
     begin = ListItr_Begin(_map->m_lists[idx]);
     end = ListItr_End(_map->m_lists[idx]);
 
     search.m_searchKey = (void*)_key;
     search.m_keyEqual = _map->m_keysEqualFunc;
+    search.m_keyOf = _keyOf;
+    search.m_probes = 0;
 
     itr = ListItr_FindFirst(begin, end, _SearchKey, &search);
 
+    *_pProbes = search.m_probes;
     return itr;
 }
 
+/* a chain far above the load factor means the keys were picked to collide: a fresh seed scatters
+ * them again. A chain made mostly of the key's own hash is only counted as a warning, no seed mixed
+ * in after the hash tells those keys apart. A reseed or a warning waits for a quarter of the pairs to be inserted since the
+ * last one, which keeps the rehash cost amortized O(1). A seeded map needs no check */
+static void _CheckFlood(HashMap* _map, size_t _hash, size_t _chainLength) {
+    List* chain;
+    Node* node;
+    size_t sameHash = 0;
+    size_t capacity;
+
+    if (_map->m_seededHashFunc != NULL
+        || _chainLength <= HASH_FLOOD_CHAIN + 2 * (_map->m_size / _map->m_capacity)
+        || _map->m_floodCredit * HASH_FLOOD_CREDIT < _map->m_size) {
+        return;
+    }
+
+    chain = _map->m_lists[HashBucketOf(_map, _hash)];
+    for (node = chain->m_head.m_next; node != node->m_next; node = node->m_next) {
+        sameHash += (_map->m_hashFunc(((Elements*)node->m_item)->m_key) == _hash);
+    }
+    _map->m_floodCredit = 0;
+    if (2 * sameHash > _chainLength) {
+        ++_map->m_floodWarnings;
+        return;
+    }
+
+    _map->m_seed = _NewSeed(_map);
+    capacity = (_map->m_size > _map->m_capacity) ? _map->m_size : _map->m_capacity;
+    if (HashMapRehash(_map, capacity) != DS_SUCCESS) {
+        /* no memory to grow, scatter the pairs over the buckets there are */
+        HashMapRehash(_map, _map->m_capacity);
+    }
+}
+
+static void _ReadSeedBase(void) {
+    FILE* random = fopen("/dev/urandom", "rb");
+
+    if (random != NULL) {
+        if (fread(&s_seedBase, sizeof(s_seedBase), 1, random) != 1) {
+            s_seedBase = 0;
+        }
+        fclose(random);
+    }
+
+    /* no random device, the clocks are the best guess there is */
+    s_seedBase ^= HashMix64((uint64_t)time(NULL) ^ ((uint64_t)clock() << 32));
+}
+
+/* a different seed for every call, derived from the process base without any I/O */
+static uint64_t _NewSeed(const HashMap* _map) {
+    uint64_t count = __sync_fetch_and_add(&s_seedCount, 1);
+    uint64_t seed = HashMix64(s_seedBase ^ HashMix64(count ^ ((uint64_t)(size_t)_map << 16) ^ _map->m_seed));
+    return (seed != 0) ? seed : 1;
+}
+
+static const void* _PairKey(const void* _item) {
+    return ((const Elements*)_item)->m_key;
+}
+
 static int _SearchKey(void* _item, void* _context) {
     SearchStruct* search = _context;
-    Elements* element = _item;
-    return !(search->m_keyEqual(search->m_searchKey, element->m_key));
+    const void* key = (NULL == search->m_keyOf) ? _item : search->m_keyOf(_item);
+    ++search->m_probes;
+    return !(search->m_keyEqual(search->m_searchKey, key));
 }
 
-static size_t _FindNextPrime(size_t _capacity) {
+size_t HashNextPrime(size_t _capacity) {
+    if (_capacity < 2) {
+        return 2;
+    }
+
     while (_PrimeNumCheck(_capacity) != 0) {
         ++_capacity;
     }
@@ -294,7 +843,7 @@ static size_t _FindNextPrime(size_t _capacity) {
 
 static int _PrimeNumCheck(size_t _n) {
     size_t i;
-    for (i = 2; i <= _n / 2; ++i) {
+    for (i = 2; i * i <= _n; ++i) {
         if (_n % i == 0) {
             return 1;
         }
@@ -320,19 +869,20 @@ static void _DestroyList(List* _list, void (*_keyDestroy)(void* _key),
     }
 }
 
-static HashMap* _InitHashMap(HashMap* _hash, List** _pLists, size_t _capacity,
-                             HashFunction _hashFunc,
-                             EqualityFunction _keysEqualFunc) {
-    _hash->m_lists = _pLists;
-    _hash->m_capacity = _capacity;
-    _hash->m_hashFunc = _hashFunc;
-    _hash->m_keysEqualFunc = _keysEqualFunc;
-    return _hash;
-}
-
 static void _InitMapStats(Map_Stats* _stats, size_t _capacity) {
+    size_t i;
     _stats->numberOfBuckets = _capacity;
     _stats->numberOfChains = 0;
     _stats->maxChainLength = 0;
     _stats->averageChainLength = 0;
+    _stats->numberOfItems = 0;
+    _stats->loadFactor = 0;
+    _stats->expectedProbesHit = 0;
+    _stats->expectedProbesMiss = 0;
+    _stats->bytesAllocated = 0;
+    _stats->numberOfRehashes = 0;
+    _stats->numberOfFloodWarnings = 0;
+    for (i = 0; i < MAP_STATS_HISTOGRAM_SIZE; ++i) {
+        _stats->chainLengthHistogram[i] = 0;
+    }
 }
@@ -0,0 +1,117 @@
+#ifndef __HASH_INTERNAL_H__
+#define __HASH_INTERNAL_H__
+
+#include "hash.h"
+#include "list.h"
+#include "bloom.h"
+#include <stddef.h> /*< size_t >*/
+#include <stdint.h> /*< uint64_t >*/
+
+/* HashMap chains Elements pairs, HashSet chains the keys themselves */
+struct HashMap {
+    List** m_lists;     /*< one chain per bucket >*/
+    size_t m_capacity;  /*< number of buckets, prime >*/
+    size_t m_size;      /*< number of pairs >*/
+    size_t m_rehashCount;
+    HashFunction m_hashFunc;                /*< NULL when the map hashes with m_seededHashFunc >*/
+    SeededHashFunction m_seededHashFunc;    /*< NULL when the map hashes with m_hashFunc >*/
+    EqualityFunction m_keysEqualFunc;
+    Bloom* m_bloom;     /*< optional filter of all inserted key hashes, not owned >*/
+    uint64_t m_seed;    /*< secret of a seeded map, drawn at create. Otherwise 0 until a flood is
+                            detected, then mixed into every hash before it picks a bucket >*/
+    size_t m_floodCredit; /*< pairs inserted since the last reseed or flood warning >*/
+    size_t m_floodWarnings; /*< floods of fully equal hashes that no reseed could split >*/
+};
+
+/**
+ * @brief  find the nearest prime number greater or equal to _capacity
+ * @param _capacity : requested number of buckets
+ * @returns  : prime number of buckets, never smaller than 2
+ */
+size_t HashNextPrime(size_t _capacity);
+
+/**
+ * @brief  get the key of an item stored in a chain
+ * @param _item : item stored in the chain
+ * @returns  : the key of the item
+ */
+typedef const void* (*HashKeyOf)(const void* _item);
+
+/**
+ * @brief  set up an empty table, every field of HashMap is initialized here
+ * @param _map : table to initialize, HashSet and HashMultiMap embed one
+ * @param _capacity : requested number of buckets, rounded up to a prime
+ * @param _hashFunc : hashing function for keys
+ * @param _keysEqualFunc : equality check function for keys
+ * @returns  : DS_SUCCESS or DS_ALLOCATION_ERROR, nothing is left allocated on failure
+ */
+aps_ds_error HashTableInit(HashMap* _map, size_t _capacity, HashFunction _hashFunc, EqualityFunction _keysEqualFunc);
+
+/**
+ * @brief  allocate _capacity empty chains
+ * @param _capacity : number of buckets
+ * @returns  : array of chains or NULL if an allocation failed
+ */
+List** HashChainsCreate(size_t _capacity);
+
+/**
+ * @brief  free the chains and the array, items still in the chains are not touched
+ * @param _lists : chains returned by HashChainsCreate
+ * @param _capacity : number of buckets
+ */
+void HashChainsDestroy(List** _lists, size_t _capacity);
+
+/**
+ * @brief  find the item with _key in its bucket
+ * @param _map : table to search, HashSet shares the HashMap layout
+ * @param _key : key to search for
+ * @param _hash : value of the map hash function for _key
+ * @param _keyOf : extracts the key of a stored item, NULL if the items are the keys themselves
+ * @returns  : iterator to the item or the end of the bucket if not found
+ */
+ListItr HashChainFind(const HashMap* _map, const void* _key, size_t _hash, HashKeyOf _keyOf);
+
+/* 64 bit constants built from two halves, C89 has no long long literals */
+#define HASH_U64(hi, lo) (((uint64_t)(hi) << 32) | (uint64_t)(lo))
+
+/**
+ * @brief  murmur3 finalizer, spreads every input bit over the whole word
+ * @param _x : value to mix
+ * @returns  : mixed value
+ */
+static __inline__ uint64_t HashMix64(uint64_t _x) {
+    _x ^= _x >> 33;
+    _x *= HASH_U64(0xff51afd7, 0xed558ccd);
+    _x ^= _x >> 33;
+    _x *= HASH_U64(0xc4ceb9fe, 0x1a85ec53);
+    _x ^= _x >> 33;
+    return _x;
+}
+
+/**
+ * @brief  hash of a key with the map's own hash function, a seeded one gets the map's seed
+ * @param _map : table the key belongs to
+ * @param _key : key to hash
+ * @returns  : hash of the key
+ */
+static __inline__ size_t HashKeyHash(const HashMap* _map, const void* _key) {
+    if (_map->m_seededHashFunc != NULL) {
+        return _map->m_seededHashFunc(_key, _map->m_seed);
+    }
+    return _map->m_hashFunc(_key);
+}
+
+/**
+ * @brief  bucket of a hash, the raw hash modulo the capacity until a plain map is reseeded
+ * @param _map : table the bucket belongs to
+ * @param _hash : value of the map hash function for some key
+ * @returns  : bucket index
+ */
+static __inline__ size_t HashBucketOf(const HashMap* _map, size_t _hash) {
+    if (_map->m_seed != 0 && _map->m_seededHashFunc == NULL) {
+        _hash = (size_t)HashMix64((uint64_t)_hash ^ _map->m_seed);
+    }
+    return _hash % _map->m_capacity;
+}
+
+#endif /* __HASH_INTERNAL_H__ */
@@ -0,0 +1,226 @@
+#include "hash_multi_map.h"
+#include "list.h"
+#include "list_itr.h"
+#include "hash_internal.h"
+#include <stdlib.h> /*< malloc >*/
+
+#define MULTI_FIRST_CAPACITY (1)
+
+/* the values array follows the header in the same allocation */
+typedef struct MultiGroup {
+    void* m_key;
+    size_t m_count;
+    size_t m_capacity;
+} MultiGroup;
+
+struct HashMultiMap {
+    HashMap m_table;    /*< chains hold MultiGroup, m_size counts the distinct keys >*/
+    size_t m_values;
+};
+
+static const void* _GroupKey(const void* _group);
+static void** _GroupValues(MultiGroup* _group);
+static MultiGroup* _FindGroup(const HashMultiMap* _map, const void* _key);
+static MultiGroup* _CreateGroup(const void* _key);
+static MultiGroup* _GrowGroup(MultiGroup* _group);
+static void _DestroyGroup(MultiGroup* _group, void (*_keyDestroy)(void* _key), void (*_valDestroy)(void* _value));
+
+HashMultiMap* HashMultiMapCreate(size_t _capacity, HashFunction _hashFunc, EqualityFunction _keysEqualFunc) {
+    HashMultiMap* map;
+
+    if (_hashFunc == NULL || _keysEqualFunc == NULL) {
+        return NULL;
+    }
+
+    map = (HashMultiMap*)malloc(sizeof(HashMultiMap));
+    if (map == NULL) {
+        return NULL;
+    }
+
+    if (DS_SUCCESS != HashTableInit(&map->m_table, _capacity, _hashFunc, _keysEqualFunc)) {
+        free(map);
+        return NULL;
+    }
+    map->m_values = 0;
+    return map;
+}
+
+void HashMultiMapDestroy(HashMultiMap** _map, void (*_keyDestroy)(void* _key), void (*_valDestroy)(void* _value)) {
+    size_t i;
+    void* group;
+
+    if (_map == NULL || *_map == NULL) {
+        return;
+    }
+
+    for (i = 0; i < (*_map)->m_table.m_capacity; ++i) {
+        while (ListPopHead((*_map)->m_table.m_lists[i], &group) == DS_SUCCESS) {
+            _DestroyGroup(group, _keyDestroy, _valDestroy);
+        }
+    }
+    HashChainsDestroy((*_map)->m_table.m_lists, (*_map)->m_table.m_capacity);
+    free(*_map);
+    *_map = NULL;
+}
+
+aps_ds_error HashMultiMapInsertMulti(HashMultiMap* _map, const void* _key, const void* _value) {
+    ListItr itr;
+    MultiGroup* group;
+
+    if (_map == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_key == NULL) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    itr = HashChainFind(&_map->m_table, _key, HashKeyHash(&_map->m_table, _key), _GroupKey);
+    if (itr == ListItr_Next(itr)) {
+        group = _CreateGroup(_key);
+        if (group == NULL) {
+            return DS_ALLOCATION_ERROR;
+        }
+
+        if (ListItr_InsertBefore(itr, group) == NULL) {
+            free(group);
+            return DS_ALLOCATION_ERROR;
+        }
+        ++_map->m_table.m_size;
+    } else {
+        group = ListItr_Get(itr);
+        if (group->m_count == group->m_capacity) {
+            group = _GrowGroup(group);
+            if (group == NULL) {
+                return DS_ALLOCATION_ERROR;
+            }
+            ListItr_Set(itr, group);
+        }
+    }
+
+    _GroupValues(group)[group->m_count++] = (void*)_value;
+    ++_map->m_values;
+    return DS_SUCCESS;
+}
+
+MultiValues HashMultiMapFindAll(const HashMultiMap* _map, const void* _searchKey) {
+    MultiValues span;
+    MultiGroup* group;
+
+    span.m_values = NULL;
+    span.m_count = 0;
+    if (_map == NULL || _searchKey == NULL) {
+        return span;
+    }
+
+    group = _FindGroup(_map, _searchKey);
+    if (group != NULL) {
+        span.m_values = _GroupValues(group);
+        span.m_count = group->m_count;
+    }
+    return span;
+}
+
+size_t HashMultiMapCountKey(const HashMultiMap* _map, const void* _searchKey) {
+    MultiGroup* group;
+
+    if (_map == NULL || _searchKey == NULL) {
+        return 0;
+    }
+
+    group = _FindGroup(_map, _searchKey);
+    return (group != NULL) ? group->m_count : 0;
+}
+
+aps_ds_error HashMultiMapRemoveAll(HashMultiMap* _map, const void* _searchKey, void** _pKey, void (*_valDestroy)(void* _value)) {
+    ListItr itr;
+    MultiGroup* group;
+
+    if (_map == NULL || _pKey == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_searchKey == NULL) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    itr = HashChainFind(&_map->m_table, _searchKey, HashKeyHash(&_map->m_table, _searchKey), _GroupKey);
+    if (itr == ListItr_Next(itr)) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    group = ListItr_Remove(itr);
+    --_map->m_table.m_size;
+    _map->m_values -= group->m_count;
+    *_pKey = group->m_key;
+    _DestroyGroup(group, NULL, _valDestroy);
+    return DS_SUCCESS;
+}
+
+size_t HashMultiMapSize(const HashMultiMap* _map) {
+    if (_map == NULL) {
+        return 0;
+    }
+    return _map->m_values;
+}
+
+size_t HashMultiMapKeys(const HashMultiMap* _map) {
+    if (_map == NULL) {
+        return 0;
+    }
+    return _map->m_table.m_size;
+}
+
+static const void* _GroupKey(const void* _group) {
+    return ((const MultiGroup*)_group)->m_key;
+}
+
+static void** _GroupValues(MultiGroup* _group) {
+    return (void**)(_group + 1);
+}
+
+static MultiGroup* _FindGroup(const HashMultiMap* _map, const void* _key) {
+    ListItr itr = HashChainFind(&_map->m_table, _key, HashKeyHash(&_map->m_table, _key), _GroupKey);
+    return (itr != ListItr_Next(itr)) ? ListItr_Get(itr) : NULL;
+}
+
+static MultiGroup* _CreateGroup(const void* _key) {
+    MultiGroup* group = (MultiGroup*)malloc(sizeof(MultiGroup) + MULTI_FIRST_CAPACITY * sizeof(void*));
+    if (group == NULL) {
+        return NULL;
+    }
+
+    group->m_key = (void*)_key;
+    group->m_count = 0;
+    group->m_capacity = MULTI_FIRST_CAPACITY;
+    return group;
+}
+
+/* doubles the values array, the group may move */
+static MultiGroup* _GrowGroup(MultiGroup* _group) {
+    MultiGroup* group;
+    size_t capacity = _group->m_capacity * 2;
+
+    if (capacity > (((size_t)-1) - sizeof(MultiGroup)) / sizeof(void*)) {
+        return NULL;
+    }
+
+    group = (MultiGroup*)realloc(_group, sizeof(MultiGroup) + capacity * sizeof(void*));
+    if (group == NULL) {
+        return NULL;
+    }
+    group->m_capacity = capacity;
+    return group;
+}
+
+static void _DestroyGroup(MultiGroup* _group, void (*_keyDestroy)(void* _key), void (*_valDestroy)(void* _value)) {
+    size_t i;
+
+    for (i = 0; _valDestroy != NULL && i < _group->m_count; ++i) {
+        _valDestroy(_GroupValues(_group)[i]);
+    }
+    if (_keyDestroy != NULL) {
+        _keyDestroy(_group->m_key);
+    }
+    free(_group);
+}
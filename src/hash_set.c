@@ -0,0 +1,220 @@
+#include "hash_set.h"
+#include "list.h"
+#include "hash_internal.h"
+#include <stdlib.h> /*< malloc >*/
+
+#define KEEP_CONTAINED (1)
+#define KEEP_MISSING (0)
+
+struct HashSet {
+    HashMap m_table; /*< chains hold the keys themselves >*/
+};
+
+static aps_ds_error _InsertKey(HashSet* _set, const void* _key);
+static void _RemoveAt(HashSet* _set, ListItr _itr, void (*_keyDestroy)(void* _key));
+static void _Filter(HashSet* _dest, const HashSet* _src, int _keep, void (*_keyDestroy)(void* _key));
+
+HashSet* HashSetCreate(size_t _capacity, HashFunction _hashFunc, EqualityFunction _keysEqualFunc) {
+    HashSet* set;
+
+    if (_hashFunc == NULL || _keysEqualFunc == NULL) {
+        return NULL;
+    }
+
+    set = (HashSet*)malloc(sizeof(HashSet));
+    if (set == NULL) {
+        return NULL;
+    }
+
+    if (DS_SUCCESS != HashTableInit(&set->m_table, _capacity, _hashFunc, _keysEqualFunc)) {
+        free(set);
+        return NULL;
+    }
+    return set;
+}
+
+void HashSetDestroy(HashSet** _set, void (*_keyDestroy)(void* _key)) {
+    size_t i;
+    if (_set == NULL || *_set == NULL) {
+        return;
+    }
+
+    for (i = 0; i < (*_set)->m_table.m_capacity; ++i) {
+        ListDestroy(&(*_set)->m_table.m_lists[i], _keyDestroy);
+    }
+    HashChainsDestroy((*_set)->m_table.m_lists, 0);
+    free(*_set);
+    *_set = NULL;
+}
+
+aps_ds_error HashSetInsert(HashSet* _set, const void* _key) {
+    if (_set == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_key == NULL) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    return _InsertKey(_set, _key);
+}
+
+int HashSetContains(const HashSet* _set, const void* _searchKey) {
+    ListItr itr;
+    if (_set == NULL || _searchKey == NULL) {
+        return 0;
+    }
+
+    itr = HashChainFind(&_set->m_table, _searchKey, HashKeyHash(&_set->m_table, _searchKey), NULL);
+    return itr != ListItr_Next(itr);
+}
+
+aps_ds_error HashSetRemove(HashSet* _set, const void* _searchKey, void** _pKey) {
+    ListItr itr;
+
+    if (_set == NULL || _pKey == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_searchKey == NULL) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    itr = HashChainFind(&_set->m_table, _searchKey, HashKeyHash(&_set->m_table, _searchKey), NULL);
+    if (itr == ListItr_Next(itr)) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    *_pKey = ListItr_Remove(itr);
+    --_set->m_table.m_size;
+    return DS_SUCCESS;
+}
+
+size_t HashSetSize(const HashSet* _set) {
+    if (_set == NULL) {
+        return 0;
+    }
+    return _set->m_table.m_size;
+}
+
+size_t HashSetForEach(const HashSet* _set, KeyActionFunction _action, void* _context) {
+    size_t idx;
+    size_t count = 0;
+    ListItr itr;
+    ListItr end;
+
+    if (_set == NULL || _action == NULL) {
+        return 0;
+    }
+
+    for (idx = 0; idx < _set->m_table.m_capacity; ++idx) {
+        end = ListItr_End(_set->m_table.m_lists[idx]);
+        for (itr = ListItr_Begin(_set->m_table.m_lists[idx]); itr != end; itr = ListItr_Next(itr)) {
+            ++count;
+            if (_action(ListItr_Get(itr), _context) == 0) {
+                return count;
+            }
+        }
+    }
+    return count;
+}
+
+aps_ds_error HashSetUnion(HashSet* _dest, const HashSet* _src) {
+    size_t idx;
+    ListItr itr;
+    ListItr end;
+    aps_ds_error err;
+
+    if (_dest == NULL || _src == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    for (idx = 0; idx < _src->m_table.m_capacity; ++idx) {
+        end = ListItr_End(_src->m_table.m_lists[idx]);
+        for (itr = ListItr_Begin(_src->m_table.m_lists[idx]); itr != end; itr = ListItr_Next(itr)) {
+            err = _InsertKey(_dest, ListItr_Get(itr));
+            if (err != DS_SUCCESS && err != DS_KEY_EXISTS_ERROR) {
+                return err;
+            }
+        }
+    }
+    return DS_SUCCESS;
+}
+
+aps_ds_error HashSetIntersection(HashSet* _dest, const HashSet* _src, void (*_keyDestroy)(void* _key)) {
+    if (_dest == NULL || _src == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    _Filter(_dest, _src, KEEP_CONTAINED, _keyDestroy);
+    return DS_SUCCESS;
+}
+
+aps_ds_error HashSetDifference(HashSet* _dest, const HashSet* _src, void (*_keyDestroy)(void* _key)) {
+    size_t idx;
+    ListItr itr;
+    ListItr end;
+    ListItr found;
+
+    if (_dest == NULL || _src == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_src->m_table.m_size >= _dest->m_table.m_size) {
+        _Filter(_dest, _src, KEEP_MISSING, _keyDestroy);
+        return DS_SUCCESS;
+    }
+
+    for (idx = 0; idx < _src->m_table.m_capacity; ++idx) {
+        end = ListItr_End(_src->m_table.m_lists[idx]);
+        for (itr = ListItr_Begin(_src->m_table.m_lists[idx]); itr != end; itr = ListItr_Next(itr)) {
+            found = HashChainFind(&_dest->m_table, ListItr_Get(itr), HashKeyHash(&_dest->m_table, ListItr_Get(itr)), NULL);
+            if (found != ListItr_Next(found)) {
+                _RemoveAt(_dest, found, _keyDestroy);
+            }
+        }
+    }
+    return DS_SUCCESS;
+}
+
+static aps_ds_error _InsertKey(HashSet* _set, const void* _key) {
+    ListItr itr;
+
+    itr = HashChainFind(&_set->m_table, _key, HashKeyHash(&_set->m_table, _key), NULL);
+    if (itr != ListItr_Next(itr)) {
+        return DS_KEY_EXISTS_ERROR;
+    }
+
+    if (ListItr_InsertBefore(itr, (void*)_key) == NULL) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    ++_set->m_table.m_size;
+    return DS_SUCCESS;
+}
+
+static void _RemoveAt(HashSet* _set, ListItr _itr, void (*_keyDestroy)(void* _key)) {
+    void* key = ListItr_Remove(_itr);
+    --_set->m_table.m_size;
+    if (_keyDestroy != NULL) {
+        _keyDestroy(key);
+    }
+}
+
+/* keeps the keys of _dest whose membership in _src equals _keep */
+static void _Filter(HashSet* _dest, const HashSet* _src, int _keep, void (*_keyDestroy)(void* _key)) {
+    size_t idx;
+    ListItr itr;
+    ListItr next;
+    ListItr end;
+
+    for (idx = 0; idx < _dest->m_table.m_capacity; ++idx) {
+        end = ListItr_End(_dest->m_table.m_lists[idx]);
+        for (itr = ListItr_Begin(_dest->m_table.m_lists[idx]); itr != end; itr = next) {
+            next = ListItr_Next(itr);
+            if ((HashSetContains(_src, ListItr_Get(itr)) != 0) != _keep) {
+                _RemoveAt(_dest, itr, _keyDestroy);
+            }
+        }
+    }
+}
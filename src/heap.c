@@ -1,23 +1,44 @@
 #include "heap.h"
-#include "vector.h"
-#include "ds_assert.h"
 #include <stdlib.h> /*< malloc >*/
+#include <string.h> /*< memcpy >*/
+
+#define HEAP_CACHE_LINE (64)
+#define HEAP_BINARY (2)
+#define HEAP_NO_HANDLE ((size_t)-1)
 
 struct Heap {
-    Vector* m_vector; 
+    void** m_items;     /*< tree in level order, children of i are i*m_arity+1 .. i*m_arity+m_arity >*/
+    void* m_memory;     /*< allocation of m_items, placed so that m_items + 1 starts a cache line >*/
+    size_t m_size;
+    size_t m_capacity;
+    size_t m_arity;
+    size_t m_bound;         /*< most items a bounded heap keeps, 0 if the heap grows >*/
+    size_t* m_handleAt;     /*< handle of the item at each position, null until the first HeapPushHandle >*/
+    size_t* m_positionOf;   /*< position of each handle in use, next free handle of each free one >*/
+    size_t m_handles;       /*< number of handles, in use or free >*/
+    size_t m_freeHandle;
     Heap_Type m_heapType;
+    Compare_Result m_above; /*< compare result of an item that belongs above the other one >*/
     HeapDataCompareFunc m_compareFunc;
 };
 
-typedef struct PlaceAndData {
-    size_t m_childPlace;
-    void* m_data;
-} PlaceAndData;
-
-static PlaceAndData _GetExpectedComparedData(Heap* _heap, size_t _place, Compare_Result _expectedCompareResult);
-static aps_ds_error _FindPlaceToInsert(Heap* _heap, void* _data, size_t _lastPlace, Compare_Result _expectedCompareResult);
-static aps_ds_error _ReplaceAfterRemove(Heap* _heap, size_t _place, Compare_Result _expectedCompareResult);
-/** 
+static aps_ds_error _Push(Heap* _heap, void* _data, size_t* _handle);
+static aps_ds_error _Reserve(Heap* _heap, size_t _capacity);
+static aps_ds_error _ReserveHandles(Heap* _heap, size_t _capacity);
+static aps_ds_error _CreateIndex(Heap* _heap);
+static size_t _TakeHandle(Heap* _heap);
+static size_t _HandleAt(const Heap* _heap, size_t _position);
+static void _ReleaseHandle(Heap* _heap, size_t _position);
+static int _FindHandle(const Heap* _heap, HeapHandle _handle, size_t* _position);
+static void _Move(Heap* _heap, size_t _to, size_t _from);
+static void _Put(Heap* _heap, size_t _position, void* _item, size_t _handle);
+static size_t _BestChild(const Heap* _heap, size_t _firstChild);
+static void _SiftUp(Heap* _heap, size_t _hole, void* _item, size_t _handle);
+static void _SiftDown(Heap* _heap, size_t _hole, void* _item, size_t _handle);
+static void _Fix(Heap* _heap, size_t _hole, void* _item, size_t _handle);
+static void _Heapify(Heap* _heap);
+static int _HasNullItem(void* const* _items, size_t _numOfItems);
+/**
  * @brief Create a new heap with given size.
  * @param[in] _heapSize - Expected max capacity.
  * @param[in] _heapType - Heap type if store max or min
@@ -25,34 +46,97 @@ static aps_ds_error _ReplaceAfterRemove(Heap* _heap, size_t _place, Compare_Resu
  * @return newly created heap or null on failure
  */
 Heap* HeapCreate(size_t _heapSize, Heap_Type _heapType, HeapDataCompareFunc _comapreFunc) {
+    return HeapCreateEx(_heapSize, _heapType, _comapreFunc, HEAP_BINARY);
+}
+
+/**
+ * @brief Create a new heap with given size and number of children per node.
+ * @param[in] _heapSize - Expected max capacity.
+ * @param[in] _heapType - Heap type if store max or min
+ * @param[in] _comapreFunc - compare function for heap data
+ * @param[in] _arity - children per node, 2, 4 or 8
+ * @return newly created heap or null on failure
+ */
+Heap* HeapCreateEx(size_t _heapSize, Heap_Type _heapType, HeapDataCompareFunc _comapreFunc, size_t _arity) {
     Heap* newHeap = NULL;
-    Vector* newHeapVector = NULL;
     if (0 == _heapSize || NULL == _comapreFunc) {
         return NULL;
     }
 
-    if (_heapType >= HEAP_TYPE_ENUM_END || _heapType <= HEAP_TYPE_ENUM_START) {
+    if (_arity != 2 && _arity != 4 && _arity != 8) {
         return NULL;
     }
 
+    if (_heapType >= HEAP_TYPE_ENUM_END || _heapType <= HEAP_TYPE_ENUM_START) {
+        return NULL;
+    }
 
     newHeap = (Heap*)malloc(sizeof(Heap));
     if (NULL == newHeap) {
         return NULL;
     }
 
-    newHeapVector = VectorCreate(_heapSize, 10);
-    if (NULL == newHeapVector) {
+    newHeap->m_items = NULL;
+    newHeap->m_memory = NULL;
+    newHeap->m_handleAt = NULL;
+    newHeap->m_positionOf = NULL;
+    newHeap->m_handles = 0;
+    newHeap->m_freeHandle = HEAP_NO_HANDLE;
+    newHeap->m_size = 0;
+    newHeap->m_capacity = 0;
+    if (DS_SUCCESS != _Reserve(newHeap, _heapSize)) {
         free(newHeap);
         return NULL;
     }
 
-    newHeap->m_vector = newHeapVector;
+    newHeap->m_arity = _arity;
+    newHeap->m_bound = 0;
     newHeap->m_heapType = _heapType;
+    newHeap->m_above = _heapType == HEAP_TYPE_MAX ? BIGGER : SMALLER;
     newHeap->m_compareFunc = _comapreFunc;
     return newHeap;
 }
 
+/**
+ * @brief Create a heap that keeps at most _k items, offered items compete for a place with the top.
+ * @param[in] _k - number of items kept
+ * @param[in] _heapType - Heap type if store max or min
+ * @param[in] _comapreFunc - compare function for heap data
+ * @return newly created heap or null on failure
+ */
+Heap* HeapCreateBounded(size_t _k, Heap_Type _heapType, HeapDataCompareFunc _comapreFunc) {
+    Heap* newHeap = HeapCreateEx(_k, _heapType, _comapreFunc, HEAP_BINARY);
+    if (NULL != newHeap) {
+        newHeap->m_bound = _k;
+    }
+    return newHeap;
+}
+
+/**
+ * @brief Create a new heap holding a copy of an array of items, built bottom up in O(n).
+ * @param[in] _items - items to put in the heap, none null. The array itself is not kept.
+ * @param[in] _numOfItems - number of items, 0 creates an empty heap
+ * @param[in] _heapType - Heap type if store max or min
+ * @param[in] _comapreFunc - compare function for heap data
+ * @return newly created heap or null on failure or if an item is null
+ */
+Heap* HeapCreateFrom(void* const* _items, size_t _numOfItems, Heap_Type _heapType, HeapDataCompareFunc _comapreFunc) {
+    Heap* newHeap = NULL;
+    if (NULL == _items || _HasNullItem(_items, _numOfItems)) {
+        return NULL;
+    }
+
+    newHeap = HeapCreate(0 == _numOfItems ? 1 : _numOfItems, _heapType, _comapreFunc);
+    if (NULL == newHeap) {
+        return NULL;
+    }
+
+    memcpy(newHeap->m_items, _items, _numOfItems * sizeof(void*));
+    newHeap->m_size = _numOfItems;
+    _Heapify(newHeap);
+    return newHeap;
+}
+
 /**
  * @brief Dynamically deallocate a previously allocated heap
  * @param[in] _heap - Heap to be deallocated.
@@ -61,11 +145,17 @@ Heap* HeapCreate(size_t _heapSize, Heap_Type _heapType, HeapDataCompareFunc _com
  * @return void
  */
 void HeapDestroy(Heap** _heap, void (*_elementDestroy)(void* _item)) {
+    size_t i;
     if (NULL == _heap || NULL == *_heap) {
         return;
     }
 
-    VectorDestroy(&(*_heap)->m_vector, _elementDestroy);
+    for (i = 0; NULL != _elementDestroy && i < (*_heap)->m_size; ++i) {
+        _elementDestroy((*_heap)->m_items[i]);
+    }
+    free((*_heap)->m_handleAt);
+    free((*_heap)->m_positionOf);
+    free((*_heap)->m_memory);
     free(*_heap);
     *_heap = NULL;
 }
@@ -77,8 +167,113 @@ void HeapDestroy(Heap** _heap, void (*_elementDestroy)(void* _item)) {
  * @return DS_SUCCESS, and other on error
  */
 aps_ds_error HeapPush(Heap* _heap, void* _data) {
-    Compare_Result expectedCopareResult;
-    if (NULL == _heap) {
+    size_t handle;
+    return _Push(_heap, _data, &handle);
+}
+
+/**
+ * @brief insert new data into heap and get a handle to it
+ * @param[in] _heap - Heap.
+ * @param[in] _data - pointer to the data
+ * @param[out] _handle - handle of the data, valid until the data leaves the heap
+ * @return DS_SUCCESS, and other on error
+ */
+aps_ds_error HeapPushHandle(Heap* _heap, void* _data, HeapHandle* _handle) {
+    aps_ds_error result;
+    if (NULL == _heap || NULL == _handle) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (NULL == _heap->m_handleAt) {
+        result = _CreateIndex(_heap);
+        if (DS_SUCCESS != result) {
+            return result;
+        }
+    }
+    return _Push(_heap, _data, _handle);
+}
+
+/**
+ * @brief insert many items into heap
+ * @param[in] _heap - Heap.
+ * @param[in] _items - pointers to the data, none null
+ * @param[in] _numOfItems - number of items
+ * @param[out] _handles - optional, gets the handle of every item
+ * @return DS_SUCCESS, and other on error, on error no item was inserted
+ */
+aps_ds_error HeapPushBatch(Heap* _heap, void* const* _items, size_t _numOfItems, HeapHandle* _handles) {
+    aps_ds_error result;
+    size_t capacity;
+    size_t handle;
+    size_t i;
+    if (NULL == _heap || NULL == _items) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_HasNullItem(_items, _numOfItems)) {
+        return DS_UNINITIALIZED_ITEM_ERROR;
+    }
+
+    if (_numOfItems > ((size_t)-1) / sizeof(void*) - _heap->m_size) {
+        return DS_OVERFLOW_ERROR;
+    }
+
+    if (0 != _heap->m_bound && _heap->m_size + _numOfItems > _heap->m_bound) {
+        return DS_OVERFLOW_ERROR;
+    }
+
+    if (_heap->m_size + _numOfItems > _heap->m_capacity) {
+        capacity = _heap->m_capacity * 2;
+        if (capacity < _heap->m_size + _numOfItems || capacity > ((size_t)-1) / sizeof(void*)) {
+            capacity = _heap->m_size + _numOfItems;
+        }
+        result = _Reserve(_heap, capacity);
+        if (DS_SUCCESS != result) {
+            return result;
+        }
+    }
+
+    if (NULL != _handles && NULL == _heap->m_handleAt) {
+        result = _CreateIndex(_heap);
+        if (DS_SUCCESS != result) {
+            return result;
+        }
+    }
+
+    /* sifting each item up costs O(k log n), rebuilding everything O(n + k) */
+    if (_numOfItems < _heap->m_size) {
+        for (i = 0; i < _numOfItems; ++i) {
+            handle = _TakeHandle(_heap);
+            if (NULL != _handles) {
+                _handles[i] = handle;
+            }
+            _SiftUp(_heap, _heap->m_size++, _items[i], handle);
+        }
+        return DS_SUCCESS;
+    }
+
+    memcpy(_heap->m_items + _heap->m_size, _items, _numOfItems * sizeof(void*));
+    for (i = 0; NULL != _heap->m_handleAt && i < _numOfItems; ++i) {
+        handle = _TakeHandle(_heap);
+        if (NULL != _handles) {
+            _handles[i] = handle;
+        }
+        _Put(_heap, _heap->m_size + i, _items[i], handle);
+    }
+    _heap->m_size += _numOfItems;
+    _Heapify(_heap);
+    return DS_SUCCESS;
+}
+
+/**
+ * @brief Offer an item to a bounded heap, a full heap keeps the better of the item and its top
+ * @param[in] _heap - Heap.
+ * @param[in] _data - pointer to the data
+ * @param[out] _pEvicted - the item that did not make it: null if none, the old top, or _data itself
+ * @return DS_SUCCESS, and other on error
+ */
+aps_ds_error HeapOffer(Heap* _heap, void* _data, void** _pEvicted) {
+    if (NULL == _heap || NULL == _pEvicted) {
         return DS_UNINITIALIZED_ERROR;
     }
 
@@ -86,65 +281,142 @@ aps_ds_error HeapPush(Heap* _heap, void* _data) {
         return DS_UNINITIALIZED_ITEM_ERROR;
     }
 
-    expectedCopareResult = _heap->m_heapType == HEAP_TYPE_MAX ? BIGGER : SMALLER;
-    return _FindPlaceToInsert(_heap, _data, VectorSize(_heap->m_vector), expectedCopareResult);
+    *_pEvicted = NULL;
+    if (0 == _heap->m_bound || _heap->m_size < _heap->m_bound) {
+        return HeapPush(_heap, _data);
+    }
+
+    /* the top is the worst item kept, anything that belongs above it is worse still */
+    if (_heap->m_compareFunc(_data, _heap->m_items[0]) == _heap->m_above) {
+        *_pEvicted = _data;
+        return DS_SUCCESS;
+    }
+
+    *_pEvicted = _heap->m_items[0];
+    _ReleaseHandle(_heap, 0);
+    _SiftDown(_heap, 0, _data, _TakeHandle(_heap));
+    return DS_SUCCESS;
+}
+
+/**
+ * @brief Empty the heap into an array, the last item a pop would return comes first
+ * @param[in] _heap - Heap.
+ * @param[out] _items - array of at least HeapSize items
+ * @return DS_SUCCESS, other error on failure
+ */
+aps_ds_error HeapExtractSorted(Heap* _heap, void** _items) {
+    size_t i;
+    if (NULL == _heap || NULL == _items) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    for (i = _heap->m_size; i > 0; --i) {
+        HeapPop(_heap, _items + i - 1);
+    }
+    return DS_SUCCESS;
 }
 
 /**
  * @brief Remove element from the top
  * @param[in] _heap - Heap.
- * @param[out]_pValue - pointer where to store the pointer to the value 
+ * @param[out]_pValue - pointer where to store the pointer to the value
  * @return DS_SUCCESS, other error on failure
  */
 aps_ds_error HeapPop(Heap* _heap, void** _pValue) {
-    Compare_Result expectedCopareResult;
-    aps_ds_error vectorResult = DS_UNINITIALIZED_ERROR;
     void* lastElement = NULL;
     if (NULL == _heap || NULL == _pValue) {
         return DS_UNINITIALIZED_ERROR;
     }
 
-    if (0 == HeapSize(_heap)) {
+    if (0 == _heap->m_size) {
         return DS_OUT_OF_BOUNDS_ERROR;
     }
 
-    vectorResult = VectorRemove(_heap->m_vector, &lastElement);
-    DS_ASSERT_EQUAL(vectorResult, DS_SUCCESS);
-    if (VectorSize(_heap->m_vector) == 0) {
-        *_pValue = lastElement;
-        return DS_SUCCESS;
+    *_pValue = _heap->m_items[0];
+    _ReleaseHandle(_heap, 0);
+    lastElement = _heap->m_items[--_heap->m_size];
+    if (0 != _heap->m_size) {
+        _SiftDown(_heap, 0, lastElement, _HandleAt(_heap, _heap->m_size));
     }
+    return DS_SUCCESS;
+}
 
-    vectorResult = VectorSet(_heap->m_vector, 0, lastElement, _pValue);
-    if (vectorResult != DS_SUCCESS) {
-        VectorAppend(_heap->m_vector, lastElement);
-        return vectorResult;
+/**
+ * @brief Restore the heap order after the priority of an item changed in any direction
+ * @param[in] _heap - Heap.
+ * @param[in] _handle - handle of the changed item
+ * @return DS_SUCCESS, DS_ELEMENT_NOT_FOUND_ERROR if the handle is not in the heap, other error on failure
+ */
+aps_ds_error HeapUpdate(Heap* _heap, HeapHandle _handle) {
+    size_t position;
+    if (NULL == _heap) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (!_FindHandle(_heap, _handle, &position)) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
     }
 
-    expectedCopareResult = _heap->m_heapType == HEAP_TYPE_MAX ? BIGGER : SMALLER;
-    return _ReplaceAfterRemove(_heap, 0, expectedCopareResult);
+    _Fix(_heap, position, _heap->m_items[position], _handle);
+    return DS_SUCCESS;
 }
 
 /**
- * @brief Get the top value in heap do not remove the value
+ * @brief Restore the heap order after an item moved toward the top, smaller in a min heap or bigger in a max heap
  * @param[in] _heap - Heap.
- * @return the address to the value on success, NULL on failure
+ * @param[in] _handle - handle of the changed item
+ * @return DS_SUCCESS, DS_ELEMENT_NOT_FOUND_ERROR if the handle is not in the heap, other error on failure
  */
-const void* HeapGetTopValue(const Heap* _heap) {
-    void* value = NULL;
+aps_ds_error HeapDecreaseKey(Heap* _heap, HeapHandle _handle) {
+    size_t position;
     if (NULL == _heap) {
-        return NULL;
+        return DS_UNINITIALIZED_ERROR;
     }
 
-    if (0 == VectorSize(_heap->m_vector)) {
-        return NULL;
+    if (!_FindHandle(_heap, _handle, &position)) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
     }
 
-    if (DS_SUCCESS != VectorGet(_heap->m_vector, 0, &value)) {
+    _SiftUp(_heap, position, _heap->m_items[position], _handle);
+    return DS_SUCCESS;
+}
+
+/**
+ * @brief Remove an item from anywhere in the heap
+ * @param[in] _heap - Heap.
+ * @param[in] _handle - handle of the item to remove
+ * @param[out]_pValue - pointer where to store the pointer to the value
+ * @return DS_SUCCESS, DS_ELEMENT_NOT_FOUND_ERROR if the handle is not in the heap, other error on failure
+ */
+aps_ds_error HeapRemove(Heap* _heap, HeapHandle _handle, void** _pValue) {
+    size_t position;
+    if (NULL == _heap || NULL == _pValue) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (!_FindHandle(_heap, _handle, &position)) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    *_pValue = _heap->m_items[position];
+    _ReleaseHandle(_heap, position);
+    if (position != --_heap->m_size) {
+        _Fix(_heap, position, _heap->m_items[_heap->m_size], _HandleAt(_heap, _heap->m_size));
+    }
+    return DS_SUCCESS;
+}
+
+/**
+ * @brief Get the top value in heap do not remove the value
+ * @param[in] _heap - Heap.
+ * @return the address to the value on success, NULL on failure
+ */
+const void* HeapGetTopValue(const Heap* _heap) {
+    if (NULL == _heap || 0 == _heap->m_size) {
         return NULL;
     }
 
-    return value;
+    return _heap->m_items[0];
 }
 
 
@@ -157,83 +429,241 @@ ssize_t HeapSize(const Heap* _heap) {
     if (NULL == _heap) {
         return -1;
     }
-    return VectorSize(_heap->m_vector);
+    return (ssize_t)_heap->m_size;
 }
 
-static PlaceAndData _GetExpectedComparedData(Heap* _heap, size_t _place, Compare_Result _expectedCompareResult) {
-    PlaceAndData retData = {0, NULL};
-    void* childA = NULL;
-    void* childB = NULL;
-    size_t childPlaceA =  (_place+1) * 2;
-    size_t childPlaceB = (_place+1) * 2 - 1;
-    size_t vectorSize = VectorSize(_heap->m_vector);
-    if (childPlaceB >= vectorSize) {
-        return retData;
+static aps_ds_error _Push(Heap* _heap, void* _data, size_t* _handle) {
+    aps_ds_error result;
+    if (NULL == _heap) {
+        return DS_UNINITIALIZED_ERROR;
     }
 
-    VectorGet(_heap->m_vector, childPlaceB, &childB);
-    
-    if (childPlaceA >= vectorSize) {
-        retData.m_data = childB; 
-        retData.m_childPlace = childPlaceB;
-        return retData;
+    if (NULL == _data) {
+        return DS_UNINITIALIZED_ITEM_ERROR;
     }
 
-    VectorGet(_heap->m_vector, childPlaceA, &childA);
-    if (_heap->m_compareFunc(childA, childB) == _expectedCompareResult) {
-        retData.m_data = childA;
-        retData.m_childPlace = childPlaceA;
-    } else {
-        retData.m_data = childB; 
-        retData.m_childPlace = childPlaceB;
+    if (0 != _heap->m_bound && _heap->m_size == _heap->m_bound) {
+        return DS_OVERFLOW_ERROR;
+    }
+
+    if (_heap->m_size == _heap->m_capacity) {
+        result = _Reserve(_heap, _heap->m_capacity * 2);
+        if (DS_SUCCESS != result) {
+            return result;
+        }
     }
-    
-    return retData;
+
+    *_handle = _TakeHandle(_heap);
+    _SiftUp(_heap, _heap->m_size++, _data, *_handle);
+    return DS_SUCCESS;
 }
 
-static aps_ds_error _ReplaceAfterRemove(Heap* _heap, size_t _place, Compare_Result _expectedCompareResult) {
-    void* parent = NULL;
-    PlaceAndData bestChildToCompareWith = _GetExpectedComparedData(_heap, _place, _expectedCompareResult);
-    if (NULL == bestChildToCompareWith.m_data) {
-        return DS_SUCCESS;
+/* realloc would lose the alignment, the items are copied to a new aligned block */
+static aps_ds_error _Reserve(Heap* _heap, size_t _capacity) {
+    void* memory;
+    void** items;
+    if (_capacity <= _heap->m_capacity
+        || _capacity > (((size_t)-1) - 2 * HEAP_CACHE_LINE) / sizeof(void*)) {
+        return DS_OVERFLOW_ERROR;
+    }
+
+    if (NULL != _heap->m_handleAt && DS_SUCCESS != _ReserveHandles(_heap, _capacity)) {
+        return DS_REALLOCATION_ERROR;
+    }
+
+    memory = malloc(_capacity * sizeof(void*) + 2 * HEAP_CACHE_LINE);
+    if (NULL == memory) {
+        return NULL == _heap->m_memory ? DS_ALLOCATION_ERROR : DS_REALLOCATION_ERROR;
+    }
+
+    /* the children of a node start at i*m_arity+1, so item 1 is put on a cache line boundary */
+    items = (void**)(((size_t)memory + HEAP_CACHE_LINE + HEAP_CACHE_LINE - 1) & ~(size_t)(HEAP_CACHE_LINE - 1)) - 1;
+    if (0 != _heap->m_size) {
+        memcpy(items, _heap->m_items, _heap->m_size * sizeof(void*));
     }
+    free(_heap->m_memory);
+    _heap->m_memory = memory;
+    _heap->m_items = items;
+    _heap->m_capacity = _capacity;
+    return DS_SUCCESS;
+}
 
-    VectorGet(_heap->m_vector, _place, &parent);
-    if (_heap->m_compareFunc(parent, bestChildToCompareWith.m_data) == _expectedCompareResult) {
+/* new handles go to the front of the free list, a failure leaves the handles as they were */
+static aps_ds_error _ReserveHandles(Heap* _heap, size_t _capacity) {
+    size_t* positionOf;
+    size_t* handleAt;
+    size_t handle;
+    if (_capacity <= _heap->m_handles) {
         return DS_SUCCESS;
     }
 
-    VectorSet(_heap->m_vector, _place, bestChildToCompareWith.m_data, NULL);
-    VectorSet(_heap->m_vector, bestChildToCompareWith.m_childPlace, parent, NULL);
-    return _ReplaceAfterRemove(_heap, bestChildToCompareWith.m_childPlace, _expectedCompareResult);
+    if (_capacity > ((size_t)-1) / sizeof(size_t)) {
+        return DS_OVERFLOW_ERROR;
+    }
+
+    positionOf = (size_t*)realloc(_heap->m_positionOf, _capacity * sizeof(size_t));
+    if (NULL == positionOf) {
+        return DS_REALLOCATION_ERROR;
+    }
+    _heap->m_positionOf = positionOf;
+
+    handleAt = (size_t*)realloc(_heap->m_handleAt, _capacity * sizeof(size_t));
+    if (NULL == handleAt) {
+        return DS_REALLOCATION_ERROR;
+    }
+    _heap->m_handleAt = handleAt;
+
+    for (handle = _heap->m_handles; handle + 1 < _capacity; ++handle) {
+        _heap->m_positionOf[handle] = handle + 1;
+    }
+    _heap->m_positionOf[_capacity - 1] = _heap->m_freeHandle;
+    _heap->m_freeHandle = _heap->m_handles;
+    _heap->m_handles = _capacity;
+    return DS_SUCCESS;
+}
+
+/* the items already in the heap get handles too, nobody knows them but they keep the index whole */
+static aps_ds_error _CreateIndex(Heap* _heap) {
+    size_t position;
+    if (DS_SUCCESS != _ReserveHandles(_heap, _heap->m_capacity)) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    for (position = 0; position < _heap->m_size; ++position) {
+        _Put(_heap, position, _heap->m_items[position], _TakeHandle(_heap));
+    }
+    return DS_SUCCESS;
+}
+
+/* a heap without an index has no handles */
+static size_t _TakeHandle(Heap* _heap) {
+    size_t handle = _heap->m_freeHandle;
+    if (NULL != _heap->m_handleAt) {
+        _heap->m_freeHandle = _heap->m_positionOf[handle];
+    }
+    return handle;
+}
+
+static size_t _HandleAt(const Heap* _heap, size_t _position) {
+    return NULL != _heap->m_handleAt ? _heap->m_handleAt[_position] : HEAP_NO_HANDLE;
+}
+
+static void _ReleaseHandle(Heap* _heap, size_t _position) {
+    size_t handle;
+    if (NULL != _heap->m_handleAt) {
+        handle = _heap->m_handleAt[_position];
+        _heap->m_positionOf[handle] = _heap->m_freeHandle;
+        _heap->m_freeHandle = handle;
+    }
+}
+
+/* a free handle links to another free handle, never to a position holding it */
+static int _FindHandle(const Heap* _heap, HeapHandle _handle, size_t* _position) {
+    if (NULL == _heap->m_handleAt || _handle >= _heap->m_handles) {
+        return 0;
+    }
+
+    *_position = _heap->m_positionOf[_handle];
+    return *_position < _heap->m_size && _heap->m_handleAt[*_position] == _handle;
 }
 
-static aps_ds_error _FindPlaceToInsert(Heap* _heap, void* _data, size_t _lastPlace, Compare_Result _expectedCompareResult) {
-    void* comapreData = NULL;
-    size_t parentPlace = 0;
-    size_t vectorSize = VectorSize(_heap->m_vector);
-    if (0 == _lastPlace) {
-        if (0 == vectorSize) {
-            return VectorAppend(_heap->m_vector, _data);
+static void _Move(Heap* _heap, size_t _to, size_t _from) {
+    _heap->m_items[_to] = _heap->m_items[_from];
+    if (NULL != _heap->m_handleAt) {
+        _heap->m_handleAt[_to] = _heap->m_handleAt[_from];
+        _heap->m_positionOf[_heap->m_handleAt[_to]] = _to;
+    }
+}
+
+static void _Put(Heap* _heap, size_t _position, void* _item, size_t _handle) {
+    _heap->m_items[_position] = _item;
+    if (NULL != _heap->m_handleAt) {
+        _heap->m_handleAt[_position] = _handle;
+        _heap->m_positionOf[_handle] = _position;
+    }
+}
+
+/* the children of a node share a cache line, picking the best one is a short scan */
+static size_t _BestChild(const Heap* _heap, size_t _firstChild) {
+    size_t best = _firstChild;
+    size_t child;
+    size_t end = _firstChild + _heap->m_arity;
+
+    if (end > _heap->m_size) {
+        end = _heap->m_size;
+    }
+
+    for (child = _firstChild + 1; child < end; ++child) {
+        if (_heap->m_compareFunc(_heap->m_items[child], _heap->m_items[best]) == _heap->m_above) {
+            best = child;
         }
-        return VectorSet(_heap->m_vector, _lastPlace, _data, NULL);
     }
-    
-    parentPlace = (_lastPlace % 2) == 0 ? _lastPlace/2 - 1: _lastPlace/2;
-    VectorGet(_heap->m_vector, parentPlace, &comapreData);
+    return best;
+}
+
+/* Floyd: every subtree below a node is a heap by the time the node itself is sifted down */
+static void _Heapify(Heap* _heap) {
+    size_t parent = (_heap->m_size + _heap->m_arity - 2) / _heap->m_arity;
+    while (parent > 0) {
+        --parent;
+        _SiftDown(_heap, parent, _heap->m_items[parent], _HandleAt(_heap, parent));
+    }
+}
 
-    if (_expectedCompareResult == _heap->m_compareFunc(_data, comapreData)) {
-        if (_lastPlace == vectorSize) {
-            VectorAppend(_heap->m_vector, comapreData);
-        } else {
-            VectorSet(_heap->m_vector, _lastPlace, comapreData, NULL);
+static int _HasNullItem(void* const* _items, size_t _numOfItems) {
+    size_t i;
+    for (i = 0; i < _numOfItems; ++i) {
+        if (NULL == _items[i]) {
+            return 1;
         }
-        return _FindPlaceToInsert(_heap, _data, parentPlace, _expectedCompareResult);
     }
+    return 0;
+}
+
+/* moves the hole up while its parent belongs below _item, one compare per level */
+static void _SiftUp(Heap* _heap, size_t _hole, void* _item, size_t _handle) {
+    size_t parent;
+    while (_hole > 0) {
+        parent = (_hole - 1) / _heap->m_arity;
+        if (_heap->m_compareFunc(_item, _heap->m_items[parent]) != _heap->m_above) {
+            break;
+        }
+        _Move(_heap, _hole, parent);
+        _hole = parent;
+    }
+    _Put(_heap, _hole, _item, _handle);
+}
+
+/* bottom up: the hole follows the best child to a leaf without looking at _item, m_arity - 1
+ * compares per level, then _item sifts up from there. _item usually came from the bottom and stays low */
+static void _SiftDown(Heap* _heap, size_t _hole, void* _item, size_t _handle) {
+    size_t top = _hole;
+    size_t child;
+    size_t parent;
+
+    while ((child = _hole * _heap->m_arity + 1) < _heap->m_size) {
+        child = _BestChild(_heap, child);
+        _Move(_heap, _hole, child);
+        _hole = child;
+    }
+
+    while (_hole > top) {
+        parent = (_hole - 1) / _heap->m_arity;
+        if (_heap->m_compareFunc(_item, _heap->m_items[parent]) != _heap->m_above) {
+            break;
+        }
+        _Move(_heap, _hole, parent);
+        _hole = parent;
+    }
+    _Put(_heap, _hole, _item, _handle);
+}
 
-    if (_lastPlace == vectorSize) {
-        return VectorAppend(_heap->m_vector, _data);
+/* _item goes up if it belongs above its parent and down otherwise */
+static void _Fix(Heap* _heap, size_t _hole, void* _item, size_t _handle) {
+    if (_hole > 0
+        && _heap->m_compareFunc(_item, _heap->m_items[(_hole - 1) / _heap->m_arity]) == _heap->m_above) {
+        _SiftUp(_heap, _hole, _item, _handle);
     } else {
-        return VectorSet(_heap->m_vector, _lastPlace, _data, NULL);
+        _SiftDown(_heap, _hole, _item, _handle);
     }
-}
\ No newline at end of file
+}
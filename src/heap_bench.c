@@ -0,0 +1,116 @@
+/* push and pop time per key of the 2, 4 and 8 way heaps and of the key heap at 1K, 1M and 100M random keys.
+ * the first argument limits the largest size, 100M keys need about 2.5 GB.
+ * build: gcc -O2 -ansi -pedantic -Wall -pthread -Iinc src/heap_bench.c src/heap.c src/key_heap.c -o heap_bench */
+#include "heap.h"
+#include "key_heap.h"
+#include <stdio.h>  /*< printf >*/
+#include <stdlib.h> /*< malloc, strtoul >*/
+#include <time.h>   /*< clock >*/
+
+#define BENCH_NUM_OF_SIZES (3)
+#define BENCH_NUM_OF_ARITIES (3)
+
+static Compare_Result _CompareSizeT(const void* _a, const void* _b) {
+    return (*(const size_t*)_a > *(const size_t*)_b) ? BIGGER : SMALLER;
+}
+
+static double _Seconds(clock_t _from, clock_t _to) {
+    return (double)(_to - _from) / CLOCKS_PER_SEC;
+}
+
+static int _Run(size_t* _keys, size_t _numOfKeys, size_t _arity) {
+    Heap* heap;
+    void* item;
+    clock_t start;
+    clock_t pushed;
+    clock_t popped;
+    size_t i;
+
+    heap = HeapCreateEx(_numOfKeys, HEAP_TYPE_MIN, _CompareSizeT, _arity);
+    if (NULL == heap) {
+        return -1;
+    }
+
+    start = clock();
+    for (i = 0; i < _numOfKeys; ++i) {
+        HeapPush(heap, _keys + i);
+    }
+    pushed = clock();
+    for (i = 0; i < _numOfKeys; ++i) {
+        HeapPop(heap, &item);
+    }
+    popped = clock();
+
+    printf("%10lu keys  %lu way  push %8.1f ns  pop %8.1f ns\n", (unsigned long)_numOfKeys, (unsigned long)_arity,
+           _Seconds(start, pushed) * 1e9 / _numOfKeys, _Seconds(pushed, popped) * 1e9 / _numOfKeys);
+    HeapDestroy(&heap, NULL);
+    return 0;
+}
+
+static int _RunKeyHeap(size_t* _keys, size_t _numOfKeys) {
+    KeyHeap* heap;
+    void* item;
+    clock_t start;
+    clock_t pushed;
+    clock_t popped;
+    size_t i;
+
+    heap = KeyHeapCreate(_numOfKeys, HEAP_TYPE_MIN);
+    if (NULL == heap) {
+        return -1;
+    }
+
+    start = clock();
+    for (i = 0; i < _numOfKeys; ++i) {
+        KeyHeapPush(heap, _keys[i], _keys + i);
+    }
+    pushed = clock();
+    for (i = 0; i < _numOfKeys; ++i) {
+        KeyHeapPop(heap, NULL, &item);
+    }
+    popped = clock();
+
+    printf("%10lu keys  key heap  push %8.1f ns  pop %8.1f ns\n", (unsigned long)_numOfKeys,
+           _Seconds(start, pushed) * 1e9 / _numOfKeys, _Seconds(pushed, popped) * 1e9 / _numOfKeys);
+    KeyHeapDestroy(&heap, NULL);
+    return 0;
+}
+
+int main(int _argc, char* _argv[]) {
+    size_t sizes[BENCH_NUM_OF_SIZES] = {1000, 1000000, 100000000};
+    size_t arities[BENCH_NUM_OF_ARITIES] = {2, 4, 8};
+    size_t limit = sizes[BENCH_NUM_OF_SIZES - 1];
+    size_t seed = 88172645;
+    size_t* keys;
+    size_t s;
+    size_t a;
+    size_t i;
+
+    if (_argc > 1) {
+        limit = (size_t)strtoul(_argv[1], NULL, 10);
+    }
+
+    for (s = 0; s < BENCH_NUM_OF_SIZES && sizes[s] <= limit; ++s) {
+        keys = (size_t*)malloc(sizes[s] * sizeof(size_t));
+        if (NULL == keys) {
+            printf("%10lu keys  out of memory\n", (unsigned long)sizes[s]);
+            return 1;
+        }
+
+        for (i = 0; i < sizes[s]; ++i) {
+            seed = seed * 6364136223UL + 1442695041UL;
+            keys[i] = seed >> 3;
+        }
+
+        for (a = 0; a < BENCH_NUM_OF_ARITIES; ++a) {
+            if (_Run(keys, sizes[s], arities[a]) != 0) {
+                printf("%10lu keys  %lu way  out of memory\n", (unsigned long)sizes[s], (unsigned long)arities[a]);
+            }
+        }
+        if (_RunKeyHeap(keys, sizes[s]) != 0) {
+            printf("%10lu keys  key heap  out of memory\n", (unsigned long)sizes[s]);
+        }
+        free(keys);
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "key_heap.h"
+#include <stdlib.h> /*< malloc >*/
+#include <string.h> /*< memcpy >*/
+
+#define KEY_HEAP_CACHE_LINE (64)
+#define KEY_HEAP_ARITY (4)
+
+typedef struct KeyHeapItem {
+    uint64_t m_key;     /*< the priority, complemented in a max heap so the smallest key is always on top >*/
+    void* m_data;
+} KeyHeapItem;
+
+struct KeyHeap {
+    KeyHeapItem* m_items;   /*< tree in level order, children of i are 4*i+1 .. 4*i+4 >*/
+    void* m_memory;         /*< allocation of m_items, placed so that m_items + 1 starts a cache line >*/
+    size_t m_size;
+    size_t m_capacity;
+    uint64_t m_flip;        /*< 0 for a min heap, all ones for a max heap >*/
+};
+
+static aps_ds_error _Reserve(KeyHeap* _heap, size_t _capacity);
+static void _SiftUp(KeyHeap* _heap, size_t _hole, KeyHeapItem _item);
+static void _SiftDown(KeyHeap* _heap, KeyHeapItem _item);
+
+KeyHeap* KeyHeapCreate(size_t _heapSize, Heap_Type _heapType) {
+    KeyHeap* newHeap = NULL;
+    if (0 == _heapSize) {
+        return NULL;
+    }
+
+    if (_heapType >= HEAP_TYPE_ENUM_END || _heapType <= HEAP_TYPE_ENUM_START) {
+        return NULL;
+    }
+
+    newHeap = (KeyHeap*)malloc(sizeof(KeyHeap));
+    if (NULL == newHeap) {
+        return NULL;
+    }
+
+    newHeap->m_items = NULL;
+    newHeap->m_memory = NULL;
+    newHeap->m_size = 0;
+    newHeap->m_capacity = 0;
+    if (DS_SUCCESS != _Reserve(newHeap, _heapSize)) {
+        free(newHeap);
+        return NULL;
+    }
+
+    newHeap->m_flip = HEAP_TYPE_MAX == _heapType ? ~(uint64_t)0 : 0;
+    return newHeap;
+}
+
+void KeyHeapDestroy(KeyHeap** _heap, void (*_elementDestroy)(void* _item)) {
+    size_t i;
+    if (NULL == _heap || NULL == *_heap) {
+        return;
+    }
+
+    for (i = 0; NULL != _elementDestroy && i < (*_heap)->m_size; ++i) {
+        _elementDestroy((*_heap)->m_items[i].m_data);
+    }
+    free((*_heap)->m_memory);
+    free(*_heap);
+    *_heap = NULL;
+}
+
+aps_ds_error KeyHeapPush(KeyHeap* _heap, uint64_t _priority, void* _data) {
+    aps_ds_error result;
+    KeyHeapItem item;
+    if (NULL == _heap) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_heap->m_size == _heap->m_capacity) {
+        result = _Reserve(_heap, _heap->m_capacity * 2);
+        if (DS_SUCCESS != result) {
+            return result;
+        }
+    }
+
+    item.m_key = _priority ^ _heap->m_flip;
+    item.m_data = _data;
+    _SiftUp(_heap, _heap->m_size++, item);
+    return DS_SUCCESS;
+}
+
+aps_ds_error KeyHeapPop(KeyHeap* _heap, uint64_t* _pPriority, void** _pValue) {
+    aps_ds_error result = KeyHeapTop(_heap, _pPriority, _pValue);
+    if (DS_SUCCESS != result) {
+        return result;
+    }
+
+    if (0 != --_heap->m_size) {
+        _SiftDown(_heap, _heap->m_items[_heap->m_size]);
+    }
+    return DS_SUCCESS;
+}
+
+aps_ds_error KeyHeapTop(const KeyHeap* _heap, uint64_t* _pPriority, void** _pValue) {
+    if (NULL == _heap || NULL == _pValue) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (0 == _heap->m_size) {
+        return DS_OUT_OF_BOUNDS_ERROR;
+    }
+
+    if (NULL != _pPriority) {
+        *_pPriority = _heap->m_items[0].m_key ^ _heap->m_flip;
+    }
+    *_pValue = _heap->m_items[0].m_data;
+    return DS_SUCCESS;
+}
+
+ssize_t KeyHeapSize(const KeyHeap* _heap) {
+    if (NULL == _heap) {
+        return -1;
+    }
+    return (ssize_t)_heap->m_size;
+}
+
+/* realloc would lose the alignment, the items are copied to a new aligned block */
+static aps_ds_error _Reserve(KeyHeap* _heap, size_t _capacity) {
+    void* memory;
+    KeyHeapItem* items;
+    if (_capacity <= _heap->m_capacity
+        || _capacity > (((size_t)-1) - 2 * KEY_HEAP_CACHE_LINE) / sizeof(KeyHeapItem)) {
+        return DS_OVERFLOW_ERROR;
+    }
+
+    memory = malloc(_capacity * sizeof(KeyHeapItem) + 2 * KEY_HEAP_CACHE_LINE);
+    if (NULL == memory) {
+        return NULL == _heap->m_memory ? DS_ALLOCATION_ERROR : DS_REALLOCATION_ERROR;
+    }
+
+    /* item 1 on a cache line boundary puts the 4 children of every node on one line */
+    items = (KeyHeapItem*)(((size_t)memory + KEY_HEAP_CACHE_LINE + KEY_HEAP_CACHE_LINE - 1)
+                           & ~(size_t)(KEY_HEAP_CACHE_LINE - 1)) - 1;
+    if (0 != _heap->m_size) {
+        memcpy(items, _heap->m_items, _heap->m_size * sizeof(KeyHeapItem));
+    }
+    free(_heap->m_memory);
+    _heap->m_memory = memory;
+    _heap->m_items = items;
+    _heap->m_capacity = _capacity;
+    return DS_SUCCESS;
+}
+
+static void _SiftUp(KeyHeap* _heap, size_t _hole, KeyHeapItem _item) {
+    size_t parent;
+    while (_hole > 0) {
+        parent = (_hole - 1) / KEY_HEAP_ARITY;
+        if (_item.m_key >= _heap->m_items[parent].m_key) {
+            break;
+        }
+        _heap->m_items[_hole] = _heap->m_items[parent];
+        _hole = parent;
+    }
+    _heap->m_items[_hole] = _item;
+}
+
+/* bottom up from the root as in heap.c: the hole follows the smallest child to a leaf, then _item sifts up */
+static void _SiftDown(KeyHeap* _heap, KeyHeapItem _item) {
+    KeyHeapItem* items = _heap->m_items;
+    size_t hole = 0;
+    size_t child;
+    size_t best;
+    size_t end;
+
+    while ((child = hole * KEY_HEAP_ARITY + 1) < _heap->m_size) {
+        end = child + KEY_HEAP_ARITY;
+        if (end > _heap->m_size) {
+            end = _heap->m_size;
+        }
+        for (best = child++; child < end; ++child) {
+            best = items[child].m_key < items[best].m_key ? child : best;
+        }
+        items[hole] = items[best];
+        hole = best;
+    }
+    _SiftUp(_heap, hole, _item);
+}
@@ -1,13 +1,7 @@
 #ifndef __LISTINTERNAL_H__
 #define __LISTINTERNAL_H__
 
-
-typedef struct Node {
-    void* m_item;       /* pointer to items */
-    struct Node* m_next;/* Pointer to the next node */
-    struct Node* m_prev;/* Pointer to the previous node */
-    
-} Node;
+#include "list_node.h"
 
 struct List {
     struct Node m_head;/* The Head of the list */
@@ -0,0 +1,306 @@
+#include "lru_cache.h"
+#include "hash_internal.h"
+#include "listInternal.h"
+#include "list_itr.h"
+#include <stdlib.h> /*< malloc >*/
+
+#define LRU_DEFAULT_BUCKETS (1021)
+
+typedef struct LRUEntry {
+    Node m_links;       /*< recency links, m_item points back at the entry >*/
+    void* m_key;
+    void* m_value;
+    size_t m_weight;
+} LRUEntry;
+
+struct LRUCache {
+    HashMap* m_map;     /*< key -> LRUEntry >*/
+    Node m_head;        /*< m_head.m_next is the most recently used entry >*/
+    Node m_tail;        /*< m_tail.m_prev is the least recently used entry >*/
+    size_t m_maxEntries;
+    size_t m_maxWeight;
+    size_t m_weight;
+    LRUWeightFunction m_weightFunc;
+    LRUEvictFunction m_evictFunc;
+    void* m_context;
+    size_t m_hits;
+    size_t m_misses;
+    size_t m_evictions;
+};
+
+static void _Unlink(LRUEntry* _entry);
+static void _PushFront(LRUCache* _cache, LRUEntry* _entry);
+static LRUEntry* _Detach(LRUCache* _cache, const void* _key);
+static int _OverLimits(const LRUCache* _cache);
+static const void* _PairKey(const void* _item);
+static Elements* _FindPair(const LRUCache* _cache, const void* _key);
+static aps_ds_error _Replace(LRUCache* _cache, Elements* _pair, const void* _key, const void* _value, size_t _weight);
+static aps_ds_error _Add(LRUCache* _cache, const void* _key, const void* _value, size_t _weight);
+
+LRUCache* LRUCacheCreate(size_t _maxEntries, size_t _maxWeight, HashFunction _hashFunc, EqualityFunction _keysEqualFunc,
+                         LRUWeightFunction _weightFunc, LRUEvictFunction _evictFunc, void* _context) {
+    LRUCache* cache;
+
+    if (_maxEntries == 0 && _maxWeight == 0) {
+        return NULL;
+    }
+
+    cache = (LRUCache*)malloc(sizeof(LRUCache));
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    cache->m_map = HashMapCreate((_maxEntries != 0) ? _maxEntries : LRU_DEFAULT_BUCKETS, _hashFunc, _keysEqualFunc);
+    if (cache->m_map == NULL) {
+        free(cache);
+        return NULL;
+    }
+
+    cache->m_head.m_item = NULL;
+    cache->m_head.m_prev = &cache->m_head;
+    cache->m_head.m_next = &cache->m_tail;
+    cache->m_tail.m_item = NULL;
+    cache->m_tail.m_prev = &cache->m_head;
+    cache->m_tail.m_next = &cache->m_tail;
+    cache->m_maxEntries = _maxEntries;
+    cache->m_maxWeight = _maxWeight;
+    cache->m_weight = 0;
+    cache->m_weightFunc = _weightFunc;
+    cache->m_evictFunc = _evictFunc;
+    cache->m_context = _context;
+    cache->m_hits = 0;
+    cache->m_misses = 0;
+    cache->m_evictions = 0;
+    return cache;
+}
+
+void LRUCacheDestroy(LRUCache** _cache) {
+    LRUEntry* entry;
+
+    if (_cache == NULL || *_cache == NULL) {
+        return;
+    }
+
+    while ((*_cache)->m_head.m_next != &(*_cache)->m_tail) {
+        entry = (*_cache)->m_head.m_next->m_item;
+        _Unlink(entry);
+        if ((*_cache)->m_evictFunc != NULL) {
+            (*_cache)->m_evictFunc(entry->m_key, entry->m_value, (*_cache)->m_context);
+        }
+        free(entry);
+    }
+    HashMapDestroy(&(*_cache)->m_map, NULL, NULL);
+    free(*_cache);
+    *_cache = NULL;
+}
+
+aps_ds_error LRUCacheGet(LRUCache* _cache, const void* _searchKey, void** _pValue) {
+    LRUEntry* entry;
+    aps_ds_error err;
+
+    if (_cache == NULL || _pValue == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    err = HashMapFind(_cache->m_map, _searchKey, (void**)&entry);
+    if (err != DS_SUCCESS) {
+        if (err == DS_ELEMENT_NOT_FOUND_ERROR) {
+            ++_cache->m_misses;
+        }
+        return err;
+    }
+
+    ++_cache->m_hits;
+    _Unlink(entry);
+    _PushFront(_cache, entry);
+    *_pValue = entry->m_value;
+    return DS_SUCCESS;
+}
+
+aps_ds_error LRUCachePeek(const LRUCache* _cache, const void* _searchKey, void** _pValue) {
+    LRUEntry* entry;
+    aps_ds_error err;
+
+    if (_cache == NULL || _pValue == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    err = HashMapFind(_cache->m_map, _searchKey, (void**)&entry);
+    if (err == DS_SUCCESS) {
+        *_pValue = entry->m_value;
+    }
+    return err;
+}
+
+aps_ds_error LRUCachePut(LRUCache* _cache, const void* _key, const void* _value) {
+    LRUEntry* evicted;
+    Elements* pair;
+    size_t weight;
+    aps_ds_error err;
+
+    if (_cache == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_key == NULL) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    weight = (_cache->m_weightFunc != NULL) ? _cache->m_weightFunc(_key, _value) : 1;
+    if (_cache->m_maxWeight != 0 && weight > _cache->m_maxWeight) {
+        return DS_OVERFLOW_ERROR;
+    }
+
+    pair = _FindPair(_cache, _key);
+    err = (pair != NULL) ? _Replace(_cache, pair, _key, _value, weight) : _Add(_cache, _key, _value, weight);
+    if (err != DS_SUCCESS) {
+        return err;
+    }
+
+    while (_OverLimits(_cache)) {
+        evicted = _Detach(_cache, ((LRUEntry*)_cache->m_tail.m_prev->m_item)->m_key);
+        ++_cache->m_evictions;
+        if (_cache->m_evictFunc != NULL) {
+            _cache->m_evictFunc(evicted->m_key, evicted->m_value, _cache->m_context);
+        }
+        free(evicted);
+    }
+
+    /* the map never grows by itself, a count limit sized it already but a weight limit did not */
+    if (HashMapSize(_cache->m_map) > _cache->m_map->m_capacity) {
+        HashMapRehash(_cache->m_map, _cache->m_map->m_capacity * 2);
+    }
+    return DS_SUCCESS;
+}
+
+aps_ds_error LRUCacheRemove(LRUCache* _cache, const void* _searchKey, void** _pKey, void** _pValue) {
+    LRUEntry* entry;
+
+    if (_cache == NULL || _pKey == NULL || _pValue == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_searchKey == NULL) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    entry = _Detach(_cache, _searchKey);
+    if (entry == NULL) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    *_pKey = entry->m_key;
+    *_pValue = entry->m_value;
+    free(entry);
+    return DS_SUCCESS;
+}
+
+size_t LRUCacheSize(const LRUCache* _cache) {
+    if (_cache == NULL) {
+        return 0;
+    }
+    return HashMapSize(_cache->m_map);
+}
+
+LRU_Stats LRUCacheGetStatistics(const LRUCache* _cache) {
+    LRU_Stats stats;
+
+    stats.hits = 0;
+    stats.misses = 0;
+    stats.evictions = 0;
+    stats.size = 0;
+    stats.weight = 0;
+    if (_cache != NULL) {
+        stats.hits = _cache->m_hits;
+        stats.misses = _cache->m_misses;
+        stats.evictions = _cache->m_evictions;
+        stats.size = HashMapSize(_cache->m_map);
+        stats.weight = _cache->m_weight;
+    }
+    return stats;
+}
+
+static void _Unlink(LRUEntry* _entry) {
+    PopNode(_entry->m_links.m_prev, _entry->m_links.m_next);
+}
+
+static void _PushFront(LRUCache* _cache, LRUEntry* _entry) {
+    PushNode(&_cache->m_head, &_entry->m_links);
+}
+
+/* takes the entry of _key out of the map and the recency list, NULL if absent */
+static LRUEntry* _Detach(LRUCache* _cache, const void* _key) {
+    LRUEntry* entry;
+    void* key;
+
+    if (HashMapRemove(_cache->m_map, _key, &key, (void**)&entry) != DS_SUCCESS) {
+        return NULL;
+    }
+
+    _Unlink(entry);
+    _cache->m_weight -= entry->m_weight;
+    return entry;
+}
+
+static const void* _PairKey(const void* _item) {
+    return ((const Elements*)_item)->m_key;
+}
+
+/* the map's own pair of _key, so a replacement can swap the stored key in place. NULL if absent */
+static Elements* _FindPair(const LRUCache* _cache, const void* _key) {
+    ListItr itr = HashChainFind(_cache->m_map, _key, HashKeyHash(_cache->m_map, _key), _PairKey);
+    if (itr == ListItr_Next(itr)) {
+        return NULL;
+    }
+    return (Elements*)ListItr_Get(itr);
+}
+
+/* the entry and the map take the new key and value before the old pair is evicted, and a key
+ * or value the new pair still uses reaches the evict function as NULL. Nothing can fail */
+static aps_ds_error _Replace(LRUCache* _cache, Elements* _pair, const void* _key, const void* _value, size_t _weight) {
+    LRUEntry* entry = (LRUEntry*)_pair->m_value;
+    void* oldKey = entry->m_key;
+    void* oldValue = entry->m_value;
+
+    _pair->m_key = (void*)_key;
+    entry->m_key = (void*)_key;
+    entry->m_value = (void*)_value;
+    _cache->m_weight = _cache->m_weight - entry->m_weight + _weight;
+    entry->m_weight = _weight;
+    _Unlink(entry);
+    _PushFront(_cache, entry);
+
+    if (_cache->m_evictFunc != NULL) {
+        _cache->m_evictFunc((oldKey != _key) ? oldKey : NULL, (oldValue != _value) ? oldValue : NULL, _cache->m_context);
+    }
+    return DS_SUCCESS;
+}
+
+static aps_ds_error _Add(LRUCache* _cache, const void* _key, const void* _value, size_t _weight) {
+    LRUEntry* entry;
+    aps_ds_error err;
+
+    entry = (LRUEntry*)malloc(sizeof(LRUEntry));
+    if (entry == NULL) {
+        return DS_ALLOCATION_ERROR;
+    }
+    entry->m_links.m_item = entry;
+    entry->m_key = (void*)_key;
+    entry->m_value = (void*)_value;
+    entry->m_weight = _weight;
+
+    err = HashMapInsert(_cache->m_map, _key, entry);
+    if (err != DS_SUCCESS) {
+        free(entry);
+        return err;
+    }
+
+    _cache->m_weight += _weight;
+    _PushFront(_cache, entry);
+    return DS_SUCCESS;
+}
+
+static int _OverLimits(const LRUCache* _cache) {
+    return (_cache->m_maxEntries != 0 && HashMapSize(_cache->m_map) > _cache->m_maxEntries)
+        || (_cache->m_maxWeight != 0 && _cache->m_weight > _cache->m_maxWeight);
+}
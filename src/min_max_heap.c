@@ -0,0 +1,215 @@
+#include "min_max_heap.h"
+#include <stdlib.h> /*< malloc >*/
+
+struct MinMaxHeap {
+    void** m_items;     /*< tree in level order, children of i are 2*i+1 and 2*i+2 >*/
+    size_t m_size;
+    size_t m_capacity;
+    HeapDataCompareFunc m_compareFunc;
+};
+
+static int _IsMinLevel(size_t _index);
+static size_t _MaxIndex(const MinMaxHeap* _heap);
+static void _Swap(MinMaxHeap* _heap, size_t _first, size_t _second);
+static void _BubbleUp(MinMaxHeap* _heap, size_t _index);
+static void _TrickleDown(MinMaxHeap* _heap, size_t _index);
+static aps_ds_error _PopAt(MinMaxHeap* _heap, size_t _index, void** _pValue);
+
+MinMaxHeap* MinMaxHeapCreate(size_t _heapSize, HeapDataCompareFunc _comapreFunc) {
+    MinMaxHeap* newHeap = NULL;
+    if (0 == _heapSize || NULL == _comapreFunc || _heapSize > ((size_t)-1) / sizeof(void*)) {
+        return NULL;
+    }
+
+    newHeap = (MinMaxHeap*)malloc(sizeof(MinMaxHeap));
+    if (NULL == newHeap) {
+        return NULL;
+    }
+
+    newHeap->m_items = (void**)malloc(_heapSize * sizeof(void*));
+    if (NULL == newHeap->m_items) {
+        free(newHeap);
+        return NULL;
+    }
+
+    newHeap->m_size = 0;
+    newHeap->m_capacity = _heapSize;
+    newHeap->m_compareFunc = _comapreFunc;
+    return newHeap;
+}
+
+void MinMaxHeapDestroy(MinMaxHeap** _heap, void (*_elementDestroy)(void* _item)) {
+    size_t i;
+    if (NULL == _heap || NULL == *_heap) {
+        return;
+    }
+
+    for (i = 0; NULL != _elementDestroy && i < (*_heap)->m_size; ++i) {
+        _elementDestroy((*_heap)->m_items[i]);
+    }
+    free((*_heap)->m_items);
+    free(*_heap);
+    *_heap = NULL;
+}
+
+aps_ds_error MinMaxHeapPush(MinMaxHeap* _heap, void* _data) {
+    void** items;
+    if (NULL == _heap) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (NULL == _data) {
+        return DS_UNINITIALIZED_ITEM_ERROR;
+    }
+
+    if (_heap->m_size == _heap->m_capacity) {
+        if (_heap->m_capacity > ((size_t)-1) / 2 / sizeof(void*)) {
+            return DS_OVERFLOW_ERROR;
+        }
+        items = (void**)realloc(_heap->m_items, _heap->m_capacity * 2 * sizeof(void*));
+        if (NULL == items) {
+            return DS_REALLOCATION_ERROR;
+        }
+        _heap->m_items = items;
+        _heap->m_capacity *= 2;
+    }
+
+    _heap->m_items[_heap->m_size] = _data;
+    _BubbleUp(_heap, _heap->m_size++);
+    return DS_SUCCESS;
+}
+
+const void* MinMaxHeapGetMin(const MinMaxHeap* _heap) {
+    if (NULL == _heap || 0 == _heap->m_size) {
+        return NULL;
+    }
+    return _heap->m_items[0];
+}
+
+const void* MinMaxHeapGetMax(const MinMaxHeap* _heap) {
+    if (NULL == _heap || 0 == _heap->m_size) {
+        return NULL;
+    }
+    return _heap->m_items[_MaxIndex(_heap)];
+}
+
+aps_ds_error MinMaxHeapPopMin(MinMaxHeap* _heap, void** _pValue) {
+    if (NULL == _heap || NULL == _pValue) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+    return _PopAt(_heap, 0, _pValue);
+}
+
+aps_ds_error MinMaxHeapPopMax(MinMaxHeap* _heap, void** _pValue) {
+    if (NULL == _heap || NULL == _pValue) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+    return _PopAt(_heap, _MaxIndex(_heap), _pValue);
+}
+
+ssize_t MinMaxHeapSize(const MinMaxHeap* _heap) {
+    if (NULL == _heap) {
+        return -1;
+    }
+    return (ssize_t)_heap->m_size;
+}
+
+/* index i is on level floor(log2(i + 1)), the root level 0 is a min level */
+static int _IsMinLevel(size_t _index) {
+    int level = 0;
+    ++_index;
+    while (_index > 1) {
+        _index >>= 1;
+        ++level;
+    }
+    return 0 == level % 2;
+}
+
+/* the biggest item is the better of the root's children, or the root when it has none */
+static size_t _MaxIndex(const MinMaxHeap* _heap) {
+    if (_heap->m_size < 3) {
+        return _heap->m_size - (_heap->m_size > 0);
+    }
+    return _heap->m_compareFunc(_heap->m_items[2], _heap->m_items[1]) == BIGGER ? 2 : 1;
+}
+
+static void _Swap(MinMaxHeap* _heap, size_t _first, size_t _second) {
+    void* item = _heap->m_items[_first];
+    _heap->m_items[_first] = _heap->m_items[_second];
+    _heap->m_items[_second] = item;
+}
+
+/* a new item out of order with its parent swaps once to the parent's kind of level,
+ * then climbs grandparent by grandparent among levels of that kind */
+static void _BubbleUp(MinMaxHeap* _heap, size_t _index) {
+    Compare_Result above = _IsMinLevel(_index) ? SMALLER : BIGGER;
+    size_t grand;
+
+    if (0 == _index) {
+        return;
+    }
+
+    if (_heap->m_compareFunc(_heap->m_items[_index], _heap->m_items[(_index - 1) / 2]) == (SMALLER == above ? BIGGER : SMALLER)) {
+        _Swap(_heap, _index, (_index - 1) / 2);
+        _index = (_index - 1) / 2;
+        above = SMALLER == above ? BIGGER : SMALLER;
+    }
+
+    while (_index > 2) {
+        grand = ((_index - 1) / 2 - 1) / 2;
+        if (_heap->m_compareFunc(_heap->m_items[_index], _heap->m_items[grand]) != above) {
+            break;
+        }
+        _Swap(_heap, _index, grand);
+        _index = grand;
+    }
+}
+
+/* the item at _index sinks to the best of its children and grandchildren. Sinking to a
+ * grandchild may leave it out of order with the parent in between, one swap fixes that */
+static void _TrickleDown(MinMaxHeap* _heap, size_t _index) {
+    Compare_Result above = _IsMinLevel(_index) ? SMALLER : BIGGER;
+    size_t best;
+    size_t first;
+    size_t end;
+    size_t i;
+
+    while ((first = 2 * _index + 1) < _heap->m_size) {
+        best = first;
+        if (first + 1 < _heap->m_size && _heap->m_compareFunc(_heap->m_items[first + 1], _heap->m_items[best]) == above) {
+            best = first + 1;
+        }
+        end = 4 * _index + 7 < _heap->m_size ? 4 * _index + 7 : _heap->m_size;
+        for (i = 4 * _index + 3; i < end; ++i) {
+            if (_heap->m_compareFunc(_heap->m_items[i], _heap->m_items[best]) == above) {
+                best = i;
+            }
+        }
+
+        if (_heap->m_compareFunc(_heap->m_items[best], _heap->m_items[_index]) != above) {
+            return;
+        }
+        _Swap(_heap, best, _index);
+        if (best <= first + 1) {
+            return;
+        }
+
+        if (_heap->m_compareFunc(_heap->m_items[(best - 1) / 2], _heap->m_items[best]) == above) {
+            _Swap(_heap, best, (best - 1) / 2);
+        }
+        _index = best;
+    }
+}
+
+static aps_ds_error _PopAt(MinMaxHeap* _heap, size_t _index, void** _pValue) {
+    if (0 == _heap->m_size) {
+        return DS_OUT_OF_BOUNDS_ERROR;
+    }
+
+    *_pValue = _heap->m_items[_index];
+    _heap->m_items[_index] = _heap->m_items[--_heap->m_size];
+    if (_index < _heap->m_size) {
+        _TrickleDown(_heap, _index);
+    }
+    return DS_SUCCESS;
+}
@@ -0,0 +1,202 @@
+#include "multi_queue.h"
+#include "key_heap.h"
+#include "hash_internal.h"
+#include <pthread.h> /*< pthread_mutex_t >*/
+#include <stdlib.h>  /*< calloc >*/
+
+#define MULTI_QUEUE_CACHE_LINE (64)
+
+typedef struct MultiQueueLane {
+    pthread_mutex_t m_lock;
+    KeyHeap* m_heap;
+    uint64_t m_top;     /*< priority of the top xor m_flip, smaller is better, read without the lock >*/
+    size_t m_size;      /*< read without the lock >*/
+    char m_pad[MULTI_QUEUE_CACHE_LINE]; /*< keeps the hot fields of neighbour lanes off one cache line >*/
+} MultiQueueLane;
+
+struct MultiQueue {
+    MultiQueueLane* m_lanes;
+    size_t m_numOfLanes;
+    Heap_Type m_heapType;
+    uint64_t m_flip;    /*< 0 for a min queue, all ones for a max queue >*/
+};
+
+static __thread uint64_t s_random;  /*< xorshift state of the calling thread, 0 until its first draw >*/
+static uint64_t s_numOfThreads;     /*< threads seeded so far, touched once per thread >*/
+
+static uint64_t _Random(void);
+static void _Publish(const MultiQueue* _queue, MultiQueueLane* _lane);
+static int _PopLocked(const MultiQueue* _queue, MultiQueueLane* _lane, uint64_t* _pPriority, void** _pValue);
+
+MultiQueue* MultiQueueCreate(size_t _numOfLanes, size_t _laneSize, Heap_Type _heapType) {
+    MultiQueue* queue;
+    size_t i;
+
+    if (0 == _numOfLanes || 0 == _laneSize) {
+        return NULL;
+    }
+
+    if (_heapType >= HEAP_TYPE_ENUM_END || _heapType <= HEAP_TYPE_ENUM_START) {
+        return NULL;
+    }
+
+    queue = (MultiQueue*)malloc(sizeof(MultiQueue));
+    if (NULL == queue) {
+        return NULL;
+    }
+
+    queue->m_lanes = (MultiQueueLane*)calloc(_numOfLanes, sizeof(MultiQueueLane));
+    if (NULL == queue->m_lanes) {
+        free(queue);
+        return NULL;
+    }
+
+    for (i = 0; i < _numOfLanes; ++i) {
+        queue->m_lanes[i].m_heap = KeyHeapCreate(_laneSize, _heapType);
+        if (NULL == queue->m_lanes[i].m_heap || 0 != pthread_mutex_init(&queue->m_lanes[i].m_lock, NULL)) {
+            KeyHeapDestroy(&queue->m_lanes[i].m_heap, NULL);
+            queue->m_numOfLanes = i;
+            MultiQueueDestroy(&queue, NULL);
+            return NULL;
+        }
+    }
+
+    queue->m_numOfLanes = _numOfLanes;
+    queue->m_heapType = _heapType;
+    queue->m_flip = HEAP_TYPE_MAX == _heapType ? ~(uint64_t)0 : 0;
+    return queue;
+}
+
+void MultiQueueDestroy(MultiQueue** _queue, void (*_elementDestroy)(void* _item)) {
+    size_t i;
+    if (NULL == _queue || NULL == *_queue) {
+        return;
+    }
+
+    for (i = 0; i < (*_queue)->m_numOfLanes; ++i) {
+        KeyHeapDestroy(&(*_queue)->m_lanes[i].m_heap, _elementDestroy);
+        pthread_mutex_destroy(&(*_queue)->m_lanes[i].m_lock);
+    }
+    free((*_queue)->m_lanes);
+    free(*_queue);
+    *_queue = NULL;
+}
+
+aps_ds_error MultiQueuePush(MultiQueue* _queue, uint64_t _priority, void* _data) {
+    MultiQueueLane* lane;
+    aps_ds_error result;
+    size_t attempt;
+
+    if (NULL == _queue) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    /* any lane will do, a busy one is passed over for another */
+    lane = _queue->m_lanes + _Random() % _queue->m_numOfLanes;
+    for (attempt = 1; 0 != pthread_mutex_trylock(&lane->m_lock); ++attempt) {
+        lane = _queue->m_lanes + _Random() % _queue->m_numOfLanes;
+        if (attempt == _queue->m_numOfLanes) {
+            pthread_mutex_lock(&lane->m_lock);
+            break;
+        }
+    }
+
+    result = KeyHeapPush(lane->m_heap, _priority, _data);
+    if (DS_SUCCESS == result) {
+        _Publish(_queue, lane);
+    }
+    pthread_mutex_unlock(&lane->m_lock);
+    return result;
+}
+
+aps_ds_error MultiQueuePop(MultiQueue* _queue, uint64_t* _pPriority, void** _pValue) {
+    MultiQueueLane* first;
+    MultiQueueLane* second;
+    uint64_t random;
+    size_t attempt;
+    size_t i;
+    int found;
+
+    if (NULL == _queue || NULL == _pValue) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    for (attempt = 0; attempt < 2 * _queue->m_numOfLanes; ++attempt) {
+        random = _Random();
+        first = _queue->m_lanes + (size_t)(random % _queue->m_numOfLanes);
+        second = _queue->m_lanes + (size_t)((random >> 32) % _queue->m_numOfLanes);
+
+        /* the tops are read unlocked, a stale one only makes the choice a little worse */
+        if (0 == __atomic_load_n(&first->m_size, __ATOMIC_RELAXED)
+            || (0 != __atomic_load_n(&second->m_size, __ATOMIC_RELAXED)
+                && __atomic_load_n(&second->m_top, __ATOMIC_RELAXED) < __atomic_load_n(&first->m_top, __ATOMIC_RELAXED))) {
+            first = second;
+        }
+
+        if (0 == __atomic_load_n(&first->m_size, __ATOMIC_RELAXED) || 0 != pthread_mutex_trylock(&first->m_lock)) {
+            continue;
+        }
+        found = _PopLocked(_queue, first, _pPriority, _pValue);
+        pthread_mutex_unlock(&first->m_lock);
+        if (found) {
+            return DS_SUCCESS;
+        }
+    }
+
+    /* mostly empty: wait for every lane in turn before giving up */
+    for (i = 0; i < _queue->m_numOfLanes; ++i) {
+        first = _queue->m_lanes + i;
+        pthread_mutex_lock(&first->m_lock);
+        found = _PopLocked(_queue, first, _pPriority, _pValue);
+        pthread_mutex_unlock(&first->m_lock);
+        if (found) {
+            return DS_SUCCESS;
+        }
+    }
+    return DS_OUT_OF_BOUNDS_ERROR;
+}
+
+ssize_t MultiQueueSize(const MultiQueue* _queue) {
+    size_t size = 0;
+    size_t i;
+    if (NULL == _queue) {
+        return -1;
+    }
+
+    for (i = 0; i < _queue->m_numOfLanes; ++i) {
+        size += __atomic_load_n(&_queue->m_lanes[i].m_size, __ATOMIC_RELAXED);
+    }
+    return (ssize_t)size;
+}
+
+/* every thread draws from its own state so lane choices share no cache line between threads */
+static uint64_t _Random(void) {
+    uint64_t x = s_random;
+    if (0 == x) {
+        x = HashMix64(__sync_add_and_fetch(&s_numOfThreads, 1) ^ (uint64_t)(size_t)&s_random) | 1;
+    }
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    s_random = x;
+    return x * HASH_U64(0x2545f491, 0x4f6cdd1d);
+}
+
+/* called with the lane locked after its heap changed */
+static void _Publish(const MultiQueue* _queue, MultiQueueLane* _lane) {
+    uint64_t top = 0;
+    void* value;
+    if (DS_SUCCESS == KeyHeapTop(_lane->m_heap, &top, &value)) {
+        __atomic_store_n(&_lane->m_top, top ^ _queue->m_flip, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&_lane->m_size, (size_t)KeyHeapSize(_lane->m_heap), __ATOMIC_RELAXED);
+}
+
+/* the lane may have been emptied between choosing it and locking it */
+static int _PopLocked(const MultiQueue* _queue, MultiQueueLane* _lane, uint64_t* _pPriority, void** _pValue) {
+    if (DS_SUCCESS != KeyHeapPop(_lane->m_heap, _pPriority, _pValue)) {
+        return 0;
+    }
+    _Publish(_queue, _lane);
+    return 1;
+}
@@ -0,0 +1,131 @@
+/* throughput of the multi queue against one Heap behind a mutex, from 1 to 64 threads.
+ * every thread pushes and pops in turn on a queue that starts with 100K items, the first argument limits
+ * the number of threads.
+ * build: gcc -O2 -ansi -pedantic -Wall -pthread -Iinc -Isrc src/multi_queue_bench.c src/multi_queue.c src/key_heap.c src/heap.c -o multi_queue_bench */
+#define _POSIX_C_SOURCE 199309L
+#include "multi_queue.h"
+#include "heap.h"
+#include <pthread.h> /*< pthread_create >*/
+#include <stdio.h>   /*< printf >*/
+#include <stdlib.h>  /*< strtoul >*/
+#include <time.h>    /*< clock_gettime >*/
+
+#define BENCH_MAX_THREADS (64)
+#define BENCH_PREFILL (100000)
+#define BENCH_OPS (1000000)
+#define BENCH_LANES_PER_THREAD (4)
+
+typedef struct BenchContext {
+    MultiQueue* m_queue;
+    Heap* m_heap;
+    pthread_mutex_t* m_lock;
+    size_t m_ops;
+    uint64_t m_seed;
+} BenchContext;
+
+/* the heap items are the priorities themselves, odd so none is null, no payload is allocated */
+static Compare_Result _ComparePriority(const void* _a, const void* _b) {
+    return (size_t)_a > (size_t)_b ? BIGGER : SMALLER;
+}
+
+static void* _QueueWorker(void* _context) {
+    BenchContext* context = (BenchContext*)_context;
+    uint64_t priority;
+    void* item;
+    size_t i;
+
+    for (i = 0; i < context->m_ops; ++i) {
+        context->m_seed = context->m_seed * 6364136223UL + 1442695041UL;
+        MultiQueuePush(context->m_queue, context->m_seed >> 16, NULL);
+        MultiQueuePop(context->m_queue, &priority, &item);
+    }
+    return NULL;
+}
+
+static void* _HeapWorker(void* _context) {
+    BenchContext* context = (BenchContext*)_context;
+    void* item;
+    size_t i;
+
+    for (i = 0; i < context->m_ops; ++i) {
+        context->m_seed = context->m_seed * 6364136223UL + 1442695041UL;
+        pthread_mutex_lock(context->m_lock);
+        HeapPush(context->m_heap, (void*)(size_t)((context->m_seed >> 16) | 1));
+        pthread_mutex_unlock(context->m_lock);
+        pthread_mutex_lock(context->m_lock);
+        HeapPop(context->m_heap, &item);
+        pthread_mutex_unlock(context->m_lock);
+    }
+    return NULL;
+}
+
+static double _Now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/* returns millions of push and pop pairs per second, on the multi queue when _numOfLanes
+ * is not 0 and on the locked heap otherwise */
+static double _Run(size_t _numOfThreads, size_t _numOfLanes) {
+    BenchContext contexts[BENCH_MAX_THREADS];
+    pthread_t threads[BENCH_MAX_THREADS];
+    pthread_mutex_t lock;
+    MultiQueue* queue = NULL;
+    Heap* heap = NULL;
+    double start;
+    double seconds;
+    size_t i;
+
+    if (0 != _numOfLanes) {
+        queue = MultiQueueCreate(_numOfLanes, BENCH_PREFILL / _numOfLanes + 1, HEAP_TYPE_MIN);
+    } else {
+        heap = HeapCreate(BENCH_PREFILL + 1, HEAP_TYPE_MIN, _ComparePriority);
+    }
+    if (NULL == queue && NULL == heap) {
+        return 0;
+    }
+    pthread_mutex_init(&lock, NULL);
+    for (i = 0; i < BENCH_PREFILL; ++i) {
+        if (NULL != queue) {
+            MultiQueuePush(queue, (uint64_t)i * 2654435761UL, NULL);
+        } else {
+            HeapPush(heap, (void*)(size_t)(((uint64_t)i * 2654435761UL) | 1));
+        }
+    }
+
+    start = _Now();
+    for (i = 0; i < _numOfThreads; ++i) {
+        contexts[i].m_queue = queue;
+        contexts[i].m_heap = heap;
+        contexts[i].m_lock = &lock;
+        contexts[i].m_ops = BENCH_OPS / _numOfThreads;
+        contexts[i].m_seed = i + 1;
+        pthread_create(threads + i, NULL, NULL != queue ? _QueueWorker : _HeapWorker, contexts + i);
+    }
+    for (i = 0; i < _numOfThreads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    seconds = _Now() - start;
+
+    MultiQueueDestroy(&queue, NULL);
+    HeapDestroy(&heap, NULL);
+    pthread_mutex_destroy(&lock);
+    return (double)(BENCH_OPS / _numOfThreads * _numOfThreads) / seconds / 1e6;
+}
+
+int main(int _argc, char* _argv[]) {
+    size_t limit = BENCH_MAX_THREADS;
+    size_t threads;
+
+    if (_argc > 1) {
+        limit = (size_t)strtoul(_argv[1], NULL, 10);
+    }
+
+    printf("threads  locked heap Mops/s  multi queue Mops/s\n");
+    for (threads = 1; threads <= limit && threads <= BENCH_MAX_THREADS; threads *= 2) {
+        printf("%7lu  %18.2f  %18.2f\n", (unsigned long)threads, _Run(threads, 0),
+               _Run(threads, threads * BENCH_LANES_PER_THREAD));
+    }
+    return 0;
+}
@@ -0,0 +1,337 @@
+#include "pairing_heap.h"
+#include <stdlib.h> /*< malloc >*/
+
+#define PAIRING_MIN_CHUNK (16)
+#define PAIRING_MAX_CHUNK (65536)
+
+struct PairingNode {
+    void* m_data;
+    PairingNode* m_child;   /*< first child >*/
+    PairingNode* m_next;    /*< next sibling, next free node while in the pool >*/
+    PairingNode* m_prev;    /*< previous sibling, the parent for a first child >*/
+};
+
+/* the nodes of a chunk follow its header in the same allocation */
+typedef struct PairingChunk {
+    struct PairingChunk* m_next;
+} PairingChunk;
+
+struct PairingHeap {
+    PairingNode* m_root;
+    size_t m_size;
+    PairingNode* m_free;
+    PairingNode* m_lastFree;    /*< kept for meld to splice the free lists >*/
+    PairingChunk* m_chunks;
+    PairingChunk* m_lastChunk;
+    size_t m_chunkNodes;        /*< number of nodes of the next chunk >*/
+    Heap_Type m_heapType;
+    Compare_Result m_above;     /*< compare result of an item that belongs above the other one >*/
+    HeapDataCompareFunc m_compareFunc;
+};
+
+static PairingNode* _TakeNode(PairingHeap* _heap);
+static void _FreeNode(PairingHeap* _heap, PairingNode* _node);
+static aps_ds_error _AddChunk(PairingHeap* _heap);
+static PairingNode* _Link(const PairingHeap* _heap, PairingNode* _first, PairingNode* _second);
+static PairingNode* _MergePairs(const PairingHeap* _heap, PairingNode* _first);
+static void _Cut(PairingNode* _node);
+
+PairingHeap* PairingHeapCreate(size_t _poolSize, Heap_Type _heapType, HeapDataCompareFunc _comapreFunc) {
+    PairingHeap* newHeap = NULL;
+    if (NULL == _comapreFunc) {
+        return NULL;
+    }
+
+    if (_heapType >= HEAP_TYPE_ENUM_END || _heapType <= HEAP_TYPE_ENUM_START) {
+        return NULL;
+    }
+
+    newHeap = (PairingHeap*)malloc(sizeof(PairingHeap));
+    if (NULL == newHeap) {
+        return NULL;
+    }
+
+    newHeap->m_root = NULL;
+    newHeap->m_size = 0;
+    newHeap->m_free = NULL;
+    newHeap->m_lastFree = NULL;
+    newHeap->m_chunks = NULL;
+    newHeap->m_lastChunk = NULL;
+    newHeap->m_chunkNodes = _poolSize < PAIRING_MIN_CHUNK ? PAIRING_MIN_CHUNK : _poolSize;
+    newHeap->m_heapType = _heapType;
+    newHeap->m_above = _heapType == HEAP_TYPE_MAX ? BIGGER : SMALLER;
+    newHeap->m_compareFunc = _comapreFunc;
+    if (0 != _poolSize && DS_SUCCESS != _AddChunk(newHeap)) {
+        free(newHeap);
+        return NULL;
+    }
+    return newHeap;
+}
+
+void PairingHeapDestroy(PairingHeap** _heap, void (*_elementDestroy)(void* _item)) {
+    PairingNode* node;
+    PairingNode* child;
+    PairingChunk* chunk;
+    if (NULL == _heap || NULL == *_heap) {
+        return;
+    }
+
+    /* child and next are the left and right links of a binary tree, rotating every
+     * left link away visits all nodes without a stack */
+    node = (*_heap)->m_root;
+    while (NULL != _elementDestroy && NULL != node) {
+        if (NULL != node->m_child) {
+            child = node->m_child;
+            node->m_child = child->m_next;
+            child->m_next = node;
+            node = child;
+        } else {
+            _elementDestroy(node->m_data);
+            node = node->m_next;
+        }
+    }
+
+    while (NULL != (chunk = (*_heap)->m_chunks)) {
+        (*_heap)->m_chunks = chunk->m_next;
+        free(chunk);
+    }
+    free(*_heap);
+    *_heap = NULL;
+}
+
+aps_ds_error PairingHeapPush(PairingHeap* _heap, void* _data, PairingNode** _pNode) {
+    PairingNode* node;
+    if (NULL == _heap) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (NULL == _data) {
+        return DS_UNINITIALIZED_ITEM_ERROR;
+    }
+
+    node = _TakeNode(_heap);
+    if (NULL == node) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    node->m_data = _data;
+    node->m_child = NULL;
+    node->m_next = NULL;
+    node->m_prev = NULL;
+    _heap->m_root = (NULL == _heap->m_root) ? node : _Link(_heap, _heap->m_root, node);
+    ++_heap->m_size;
+    if (NULL != _pNode) {
+        *_pNode = node;
+    }
+    return DS_SUCCESS;
+}
+
+const void* PairingHeapGetTopValue(const PairingHeap* _heap) {
+    if (NULL == _heap || NULL == _heap->m_root) {
+        return NULL;
+    }
+    return _heap->m_root->m_data;
+}
+
+aps_ds_error PairingHeapPop(PairingHeap* _heap, void** _pValue) {
+    PairingNode* top;
+    if (NULL == _heap || NULL == _pValue) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (NULL == _heap->m_root) {
+        return DS_OUT_OF_BOUNDS_ERROR;
+    }
+
+    top = _heap->m_root;
+    *_pValue = top->m_data;
+    _heap->m_root = _MergePairs(_heap, top->m_child);
+    _FreeNode(_heap, top);
+    --_heap->m_size;
+    return DS_SUCCESS;
+}
+
+aps_ds_error PairingHeapDecreaseKey(PairingHeap* _heap, PairingNode* _node) {
+    if (NULL == _heap || NULL == _node) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_node != _heap->m_root) {
+        _Cut(_node);
+        _heap->m_root = _Link(_heap, _heap->m_root, _node);
+    }
+    return DS_SUCCESS;
+}
+
+aps_ds_error PairingHeapMeld(PairingHeap* _dest, PairingHeap* _source) {
+    if (NULL == _dest || NULL == _source) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_dest == _source || _dest->m_heapType != _source->m_heapType || _dest->m_compareFunc != _source->m_compareFunc) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    if (NULL == _dest->m_root) {
+        _dest->m_root = _source->m_root;
+    } else if (NULL != _source->m_root) {
+        _dest->m_root = _Link(_dest, _dest->m_root, _source->m_root);
+    }
+    _dest->m_size += _source->m_size;
+
+    /* the nodes live in the chunks of _source, so the chunks and their free nodes move too */
+    if (NULL != _source->m_chunks) {
+        _source->m_lastChunk->m_next = _dest->m_chunks;
+        if (NULL == _dest->m_chunks) {
+            _dest->m_lastChunk = _source->m_lastChunk;
+        }
+        _dest->m_chunks = _source->m_chunks;
+    }
+    if (NULL != _source->m_free) {
+        _source->m_lastFree->m_next = _dest->m_free;
+        if (NULL == _dest->m_free) {
+            _dest->m_lastFree = _source->m_lastFree;
+        }
+        _dest->m_free = _source->m_free;
+    }
+
+    _source->m_root = NULL;
+    _source->m_size = 0;
+    _source->m_free = NULL;
+    _source->m_lastFree = NULL;
+    _source->m_chunks = NULL;
+    _source->m_lastChunk = NULL;
+    return DS_SUCCESS;
+}
+
+ssize_t PairingHeapSize(const PairingHeap* _heap) {
+    if (NULL == _heap) {
+        return -1;
+    }
+    return (ssize_t)_heap->m_size;
+}
+
+static PairingNode* _TakeNode(PairingHeap* _heap) {
+    PairingNode* node;
+    if (NULL == _heap->m_free && DS_SUCCESS != _AddChunk(_heap)) {
+        return NULL;
+    }
+
+    node = _heap->m_free;
+    _heap->m_free = node->m_next;
+    if (NULL == _heap->m_free) {
+        _heap->m_lastFree = NULL;
+    }
+    return node;
+}
+
+static void _FreeNode(PairingHeap* _heap, PairingNode* _node) {
+    _node->m_next = _heap->m_free;
+    if (NULL == _heap->m_free) {
+        _heap->m_lastFree = _node;
+    }
+    _heap->m_free = _node;
+}
+
+/* called with an empty free list, every node of the new chunk becomes free */
+static aps_ds_error _AddChunk(PairingHeap* _heap) {
+    PairingChunk* chunk;
+    PairingNode* nodes;
+    size_t i;
+    if (_heap->m_chunkNodes > (((size_t)-1) - sizeof(PairingChunk)) / sizeof(PairingNode)) {
+        return DS_OVERFLOW_ERROR;
+    }
+
+    chunk = (PairingChunk*)malloc(sizeof(PairingChunk) + _heap->m_chunkNodes * sizeof(PairingNode));
+    if (NULL == chunk) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    nodes = (PairingNode*)(chunk + 1);
+    for (i = 0; i + 1 < _heap->m_chunkNodes; ++i) {
+        nodes[i].m_next = nodes + i + 1;
+    }
+    nodes[i].m_next = NULL;
+    _heap->m_free = nodes;
+    _heap->m_lastFree = nodes + i;
+
+    chunk->m_next = _heap->m_chunks;
+    if (NULL == _heap->m_chunks) {
+        _heap->m_lastChunk = chunk;
+    }
+    _heap->m_chunks = chunk;
+    if (_heap->m_chunkNodes < PAIRING_MAX_CHUNK) {
+        _heap->m_chunkNodes *= 2;
+    }
+    return DS_SUCCESS;
+}
+
+/* the root that belongs below becomes the first child of the other, one compare */
+static PairingNode* _Link(const PairingHeap* _heap, PairingNode* _first, PairingNode* _second) {
+    PairingNode* swap;
+    if (_heap->m_compareFunc(_second->m_data, _first->m_data) == _heap->m_above) {
+        swap = _first;
+        _first = _second;
+        _second = swap;
+    }
+
+    _second->m_prev = _first;
+    _second->m_next = _first->m_child;
+    if (NULL != _first->m_child) {
+        _first->m_child->m_prev = _second;
+    }
+    _first->m_child = _second;
+    return _first;
+}
+
+/* two pass pairing: link the siblings in pairs from the left, stacking the results,
+ * then link the stack from the right. Returns the new root, detached */
+static PairingNode* _MergePairs(const PairingHeap* _heap, PairingNode* _first) {
+    PairingNode* pairs = NULL;
+    PairingNode* second;
+    PairingNode* next;
+    PairingNode* root;
+
+    while (NULL != _first) {
+        second = _first->m_next;
+        if (NULL == second) {
+            _first->m_next = pairs;
+            pairs = _first;
+            break;
+        }
+        next = second->m_next;
+        _first = _Link(_heap, _first, second);
+        _first->m_next = pairs;
+        pairs = _first;
+        _first = next;
+    }
+
+    if (NULL == pairs) {
+        return NULL;
+    }
+
+    root = pairs;
+    pairs = pairs->m_next;
+    while (NULL != pairs) {
+        next = pairs->m_next;
+        root = _Link(_heap, root, pairs);
+        pairs = next;
+    }
+    root->m_next = NULL;
+    root->m_prev = NULL;
+    return root;
+}
+
+/* detaches the subtree of a node that is not the root from its parent and siblings */
+static void _Cut(PairingNode* _node) {
+    if (_node->m_prev->m_child == _node) {
+        _node->m_prev->m_child = _node->m_next;
+    } else {
+        _node->m_prev->m_next = _node->m_next;
+    }
+    if (NULL != _node->m_next) {
+        _node->m_next->m_prev = _node->m_prev;
+    }
+    _node->m_next = NULL;
+    _node->m_prev = NULL;
+}
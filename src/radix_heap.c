@@ -0,0 +1,208 @@
+#include "radix_heap.h"
+#include <stdlib.h> /*< malloc >*/
+
+/* bucket 0 for the last popped key and one for every bit a key may differ in */
+#define RADIX_NUM_OF_BUCKETS (65)
+#define RADIX_FIRST_CAPACITY (4)
+
+typedef struct RadixItem {
+    uint64_t m_key;
+    void* m_data;
+} RadixItem;
+
+typedef struct RadixBucket {
+    RadixItem* m_items;
+    size_t m_size;
+    size_t m_capacity;
+} RadixBucket;
+
+struct RadixHeap {
+    RadixBucket m_buckets[RADIX_NUM_OF_BUCKETS];
+    uint64_t m_last;    /*< last popped key, every key in the heap is at least this >*/
+    size_t m_size;
+};
+
+static size_t _BucketOf(uint64_t _key, uint64_t _last);
+static aps_ds_error _Reserve(RadixBucket* _bucket, size_t _capacity);
+static aps_ds_error _Redistribute(RadixHeap* _heap);
+
+RadixHeap* RadixHeapCreate(void) {
+    RadixHeap* heap;
+    size_t i;
+
+    heap = (RadixHeap*)malloc(sizeof(RadixHeap));
+    if (NULL == heap) {
+        return NULL;
+    }
+
+    for (i = 0; i < RADIX_NUM_OF_BUCKETS; ++i) {
+        heap->m_buckets[i].m_items = NULL;
+        heap->m_buckets[i].m_size = 0;
+        heap->m_buckets[i].m_capacity = 0;
+    }
+    heap->m_last = 0;
+    heap->m_size = 0;
+    return heap;
+}
+
+void RadixHeapDestroy(RadixHeap** _heap, void (*_elementDestroy)(void* _item)) {
+    RadixBucket* bucket;
+    size_t i;
+    size_t j;
+    if (NULL == _heap || NULL == *_heap) {
+        return;
+    }
+
+    for (i = 0; i < RADIX_NUM_OF_BUCKETS; ++i) {
+        bucket = (*_heap)->m_buckets + i;
+        for (j = 0; NULL != _elementDestroy && j < bucket->m_size; ++j) {
+            _elementDestroy(bucket->m_items[j].m_data);
+        }
+        free(bucket->m_items);
+    }
+    free(*_heap);
+    *_heap = NULL;
+}
+
+aps_ds_error RadixHeapPush(RadixHeap* _heap, uint64_t _key, void* _data) {
+    RadixBucket* bucket;
+    aps_ds_error result;
+    if (NULL == _heap) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_key < _heap->m_last) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    bucket = _heap->m_buckets + _BucketOf(_key, _heap->m_last);
+    if (bucket->m_size == bucket->m_capacity) {
+        result = _Reserve(bucket, bucket->m_size + 1);
+        if (DS_SUCCESS != result) {
+            return result;
+        }
+    }
+
+    bucket->m_items[bucket->m_size].m_key = _key;
+    bucket->m_items[bucket->m_size].m_data = _data;
+    ++bucket->m_size;
+    ++_heap->m_size;
+    return DS_SUCCESS;
+}
+
+aps_ds_error RadixHeapPop(RadixHeap* _heap, uint64_t* _pKey, void** _pValue) {
+    RadixBucket* bucket;
+    aps_ds_error result;
+    if (NULL == _heap || NULL == _pValue) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (0 == _heap->m_size) {
+        return DS_OUT_OF_BOUNDS_ERROR;
+    }
+
+    bucket = _heap->m_buckets;
+    if (0 == bucket->m_size) {
+        result = _Redistribute(_heap);
+        if (DS_SUCCESS != result) {
+            return result;
+        }
+    }
+
+    /* all keys of bucket 0 equal m_last, any of them will do */
+    --bucket->m_size;
+    if (NULL != _pKey) {
+        *_pKey = bucket->m_items[bucket->m_size].m_key;
+    }
+    *_pValue = bucket->m_items[bucket->m_size].m_data;
+    --_heap->m_size;
+    return DS_SUCCESS;
+}
+
+ssize_t RadixHeapSize(const RadixHeap* _heap) {
+    if (NULL == _heap) {
+        return -1;
+    }
+    return (ssize_t)_heap->m_size;
+}
+
+/* 0 when the keys are equal, else one more than the index of the highest differing bit */
+static size_t _BucketOf(uint64_t _key, uint64_t _last) {
+    uint64_t diff = _key ^ _last;
+    size_t bucket = 0;
+    size_t shift;
+
+    for (shift = 32; shift > 0; shift /= 2) {
+        if (diff >> shift) {
+            diff >>= shift;
+            bucket += shift;
+        }
+    }
+    return bucket + (size_t)diff;
+}
+
+static aps_ds_error _Reserve(RadixBucket* _bucket, size_t _capacity) {
+    RadixItem* items;
+    size_t capacity = _bucket->m_capacity < RADIX_FIRST_CAPACITY ? RADIX_FIRST_CAPACITY : _bucket->m_capacity;
+
+    while (capacity < _capacity) {
+        capacity *= 2;
+    }
+    if (capacity == _bucket->m_capacity) {
+        return DS_SUCCESS;
+    }
+
+    if (capacity > ((size_t)-1) / sizeof(RadixItem)) {
+        return DS_OVERFLOW_ERROR;
+    }
+
+    items = (RadixItem*)realloc(_bucket->m_items, capacity * sizeof(RadixItem));
+    if (NULL == items) {
+        return NULL == _bucket->m_items ? DS_ALLOCATION_ERROR : DS_REALLOCATION_ERROR;
+    }
+    _bucket->m_items = items;
+    _bucket->m_capacity = capacity;
+    return DS_SUCCESS;
+}
+
+/* bucket 0 is empty: the smallest key of the lowest bucket in use becomes m_last and that bucket
+ * is spread over the lower ones. Room is made in every target first so a failure changes nothing */
+static aps_ds_error _Redistribute(RadixHeap* _heap) {
+    size_t counts[RADIX_NUM_OF_BUCKETS];
+    RadixBucket* source;
+    RadixBucket* target;
+    uint64_t last;
+    size_t from;
+    size_t i;
+    aps_ds_error result;
+
+    for (from = 1; 0 == _heap->m_buckets[from].m_size; ++from) {
+    }
+    source = _heap->m_buckets + from;
+
+    last = source->m_items[0].m_key;
+    for (i = 1; i < source->m_size; ++i) {
+        last = source->m_items[i].m_key < last ? source->m_items[i].m_key : last;
+    }
+
+    for (i = 0; i < from; ++i) {
+        counts[i] = 0;
+    }
+    for (i = 0; i < source->m_size; ++i) {
+        ++counts[_BucketOf(source->m_items[i].m_key, last)];
+    }
+    for (i = 0; i < from; ++i) {
+        target = _heap->m_buckets + i;
+        if (0 != counts[i] && DS_SUCCESS != (result = _Reserve(target, target->m_size + counts[i]))) {
+            return result;
+        }
+    }
+
+    _heap->m_last = last;
+    for (i = 0; i < source->m_size; ++i) {
+        target = _heap->m_buckets + _BucketOf(source->m_items[i].m_key, last);
+        target->m_items[target->m_size++] = source->m_items[i];
+    }
+    source->m_size = 0;
+    return DS_SUCCESS;
+}
@@ -0,0 +1,481 @@
+#include "rcu_hash.h"
+#include "hash_internal.h"
+#include <pthread.h> /*< mutex >*/
+#include <sched.h>   /*< sched_yield >*/
+#include <stdlib.h>  /*< malloc >*/
+
+#define RCU_CACHE_LINE (64)
+#define RCU_QUIESCENT (0)
+
+typedef struct RCUNode {
+    struct RCUNode* m_next; /*< next node in the chain, published with release >*/
+    void* m_key;
+    void* m_value;
+    size_t m_hash;          /*< cached hash, compared before calling equality >*/
+} RCUNode;
+
+typedef struct RCUTable {
+    RCUNode** m_buckets;
+    size_t m_capacity;
+} RCUTable;
+
+struct RCUReader {
+    size_t m_epoch;   /*< epoch announced on entry, RCU_QUIESCENT when outside >*/
+    size_t m_nesting; /*< depth of nested read sections >*/
+    size_t m_inUse;   /*< slot taken by an attached reader >*/
+    RCUHashMap* m_map;
+};
+
+typedef union RCUReaderSlot {
+    RCUReader m_reader;
+    char m_pad[RCU_CACHE_LINE]; /*< one reader per cache line, no false sharing >*/
+} RCUReaderSlot;
+
+typedef void (*RCUReclaimFunc)(RCUHashMap* _map, void* _item);
+
+typedef struct RCURetired {
+    struct RCURetired* m_next;
+    size_t m_epoch;             /*< global epoch at the time of unlink >*/
+    void* m_item;
+    RCUReclaimFunc m_reclaim;
+} RCURetired;
+
+struct RCUHashMap {
+    RCUTable* m_table;          /*< current table, read with acquire >*/
+    size_t m_epoch;             /*< global epoch, starts at 1 >*/
+    size_t m_size;
+    RCUReaderSlot* m_slots;     /*< cache line aligned reader slots >*/
+    void* m_slotsMemory;        /*< unaligned allocation of m_slots >*/
+    size_t m_maxReaders;
+    RCURetired* m_retired;      /*< limbo list, writer owned >*/
+    pthread_mutex_t m_writeLock;
+    HashFunction m_hashFunc;
+    EqualityFunction m_keysEqualFunc;
+    ElementDestroy m_keyDestroy;
+    ElementDestroy m_valDestroy;
+};
+
+static RCUTable* _CreateTable(size_t _capacity);
+static void _FreeTable(RCUTable* _table);
+static RCUNode* _FindInChain(const RCUHashMap* _map, RCUNode* _node, const void* _key, size_t _hash);
+static aps_ds_error _Rehash(RCUHashMap* _map, size_t _newCapacity);
+static aps_ds_error _Retire(RCUHashMap* _map, void* _item, RCUReclaimFunc _reclaim);
+static size_t _OldestActiveEpoch(const RCUHashMap* _map);
+static void _Reclaim(RCUHashMap* _map, size_t _safeEpoch);
+static void _ReclaimNode(RCUHashMap* _map, void* _item);
+static void _ReclaimTable(RCUHashMap* _map, void* _item);
+static void _DestroyPair(const RCUHashMap* _map, RCUNode* _node);
+
+RCUHashMap* RCUHashMapCreate(size_t _capacity, size_t _maxReaders, HashFunction _hashFunc, EqualityFunction _keysEqualFunc,
+                             ElementDestroy _keyDestroy, ElementDestroy _valDestroy) {
+    RCUHashMap* map;
+    size_t i;
+
+    if (NULL == _hashFunc || NULL == _keysEqualFunc || 0 == _maxReaders) {
+        return NULL;
+    }
+
+    map = (RCUHashMap*)malloc(sizeof(RCUHashMap));
+    if (NULL == map) {
+        return NULL;
+    }
+
+    map->m_slotsMemory = malloc((_maxReaders + 1) * sizeof(RCUReaderSlot));
+    if (NULL == map->m_slotsMemory) {
+        free(map);
+        return NULL;
+    }
+
+    map->m_table = _CreateTable(HashNextPrime(_capacity));
+    if (NULL == map->m_table) {
+        free(map->m_slotsMemory);
+        free(map);
+        return NULL;
+    }
+
+    if (0 != pthread_mutex_init(&map->m_writeLock, NULL)) {
+        _FreeTable(map->m_table);
+        free(map->m_slotsMemory);
+        free(map);
+        return NULL;
+    }
+
+    map->m_slots = (RCUReaderSlot*)(((size_t)map->m_slotsMemory + RCU_CACHE_LINE - 1) & ~(size_t)(RCU_CACHE_LINE - 1));
+    for (i = 0; i < _maxReaders; ++i) {
+        map->m_slots[i].m_reader.m_epoch = RCU_QUIESCENT;
+        map->m_slots[i].m_reader.m_nesting = 0;
+        map->m_slots[i].m_reader.m_inUse = 0;
+        map->m_slots[i].m_reader.m_map = map;
+    }
+
+    map->m_epoch = 1;
+    map->m_size = 0;
+    map->m_maxReaders = _maxReaders;
+    map->m_retired = NULL;
+    map->m_hashFunc = _hashFunc;
+    map->m_keysEqualFunc = _keysEqualFunc;
+    map->m_keyDestroy = _keyDestroy;
+    map->m_valDestroy = _valDestroy;
+    return map;
+}
+
+void RCUHashMapDestroy(RCUHashMap** _map) {
+    RCUTable* table;
+    RCUNode* node;
+    size_t i;
+
+    if (NULL == _map || NULL == *_map) {
+        return;
+    }
+
+    _Reclaim(*_map, (size_t)-1);
+    table = (*_map)->m_table;
+    for (i = 0; i < table->m_capacity; ++i) {
+        for (node = table->m_buckets[i]; NULL != node; node = node->m_next) {
+            _DestroyPair(*_map, node);
+        }
+    }
+
+    _FreeTable(table);
+    pthread_mutex_destroy(&(*_map)->m_writeLock);
+    free((*_map)->m_slotsMemory);
+    free(*_map);
+    *_map = NULL;
+}
+
+RCUReader* RCUHashMapReaderAttach(RCUHashMap* _map) {
+    size_t i;
+    if (NULL == _map) {
+        return NULL;
+    }
+
+    for (i = 0; i < _map->m_maxReaders; ++i) {
+        if (__sync_bool_compare_and_swap(&_map->m_slots[i].m_reader.m_inUse, 0, 1)) {
+            _map->m_slots[i].m_reader.m_nesting = 0;
+            return &_map->m_slots[i].m_reader;
+        }
+    }
+    return NULL;
+}
+
+void RCUHashMapReaderDetach(RCUReader** _reader) {
+    if (NULL == _reader || NULL == *_reader) {
+        return;
+    }
+
+    __atomic_store_n(&(*_reader)->m_epoch, RCU_QUIESCENT, __ATOMIC_RELEASE);
+    __atomic_store_n(&(*_reader)->m_inUse, 0, __ATOMIC_RELEASE);
+    *_reader = NULL;
+}
+
+void RCUHashMapReadBegin(RCUReader* _reader) {
+    if (NULL == _reader) {
+        return;
+    }
+
+    if (0 == _reader->m_nesting++) {
+        __atomic_store_n(&_reader->m_epoch, __atomic_load_n(&_reader->m_map->m_epoch, __ATOMIC_ACQUIRE), __ATOMIC_RELAXED);
+        /* pairs with the writer's unlink, a reader either misses the node or is seen by _OldestActiveEpoch */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+}
+
+void RCUHashMapReadEnd(RCUReader* _reader) {
+    if (NULL == _reader || 0 == _reader->m_nesting) {
+        return;
+    }
+
+    if (0 == --_reader->m_nesting) {
+        __atomic_store_n(&_reader->m_epoch, RCU_QUIESCENT, __ATOMIC_RELEASE);
+    }
+}
+
+aps_ds_error RCUHashMapFind(RCUReader* _reader, const void* _searchKey, void** _pValue) {
+    const RCUHashMap* map;
+    RCUTable* table;
+    RCUNode* node;
+    size_t hash;
+
+    if (NULL == _reader || NULL == _pValue) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (NULL == _searchKey) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    map = _reader->m_map;
+    hash = map->m_hashFunc(_searchKey);
+
+    RCUHashMapReadBegin(_reader);
+    table = __atomic_load_n(&((RCUHashMap*)map)->m_table, __ATOMIC_ACQUIRE);
+    node = __atomic_load_n(&table->m_buckets[hash % table->m_capacity], __ATOMIC_ACQUIRE);
+    node = _FindInChain(map, node, _searchKey, hash);
+    if (NULL != node) {
+        *_pValue = node->m_value;
+    }
+    RCUHashMapReadEnd(_reader);
+
+    return (NULL == node) ? DS_ELEMENT_NOT_FOUND_ERROR : DS_SUCCESS;
+}
+
+aps_ds_error RCUHashMapInsert(RCUHashMap* _map, const void* _key, const void* _value) {
+    RCUTable* table;
+    RCUNode* node;
+    size_t hash;
+    size_t idx;
+
+    if (NULL == _map || NULL == _value) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (NULL == _key) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    hash = _map->m_hashFunc(_key);
+    pthread_mutex_lock(&_map->m_writeLock);
+    table = _map->m_table;
+    idx = hash % table->m_capacity;
+    if (NULL != _FindInChain(_map, table->m_buckets[idx], _key, hash)) {
+        pthread_mutex_unlock(&_map->m_writeLock);
+        return DS_KEY_EXISTS_ERROR;
+    }
+
+    node = (RCUNode*)malloc(sizeof(RCUNode));
+    if (NULL == node) {
+        pthread_mutex_unlock(&_map->m_writeLock);
+        return DS_ALLOCATION_ERROR;
+    }
+
+    node->m_key = (void*)_key;
+    node->m_value = (void*)_value;
+    node->m_hash = hash;
+    node->m_next = table->m_buckets[idx];
+    __atomic_store_n(&table->m_buckets[idx], node, __ATOMIC_RELEASE);
+    __atomic_store_n(&_map->m_size, _map->m_size + 1, __ATOMIC_RELAXED);
+
+    /* growing is best effort, a failed rehash leaves longer chains only */
+    if (_map->m_size > table->m_capacity) {
+        _Rehash(_map, table->m_capacity * 2);
+    }
+
+    pthread_mutex_unlock(&_map->m_writeLock);
+    return DS_SUCCESS;
+}
+
+aps_ds_error RCUHashMapRemove(RCUHashMap* _map, const void* _searchKey) {
+    RCUTable* table;
+    RCUNode** link;
+    RCUNode* node;
+    size_t hash;
+    aps_ds_error result;
+
+    if (NULL == _map) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (NULL == _searchKey) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    hash = _map->m_hashFunc(_searchKey);
+    pthread_mutex_lock(&_map->m_writeLock);
+    table = _map->m_table;
+    link = &table->m_buckets[hash % table->m_capacity];
+    for (node = *link; NULL != node; link = &node->m_next, node = *link) {
+        if (node->m_hash == hash && _map->m_keysEqualFunc(_searchKey, node->m_key)) {
+            break;
+        }
+    }
+
+    if (NULL == node) {
+        pthread_mutex_unlock(&_map->m_writeLock);
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    __atomic_store_n(link, node->m_next, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&_map->m_size, _map->m_size - 1, __ATOMIC_RELAXED);
+    result = _Retire(_map, node, _ReclaimNode);
+    pthread_mutex_unlock(&_map->m_writeLock);
+    return result;
+}
+
+aps_ds_error RCUHashMapRehash(RCUHashMap* _map, size_t _newCapacity) {
+    aps_ds_error result;
+    if (NULL == _map) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    pthread_mutex_lock(&_map->m_writeLock);
+    result = _Rehash(_map, _newCapacity);
+    pthread_mutex_unlock(&_map->m_writeLock);
+    return result;
+}
+
+void RCUHashMapSynchronize(RCUHashMap* _map) {
+    size_t target;
+    if (NULL == _map) {
+        return;
+    }
+
+    pthread_mutex_lock(&_map->m_writeLock);
+    target = __atomic_add_fetch(&_map->m_epoch, 1, __ATOMIC_SEQ_CST);
+    while (_OldestActiveEpoch(_map) < target) {
+        sched_yield();
+    }
+    _Reclaim(_map, target);
+    pthread_mutex_unlock(&_map->m_writeLock);
+}
+
+size_t RCUHashMapSize(const RCUHashMap* _map) {
+    if (NULL == _map) {
+        return 0;
+    }
+    return __atomic_load_n(&_map->m_size, __ATOMIC_RELAXED);
+}
+
+static RCUNode* _FindInChain(const RCUHashMap* _map, RCUNode* _node, const void* _key, size_t _hash) {
+    while (NULL != _node) {
+        if (_node->m_hash == _hash && _map->m_keysEqualFunc(_key, _node->m_key)) {
+            return _node;
+        }
+        _node = __atomic_load_n(&_node->m_next, __ATOMIC_ACQUIRE);
+    }
+    return NULL;
+}
+
+/* old nodes stay reachable through the old table, so the new table gets copies */
+static aps_ds_error _Rehash(RCUHashMap* _map, size_t _newCapacity) {
+    RCUTable* oldTable = _map->m_table;
+    RCUTable* newTable;
+    RCUNode* node;
+    RCUNode* copy;
+    size_t idx;
+    size_t i;
+
+    newTable = _CreateTable(HashNextPrime(_newCapacity));
+    if (NULL == newTable) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    for (i = 0; i < oldTable->m_capacity; ++i) {
+        for (node = oldTable->m_buckets[i]; NULL != node; node = node->m_next) {
+            copy = (RCUNode*)malloc(sizeof(RCUNode));
+            if (NULL == copy) {
+                _FreeTable(newTable);
+                return DS_ALLOCATION_ERROR;
+            }
+            *copy = *node;
+            idx = copy->m_hash % newTable->m_capacity;
+            copy->m_next = newTable->m_buckets[idx];
+            newTable->m_buckets[idx] = copy;
+        }
+    }
+
+    __atomic_store_n(&_map->m_table, newTable, __ATOMIC_SEQ_CST);
+    return _Retire(_map, oldTable, _ReclaimTable);
+}
+
+static aps_ds_error _Retire(RCUHashMap* _map, void* _item, RCUReclaimFunc _reclaim) {
+    RCURetired* retired = (RCURetired*)malloc(sizeof(RCURetired));
+    if (NULL == retired) {
+        /* nothing to track it with, wait for every reader and reclaim right away */
+        size_t target = __atomic_add_fetch(&_map->m_epoch, 1, __ATOMIC_SEQ_CST);
+        while (_OldestActiveEpoch(_map) < target) {
+            sched_yield();
+        }
+        _reclaim(_map, _item);
+        return DS_SUCCESS;
+    }
+
+    retired->m_item = _item;
+    retired->m_reclaim = _reclaim;
+    retired->m_epoch = __atomic_fetch_add(&_map->m_epoch, 1, __ATOMIC_SEQ_CST);
+    retired->m_next = _map->m_retired;
+    _map->m_retired = retired;
+
+    _Reclaim(_map, _OldestActiveEpoch(_map));
+    return DS_SUCCESS;
+}
+
+static size_t _OldestActiveEpoch(const RCUHashMap* _map) {
+    size_t oldest = __atomic_load_n(&_map->m_epoch, __ATOMIC_SEQ_CST);
+    size_t epoch;
+    size_t i;
+
+    for (i = 0; i < _map->m_maxReaders; ++i) {
+        epoch = __atomic_load_n(&_map->m_slots[i].m_reader.m_epoch, __ATOMIC_SEQ_CST);
+        if (RCU_QUIESCENT != epoch && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+    return oldest;
+}
+
+/* frees every item retired before _safeEpoch, no reader can still hold it */
+static void _Reclaim(RCUHashMap* _map, size_t _safeEpoch) {
+    RCURetired** link = &_map->m_retired;
+    RCURetired* retired;
+
+    while (NULL != *link) {
+        retired = *link;
+        if (retired->m_epoch < _safeEpoch) {
+            *link = retired->m_next;
+            retired->m_reclaim(_map, retired->m_item);
+            free(retired);
+        } else {
+            link = &retired->m_next;
+        }
+    }
+}
+
+static void _ReclaimNode(RCUHashMap* _map, void* _item) {
+    _DestroyPair(_map, (RCUNode*)_item);
+    free(_item);
+}
+
+static void _ReclaimTable(RCUHashMap* _map, void* _item) {
+    (void)_map;
+    _FreeTable((RCUTable*)_item);
+}
+
+static void _DestroyPair(const RCUHashMap* _map, RCUNode* _node) {
+    if (NULL != _map->m_keyDestroy) {
+        _map->m_keyDestroy(_node->m_key);
+    }
+    if (NULL != _map->m_valDestroy) {
+        _map->m_valDestroy(_node->m_value);
+    }
+}
+
+static RCUTable* _CreateTable(size_t _capacity) {
+    RCUTable* table = (RCUTable*)malloc(sizeof(RCUTable));
+    if (NULL == table) {
+        return NULL;
+    }
+
+    table->m_buckets = (RCUNode**)calloc(_capacity, sizeof(RCUNode*));
+    if (NULL == table->m_buckets) {
+        free(table);
+        return NULL;
+    }
+
+    table->m_capacity = _capacity;
+    return table;
+}
+
+static void _FreeTable(RCUTable* _table) {
+    RCUNode* node;
+    RCUNode* next;
+    size_t i;
+
+    for (i = 0; i < _table->m_capacity; ++i) {
+        for (node = _table->m_buckets[i]; NULL != node; node = next) {
+            next = node->m_next;
+            free(node);
+        }
+    }
+    free(_table->m_buckets);
+    free(_table);
+}
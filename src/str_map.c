@@ -0,0 +1,400 @@
+#include "str_map.h"
+#include "hash_internal.h"
+#include <stdint.h> /*< uint64_t >*/
+#include <stdlib.h> /*< calloc >*/
+#include <string.h> /*< memcmp >*/
+
+#define STR_MIN_SLOTS (8)
+#define STR_EMPTY_HASH (0)
+#define STR_ARENA_BLOCK (4096)
+#define STR_MAX_KEY_LENGTH ((size_t)0xffffffff)
+
+typedef struct StrSlot {
+    uint64_t m_hash;                 /*< STR_EMPTY_HASH marks a free slot >*/
+    void* m_value;
+    uint32_t m_length;
+    char m_key[STR_MAP_INLINE_KEY];  /*< the key itself, or the address of its arena copy >*/
+} StrSlot;
+
+typedef struct StrArenaBlock {
+    struct StrArenaBlock* m_next;    /*< the key bytes follow the header >*/
+} StrArenaBlock;
+
+struct StrMap {
+    StrSlot* m_slots;
+    size_t m_mask;          /*< number of slots - 1, a power of two minus one >*/
+    size_t m_size;
+    StrArenaBlock* m_blocks;
+    char* m_arenaCursor;    /*< free space of the newest shared block >*/
+    size_t m_arenaLeft;
+    size_t m_liveBytes;     /*< arena bytes of the keys in the map >*/
+    size_t m_deadBytes;     /*< arena bytes of removed keys, reclaimed by _CompactArena >*/
+};
+
+static size_t _SlotsFor(size_t _capacity);
+static uint64_t _HashKey(const char* _key, size_t _keyLength);
+static const char* _SlotKey(const StrSlot* _slot);
+static StrSlot* _FindSlot(const StrMap* _map, const char* _key, size_t _keyLength, uint64_t _hash);
+static aps_ds_error _CopyKey(StrMap* _map, StrSlot* _slot, const char* _key, size_t _keyLength);
+static char* _ArenaAlloc(StrMap* _map, size_t _size);
+static void _FreeArena(StrArenaBlock* _blocks);
+static void _CompactArena(StrMap* _map);
+static void _Place(StrSlot* _slots, size_t _mask, const StrSlot* _slot);
+static aps_ds_error _Grow(StrMap* _map);
+static void _ShiftBack(StrMap* _map, size_t _hole);
+
+StrMap* StrMapCreate(size_t _capacity) {
+    StrMap* map;
+    size_t numOfSlots = _SlotsFor(_capacity);
+
+    if (numOfSlots == 0) {
+        return NULL;
+    }
+
+    map = (StrMap*)malloc(sizeof(StrMap));
+    if (map == NULL) {
+        return NULL;
+    }
+
+    map->m_slots = (StrSlot*)calloc(numOfSlots, sizeof(StrSlot));
+    if (map->m_slots == NULL) {
+        free(map);
+        return NULL;
+    }
+
+    map->m_mask = numOfSlots - 1;
+    map->m_size = 0;
+    map->m_blocks = NULL;
+    map->m_arenaCursor = NULL;
+    map->m_arenaLeft = 0;
+    map->m_liveBytes = 0;
+    map->m_deadBytes = 0;
+    return map;
+}
+
+void StrMapDestroy(StrMap** _map, void (*_valDestroy)(void* _value)) {
+    size_t idx;
+
+    if (_map == NULL || *_map == NULL) {
+        return;
+    }
+
+    for (idx = 0; _valDestroy != NULL && idx <= (*_map)->m_mask; ++idx) {
+        if ((*_map)->m_slots[idx].m_hash != STR_EMPTY_HASH) {
+            _valDestroy((*_map)->m_slots[idx].m_value);
+        }
+    }
+
+    _FreeArena((*_map)->m_blocks);
+    free((*_map)->m_slots);
+    free(*_map);
+    *_map = NULL;
+}
+
+aps_ds_error StrMapInsert(StrMap* _map, const char* _key, size_t _keyLength, const void* _value) {
+    StrSlot slot;
+
+    if (_map == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_key == NULL || _keyLength > STR_MAX_KEY_LENGTH) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    slot.m_hash = _HashKey(_key, _keyLength);
+    if (_FindSlot(_map, _key, _keyLength, slot.m_hash) != NULL) {
+        return DS_KEY_EXISTS_ERROR;
+    }
+
+    if ((_map->m_size + 1) * 4 > (_map->m_mask + 1) * 3 && _Grow(_map) != DS_SUCCESS) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    if (_CopyKey(_map, &slot, _key, _keyLength) != DS_SUCCESS) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    slot.m_value = (void*)_value;
+    _Place(_map->m_slots, _map->m_mask, &slot);
+    ++_map->m_size;
+    return DS_SUCCESS;
+}
+
+aps_ds_error StrMapRemove(StrMap* _map, const char* _key, size_t _keyLength, void** _pValue) {
+    StrSlot* slot;
+
+    if (_map == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_key == NULL) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    slot = _FindSlot(_map, _key, _keyLength, _HashKey(_key, _keyLength));
+    if (slot == NULL) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    if (_pValue != NULL) {
+        *_pValue = slot->m_value;
+    }
+    if (slot->m_length > STR_MAP_INLINE_KEY) {
+        _map->m_liveBytes -= slot->m_length;
+        _map->m_deadBytes += slot->m_length;
+    }
+    _ShiftBack(_map, (size_t)(slot - _map->m_slots));
+    --_map->m_size;
+
+    /* dead bytes past both the live ones and the table pay for copying the live keys and scanning the slots */
+    if (_map->m_deadBytes > _map->m_liveBytes && _map->m_deadBytes / sizeof(StrSlot) > _map->m_mask) {
+        _CompactArena(_map);
+    }
+    return DS_SUCCESS;
+}
+
+aps_ds_error StrMapFind(const StrMap* _map, const char* _key, size_t _keyLength, void** _pValue) {
+    StrSlot* slot;
+
+    if (_map == NULL || _pValue == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_key == NULL) {
+        return DS_INVALID_PARAM_ERROR;
+    }
+
+    slot = _FindSlot(_map, _key, _keyLength, _HashKey(_key, _keyLength));
+    if (slot == NULL) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    *_pValue = slot->m_value;
+    return DS_SUCCESS;
+}
+
+size_t StrMapSize(const StrMap* _map) {
+    if (_map == NULL) {
+        return 0;
+    }
+    return _map->m_size;
+}
+
+size_t StrMapForEach(const StrMap* _map, StrActionFunction _action, void* _context) {
+    const StrSlot* slot;
+    size_t idx;
+    size_t count = 0;
+
+    if (_map == NULL || _action == NULL) {
+        return 0;
+    }
+
+    for (idx = 0; idx <= _map->m_mask; ++idx) {
+        slot = &_map->m_slots[idx];
+        if (slot->m_hash != STR_EMPTY_HASH) {
+            ++count;
+            if (_action(_SlotKey(slot), slot->m_length, slot->m_value, _context) == 0) {
+                return count;
+            }
+        }
+    }
+    return count;
+}
+
+/* smallest power of two that keeps _capacity pairs under three quarters load, 0 on overflow */
+static size_t _SlotsFor(size_t _capacity) {
+    size_t numOfSlots = STR_MIN_SLOTS;
+    while (_capacity > numOfSlots / 4 * 3) {
+        if (numOfSlots > ((size_t)-1) / 2 / sizeof(StrSlot)) {
+            return 0;
+        }
+        numOfSlots *= 2;
+    }
+    return numOfSlots;
+}
+
+/* eight bytes per round, every round is fed through the 64 bit finalizer */
+static uint64_t _HashKey(const char* _key, size_t _keyLength) {
+    uint64_t hash = HashMix64(_keyLength);
+    uint64_t word;
+    size_t i;
+
+    for (i = 0; i + sizeof(word) <= _keyLength; i += sizeof(word)) {
+        memcpy(&word, _key + i, sizeof(word));
+        hash = HashMix64(hash ^ word);
+    }
+
+    if (i < _keyLength) {
+        word = 0;
+        memcpy(&word, _key + i, _keyLength - i);
+        hash = HashMix64(hash ^ word);
+    }
+    return (hash == STR_EMPTY_HASH) ? 1 : hash;
+}
+
+static const char* _SlotKey(const StrSlot* _slot) {
+    const char* key;
+    if (_slot->m_length <= STR_MAP_INLINE_KEY) {
+        return _slot->m_key;
+    }
+    memcpy(&key, _slot->m_key, sizeof(key));
+    return key;
+}
+
+static StrSlot* _FindSlot(const StrMap* _map, const char* _key, size_t _keyLength, uint64_t _hash) {
+    StrSlot* slot;
+    size_t idx;
+
+    for (idx = (size_t)_hash & _map->m_mask; _map->m_slots[idx].m_hash != STR_EMPTY_HASH; idx = (idx + 1) & _map->m_mask) {
+        slot = &_map->m_slots[idx];
+        if (slot->m_hash == _hash && slot->m_length == _keyLength
+            && memcmp(_SlotKey(slot), _key, _keyLength) == 0) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+static aps_ds_error _CopyKey(StrMap* _map, StrSlot* _slot, const char* _key, size_t _keyLength) {
+    char* copy;
+
+    _slot->m_length = (uint32_t)_keyLength;
+    if (_keyLength <= STR_MAP_INLINE_KEY) {
+        memcpy(_slot->m_key, _key, _keyLength);
+        return DS_SUCCESS;
+    }
+
+    copy = _ArenaAlloc(_map, _keyLength);
+    if (copy == NULL) {
+        return DS_ALLOCATION_ERROR;
+    }
+    memcpy(copy, _key, _keyLength);
+    memcpy(_slot->m_key, &copy, sizeof(copy));
+    _map->m_liveBytes += _keyLength;
+    return DS_SUCCESS;
+}
+
+/* keys bigger than a quarter block get a block of their own, the shared block keeps its free space */
+static char* _ArenaAlloc(StrMap* _map, size_t _size) {
+    StrArenaBlock* block;
+    size_t blockSize = (_size > STR_ARENA_BLOCK / 4) ? _size : STR_ARENA_BLOCK;
+    char* memory;
+
+    if (_size <= _map->m_arenaLeft) {
+        memory = _map->m_arenaCursor;
+        _map->m_arenaCursor += _size;
+        _map->m_arenaLeft -= _size;
+        return memory;
+    }
+
+    block = (StrArenaBlock*)malloc(sizeof(StrArenaBlock) + blockSize);
+    if (block == NULL) {
+        return NULL;
+    }
+    block->m_next = _map->m_blocks;
+    _map->m_blocks = block;
+    memory = (char*)(block + 1);
+
+    if (blockSize == STR_ARENA_BLOCK) {
+        _map->m_arenaCursor = memory + _size;
+        _map->m_arenaLeft = blockSize - _size;
+    }
+    return memory;
+}
+
+static void _FreeArena(StrArenaBlock* _blocks) {
+    StrArenaBlock* block;
+    while (_blocks != NULL) {
+        block = _blocks;
+        _blocks = block->m_next;
+        free(block);
+    }
+}
+
+/* copies the live long keys into one block of their exact size and frees the old blocks.
+ * Without memory for the copy the old arena is kept and compaction is tried on a later remove */
+static void _CompactArena(StrMap* _map) {
+    StrArenaBlock* block;
+    char* cursor;
+    const char* key;
+    size_t idx;
+
+    block = NULL;
+    if (_map->m_liveBytes > 0) {
+        block = (StrArenaBlock*)malloc(sizeof(StrArenaBlock) + _map->m_liveBytes);
+        if (block == NULL) {
+            return;
+        }
+        block->m_next = NULL;
+
+        cursor = (char*)(block + 1);
+        for (idx = 0; idx <= _map->m_mask; ++idx) {
+            if (_map->m_slots[idx].m_hash != STR_EMPTY_HASH && _map->m_slots[idx].m_length > STR_MAP_INLINE_KEY) {
+                key = _SlotKey(&_map->m_slots[idx]);
+                memcpy(cursor, key, _map->m_slots[idx].m_length);
+                memcpy(_map->m_slots[idx].m_key, &cursor, sizeof(cursor));
+                cursor += _map->m_slots[idx].m_length;
+            }
+        }
+    }
+
+    _FreeArena(_map->m_blocks);
+    _map->m_blocks = block;
+    _map->m_arenaCursor = NULL;
+    _map->m_arenaLeft = 0;
+    _map->m_deadBytes = 0;
+}
+
+static void _Place(StrSlot* _slots, size_t _mask, const StrSlot* _slot) {
+    size_t idx;
+    for (idx = (size_t)_slot->m_hash & _mask; _slots[idx].m_hash != STR_EMPTY_HASH; idx = (idx + 1) & _mask) {
+    }
+    _slots[idx] = *_slot;
+}
+
+/* the stored hashes are reused, no key is read */
+static aps_ds_error _Grow(StrMap* _map) {
+    StrSlot* newSlots;
+    size_t oldNumOfSlots = _map->m_mask + 1;
+    size_t i;
+
+    if (oldNumOfSlots > ((size_t)-1) / 2 / sizeof(StrSlot)) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    newSlots = (StrSlot*)calloc(oldNumOfSlots * 2, sizeof(StrSlot));
+    if (newSlots == NULL) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    for (i = 0; i < oldNumOfSlots; ++i) {
+        if (_map->m_slots[i].m_hash != STR_EMPTY_HASH) {
+            _Place(newSlots, oldNumOfSlots * 2 - 1, &_map->m_slots[i]);
+        }
+    }
+    free(_map->m_slots);
+    _map->m_slots = newSlots;
+    _map->m_mask = oldNumOfSlots * 2 - 1;
+    return DS_SUCCESS;
+}
+
+/* backward shift deletion: moves every following pair that may not skip the hole into it */
+static void _ShiftBack(StrMap* _map, size_t _hole) {
+    size_t idx = _hole;
+    size_t home;
+
+    for (;;) {
+        idx = (idx + 1) & _map->m_mask;
+        if (_map->m_slots[idx].m_hash == STR_EMPTY_HASH) {
+            break;
+        }
+
+        home = (size_t)_map->m_slots[idx].m_hash & _map->m_mask;
+        if (((idx - home) & _map->m_mask) >= ((idx - _hole) & _map->m_mask)) {
+            _map->m_slots[_hole] = _map->m_slots[idx];
+            _hole = idx;
+        }
+    }
+    _map->m_slots[_hole].m_hash = STR_EMPTY_HASH;
+}
@@ -0,0 +1,269 @@
+#include "ttl_map.h"
+#include "listInternal.h"
+#include <stdlib.h> /*< malloc >*/
+
+#define TTL_SLOT_BITS (6)
+#define TTL_SLOTS (1 << TTL_SLOT_BITS)
+#define TTL_SLOT_MASK ((uint64_t)TTL_SLOTS - 1)
+#define TTL_LEVELS (4)
+#define TTL_MAX_DELTA (((uint64_t)1 << (TTL_SLOT_BITS * TTL_LEVELS)) - 1)
+
+typedef struct TTLEntry {
+    Node m_links;       /*< links in the wheel slot, m_item points back at the entry >*/
+    void* m_key;
+    void* m_value;
+    uint64_t m_expires;
+} TTLEntry;
+
+struct TTLMap {
+    HashMap* m_map;     /*< key -> TTLEntry >*/
+    Node m_wheel[TTL_LEVELS][TTL_SLOTS]; /*< circular lists, each slot is its own sentinel >*/
+    uint64_t m_clock;   /*< next tick to process, the current time is m_clock - 1 >*/
+    TTLExpireFunction m_expireFunc;
+    void* m_context;
+    int m_lazyExpiry;
+};
+
+static void _Schedule(TTLMap* _map, TTLEntry* _entry);
+static void _Cascade(TTLMap* _map, size_t _level);
+static size_t _ExpireSlot(TTLMap* _map, Node* _slot);
+static void _Expire(TTLMap* _map, TTLEntry* _entry);
+static void _DestroySlot(Node* _slot, void (*_keyDestroy)(void* _key), void (*_valDestroy)(void* _value));
+
+TTLMap* TTLMapCreate(size_t _capacity, uint64_t _now, HashFunction _hashFunc, EqualityFunction _keysEqualFunc,
+                     TTLExpireFunction _expireFunc, void* _context, int _lazyExpiry) {
+    TTLMap* map;
+    size_t level;
+    size_t slot;
+
+    map = (TTLMap*)malloc(sizeof(TTLMap));
+    if (map == NULL) {
+        return NULL;
+    }
+
+    map->m_map = HashMapCreate(_capacity, _hashFunc, _keysEqualFunc);
+    if (map->m_map == NULL) {
+        free(map);
+        return NULL;
+    }
+
+    for (level = 0; level < TTL_LEVELS; ++level) {
+        for (slot = 0; slot < TTL_SLOTS; ++slot) {
+            map->m_wheel[level][slot].m_item = NULL;
+            map->m_wheel[level][slot].m_next = &map->m_wheel[level][slot];
+            map->m_wheel[level][slot].m_prev = &map->m_wheel[level][slot];
+        }
+    }
+    map->m_clock = _now + 1;
+    map->m_expireFunc = _expireFunc;
+    map->m_context = _context;
+    map->m_lazyExpiry = _lazyExpiry;
+    return map;
+}
+
+void TTLMapDestroy(TTLMap** _map, void (*_keyDestroy)(void* _key), void (*_valDestroy)(void* _value)) {
+    size_t level;
+    size_t slot;
+
+    if (_map == NULL || *_map == NULL) {
+        return;
+    }
+
+    for (level = 0; level < TTL_LEVELS; ++level) {
+        for (slot = 0; slot < TTL_SLOTS; ++slot) {
+            _DestroySlot(&(*_map)->m_wheel[level][slot], _keyDestroy, _valDestroy);
+        }
+    }
+    HashMapDestroy(&(*_map)->m_map, NULL, NULL);
+    free(*_map);
+    *_map = NULL;
+}
+
+aps_ds_error TTLMapInsert(TTLMap* _map, const void* _key, const void* _value, uint64_t _ttl) {
+    TTLEntry* entry;
+    aps_ds_error err;
+
+    if (_map == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    entry = (TTLEntry*)malloc(sizeof(TTLEntry));
+    if (entry == NULL) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    entry->m_links.m_item = entry;
+    entry->m_key = (void*)_key;
+    entry->m_value = (void*)_value;
+    entry->m_expires = _map->m_clock - 1 + _ttl;
+    if (entry->m_expires < _ttl) {
+        entry->m_expires = (uint64_t)-1;
+    }
+
+    err = HashMapInsert(_map->m_map, _key, entry);
+    if (err != DS_SUCCESS) {
+        free(entry);
+        return err;
+    }
+    _Schedule(_map, entry);
+    return DS_SUCCESS;
+}
+
+aps_ds_error TTLMapFind(TTLMap* _map, const void* _searchKey, uint64_t _now, void** _pValue) {
+    TTLEntry* entry;
+    aps_ds_error err;
+
+    if (_map == NULL || _pValue == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    err = HashMapFind(_map->m_map, _searchKey, (void**)&entry);
+    if (err != DS_SUCCESS) {
+        return err;
+    }
+
+    if (entry->m_expires <= _now) {
+        if (_map->m_lazyExpiry) {
+            _Expire(_map, entry);
+        }
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    *_pValue = entry->m_value;
+    return DS_SUCCESS;
+}
+
+aps_ds_error TTLMapRemove(TTLMap* _map, const void* _searchKey, void** _pKey, void** _pValue) {
+    TTLEntry* entry;
+    void* key;
+    aps_ds_error err;
+
+    if (_map == NULL || _pKey == NULL || _pValue == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    err = HashMapRemove(_map->m_map, _searchKey, &key, (void**)&entry);
+    if (err != DS_SUCCESS) {
+        return err;
+    }
+
+    PopNode(entry->m_links.m_prev, entry->m_links.m_next);
+    *_pKey = entry->m_key;
+    *_pValue = entry->m_value;
+    free(entry);
+    return DS_SUCCESS;
+}
+
+size_t TTLMapTick(TTLMap* _map, uint64_t _now) {
+    size_t count = 0;
+    size_t level;
+
+    if (_map == NULL) {
+        return 0;
+    }
+
+    for (; _map->m_clock <= _now && _map->m_clock != 0; ++_map->m_clock) {
+        if (HashMapSize(_map->m_map) == 0) {
+            _map->m_clock = _now;
+            continue;
+        }
+
+        /* a level is cascaded when every level below it wrapped around */
+        for (level = 1; level < TTL_LEVELS && ((_map->m_clock >> (TTL_SLOT_BITS * (level - 1))) & TTL_SLOT_MASK) == 0; ++level) {
+            _Cascade(_map, level);
+        }
+        count += _ExpireSlot(_map, &_map->m_wheel[0][_map->m_clock & TTL_SLOT_MASK]);
+    }
+    return count;
+}
+
+size_t TTLMapSize(const TTLMap* _map) {
+    if (_map == NULL) {
+        return 0;
+    }
+    return HashMapSize(_map->m_map);
+}
+
+/* links the entry at the coarsest level whose slot still resolves its expiry time, relative to m_clock */
+static void _Schedule(TTLMap* _map, TTLEntry* _entry) {
+    uint64_t expires = _entry->m_expires;
+    uint64_t delta;
+    size_t level;
+
+    if (expires < _map->m_clock) {
+        expires = _map->m_clock;
+    } else if (expires - _map->m_clock > TTL_MAX_DELTA) {
+        /* too far for the wheel, parked at its far end and rescheduled when that comes due */
+        expires = _map->m_clock + TTL_MAX_DELTA;
+    }
+
+    delta = expires - _map->m_clock;
+    for (level = 0; level + 1 < TTL_LEVELS && delta >= ((uint64_t)1 << (TTL_SLOT_BITS * (level + 1))); ++level) {
+    }
+    PushNode(&_map->m_wheel[level][(expires >> (TTL_SLOT_BITS * level)) & TTL_SLOT_MASK], &_entry->m_links);
+}
+
+/* moves the entries of the due slot of a level to the finer levels */
+static void _Cascade(TTLMap* _map, size_t _level) {
+    Node* slot = &_map->m_wheel[_level][(_map->m_clock >> (TTL_SLOT_BITS * _level)) & TTL_SLOT_MASK];
+    Node pending;
+    TTLEntry* entry;
+
+    if (slot->m_next == slot) {
+        return;
+    }
+
+    /* take the whole chain first, rescheduling may link entries back into the same slot */
+    pending.m_next = slot->m_next;
+    pending.m_prev = slot->m_prev;
+    pending.m_next->m_prev = &pending;
+    pending.m_prev->m_next = &pending;
+    slot->m_next = slot;
+    slot->m_prev = slot;
+
+    while (pending.m_next != &pending) {
+        entry = pending.m_next->m_item;
+        PopNode(&pending, entry->m_links.m_next);
+        _Schedule(_map, entry);
+    }
+}
+
+static size_t _ExpireSlot(TTLMap* _map, Node* _slot) {
+    size_t count = 0;
+    TTLEntry* entry;
+
+    while (_slot->m_next != _slot) {
+        entry = _slot->m_next->m_item;
+        _Expire(_map, entry);
+        ++count;
+    }
+    return count;
+}
+
+static void _Expire(TTLMap* _map, TTLEntry* _entry) {
+    void* key;
+    void* value;
+
+    PopNode(_entry->m_links.m_prev, _entry->m_links.m_next);
+    HashMapRemove(_map->m_map, _entry->m_key, &key, &value);
+    if (_map->m_expireFunc != NULL) {
+        _map->m_expireFunc(_entry->m_key, _entry->m_value, _map->m_context);
+    }
+    free(_entry);
+}
+
+static void _DestroySlot(Node* _slot, void (*_keyDestroy)(void* _key), void (*_valDestroy)(void* _value)) {
+    TTLEntry* entry;
+
+    while (_slot->m_next != _slot) {
+        entry = _slot->m_next->m_item;
+        PopNode(_slot, entry->m_links.m_next);
+        if (_keyDestroy != NULL) {
+            _keyDestroy(entry->m_key);
+        }
+        if (_valDestroy != NULL) {
+            _valDestroy(entry->m_value);
+        }
+        free(entry);
+    }
+}
@@ -0,0 +1,255 @@
+#include "u64_map.h"
+#include "hash_internal.h"
+#include <stdlib.h> /*< calloc >*/
+
+#define U64_MIN_SLOTS (8)
+#define U64_EMPTY_KEY (0)
+
+typedef struct U64Slot {
+    uint64_t m_key;   /*< U64_EMPTY_KEY marks a free slot >*/
+    uint64_t m_value;
+} U64Slot;
+
+struct U64Map {
+    U64Slot* m_slots;
+    size_t m_mask;        /*< number of slots - 1, a power of two minus one >*/
+    size_t m_size;        /*< pairs in m_slots, the empty key pair excluded >*/
+    int m_hasEmptyKey;    /*< the key equal to U64_EMPTY_KEY lives outside the table >*/
+    uint64_t m_emptyKeyValue;
+};
+
+static size_t _SlotsFor(size_t _capacity);
+static size_t _Home(const U64Map* _map, uint64_t _key);
+static U64Slot* _FindSlot(const U64Map* _map, uint64_t _key);
+static aps_ds_error _Grow(U64Map* _map);
+static void _ShiftBack(U64Map* _map, size_t _hole);
+
+U64Map* U64MapCreate(size_t _capacity) {
+    U64Map* map;
+    size_t numOfSlots = _SlotsFor(_capacity);
+
+    if (numOfSlots == 0) {
+        return NULL;
+    }
+
+    map = (U64Map*)malloc(sizeof(U64Map));
+    if (map == NULL) {
+        return NULL;
+    }
+
+    map->m_slots = (U64Slot*)calloc(numOfSlots, sizeof(U64Slot));
+    if (map->m_slots == NULL) {
+        free(map);
+        return NULL;
+    }
+
+    map->m_mask = numOfSlots - 1;
+    map->m_size = 0;
+    map->m_hasEmptyKey = 0;
+    map->m_emptyKeyValue = 0;
+    return map;
+}
+
+void U64MapDestroy(U64Map** _map) {
+    if (_map == NULL || *_map == NULL) {
+        return;
+    }
+
+    free((*_map)->m_slots);
+    free(*_map);
+    *_map = NULL;
+}
+
+aps_ds_error U64MapInsert(U64Map* _map, uint64_t _key, uint64_t _value) {
+    size_t idx;
+
+    if (_map == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_key == U64_EMPTY_KEY) {
+        if (_map->m_hasEmptyKey) {
+            return DS_KEY_EXISTS_ERROR;
+        }
+        _map->m_hasEmptyKey = 1;
+        _map->m_emptyKeyValue = _value;
+        return DS_SUCCESS;
+    }
+
+    if (_FindSlot(_map, _key) != NULL) {
+        return DS_KEY_EXISTS_ERROR;
+    }
+
+    if ((_map->m_size + 1) * 4 > (_map->m_mask + 1) * 3 && _Grow(_map) != DS_SUCCESS) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    for (idx = _Home(_map, _key); _map->m_slots[idx].m_key != U64_EMPTY_KEY; idx = (idx + 1) & _map->m_mask) {
+    }
+    _map->m_slots[idx].m_key = _key;
+    _map->m_slots[idx].m_value = _value;
+    ++_map->m_size;
+    return DS_SUCCESS;
+}
+
+aps_ds_error U64MapRemove(U64Map* _map, uint64_t _key, uint64_t* _pValue) {
+    U64Slot* slot;
+
+    if (_map == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_key == U64_EMPTY_KEY) {
+        if (!_map->m_hasEmptyKey) {
+            return DS_ELEMENT_NOT_FOUND_ERROR;
+        }
+        _map->m_hasEmptyKey = 0;
+        if (_pValue != NULL) {
+            *_pValue = _map->m_emptyKeyValue;
+        }
+        return DS_SUCCESS;
+    }
+
+    slot = _FindSlot(_map, _key);
+    if (slot == NULL) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    if (_pValue != NULL) {
+        *_pValue = slot->m_value;
+    }
+    _ShiftBack(_map, (size_t)(slot - _map->m_slots));
+    --_map->m_size;
+    return DS_SUCCESS;
+}
+
+aps_ds_error U64MapFind(const U64Map* _map, uint64_t _key, uint64_t* _pValue) {
+    U64Slot* slot;
+
+    if (_map == NULL || _pValue == NULL) {
+        return DS_UNINITIALIZED_ERROR;
+    }
+
+    if (_key == U64_EMPTY_KEY) {
+        if (!_map->m_hasEmptyKey) {
+            return DS_ELEMENT_NOT_FOUND_ERROR;
+        }
+        *_pValue = _map->m_emptyKeyValue;
+        return DS_SUCCESS;
+    }
+
+    slot = _FindSlot(_map, _key);
+    if (slot == NULL) {
+        return DS_ELEMENT_NOT_FOUND_ERROR;
+    }
+
+    *_pValue = slot->m_value;
+    return DS_SUCCESS;
+}
+
+size_t U64MapSize(const U64Map* _map) {
+    if (_map == NULL) {
+        return 0;
+    }
+    return _map->m_size + (_map->m_hasEmptyKey != 0);
+}
+
+size_t U64MapForEach(const U64Map* _map, U64ActionFunction _action, void* _context) {
+    size_t idx;
+    size_t count = 0;
+
+    if (_map == NULL || _action == NULL) {
+        return 0;
+    }
+
+    if (_map->m_hasEmptyKey) {
+        ++count;
+        if (_action(U64_EMPTY_KEY, _map->m_emptyKeyValue, _context) == 0) {
+            return count;
+        }
+    }
+
+    for (idx = 0; idx <= _map->m_mask; ++idx) {
+        if (_map->m_slots[idx].m_key != U64_EMPTY_KEY) {
+            ++count;
+            if (_action(_map->m_slots[idx].m_key, _map->m_slots[idx].m_value, _context) == 0) {
+                return count;
+            }
+        }
+    }
+    return count;
+}
+
+/* smallest power of two that keeps _capacity pairs under three quarters load, 0 on overflow */
+static size_t _SlotsFor(size_t _capacity) {
+    size_t numOfSlots = U64_MIN_SLOTS;
+    while (_capacity > numOfSlots / 4 * 3) {
+        if (numOfSlots > ((size_t)-1) / 2 / sizeof(U64Slot)) {
+            return 0;
+        }
+        numOfSlots *= 2;
+    }
+    return numOfSlots;
+}
+
+static size_t _Home(const U64Map* _map, uint64_t _key) {
+    return (size_t)HashMix64(_key) & _map->m_mask;
+}
+
+static U64Slot* _FindSlot(const U64Map* _map, uint64_t _key) {
+    size_t idx;
+    for (idx = _Home(_map, _key); _map->m_slots[idx].m_key != U64_EMPTY_KEY; idx = (idx + 1) & _map->m_mask) {
+        if (_map->m_slots[idx].m_key == _key) {
+            return &_map->m_slots[idx];
+        }
+    }
+    return NULL;
+}
+
+static aps_ds_error _Grow(U64Map* _map) {
+    U64Slot* oldSlots = _map->m_slots;
+    size_t oldNumOfSlots = _map->m_mask + 1;
+    size_t i;
+    size_t idx;
+
+    if (oldNumOfSlots > ((size_t)-1) / 2 / sizeof(U64Slot)) {
+        return DS_ALLOCATION_ERROR;
+    }
+
+    _map->m_slots = (U64Slot*)calloc(oldNumOfSlots * 2, sizeof(U64Slot));
+    if (_map->m_slots == NULL) {
+        _map->m_slots = oldSlots;
+        return DS_ALLOCATION_ERROR;
+    }
+
+    _map->m_mask = oldNumOfSlots * 2 - 1;
+    for (i = 0; i < oldNumOfSlots; ++i) {
+        if (oldSlots[i].m_key != U64_EMPTY_KEY) {
+            for (idx = _Home(_map, oldSlots[i].m_key); _map->m_slots[idx].m_key != U64_EMPTY_KEY; idx = (idx + 1) & _map->m_mask) {
+            }
+            _map->m_slots[idx] = oldSlots[i];
+        }
+    }
+    free(oldSlots);
+    return DS_SUCCESS;
+}
+
+/* backward shift deletion: moves every following pair that may not skip the hole into it */
+static void _ShiftBack(U64Map* _map, size_t _hole) {
+    size_t idx = _hole;
+    size_t home;
+
+    for (;;) {
+        idx = (idx + 1) & _map->m_mask;
+        if (_map->m_slots[idx].m_key == U64_EMPTY_KEY) {
+            break;
+        }
+
+        home = _Home(_map, _map->m_slots[idx].m_key);
+        if (((idx - home) & _map->m_mask) >= ((idx - _hole) & _map->m_mask)) {
+            _map->m_slots[_hole] = _map->m_slots[idx];
+            _hole = idx;
+        }
+    }
+    _map->m_slots[_hole].m_key = U64_EMPTY_KEY;
+}
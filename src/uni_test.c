@@ -2,13 +2,31 @@
 #include "sorts.h"
 #include "vector.h"
 #include "heap.h"
+#include "key_heap.h"
+#include "pairing_heap.h"
+#include "multi_queue.h"
+#include "min_max_heap.h"
+#include "radix_heap.h"
 #include "hash.h"
 #include "list.h"
 #include "circular_queue.h"
 #include "circular_safe_queue.h"
 #include "stack.h"
 #include "binary_tree.h"
+#include "rcu_hash.h"
+#include "frozen_hash.h"
+#include "hash_set.h"
+#include "hash_multi_map.h"
+#include "bloom.h"
+#include "cuckoo_filter.h"
+#include "u64_map.h"
+#include "str_map.h"
+#include "lru_cache.h"
+#include "ttl_map.h"
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 Compare_Result CompareSizeTPointers(const void* _generalTypeA, const void* _generalTypeB) {
     size_t** typeA = (size_t**) _generalTypeA;
@@ -95,6 +113,14 @@ Compare_Result Int_Heap(const void* _a, const void* _b) {
     return SMALLER;
 }
 
+size_t HashSizeT(const void* _key) {
+    return *(const size_t*)_key;
+}
+
+int EqualSizeT(const void* _firstKey, const void* _secondKey) {
+    return *(const size_t*)_firstKey == *(const size_t*)_secondKey;
+}
+
 UNIT(basic_valid_size_t_pointer_bubble_sort_test)
     size_t one = 1;
     size_t two = 2;
@@ -305,6 +331,506 @@ UNIT(Append_To_Heap_Max_Elements_And_Pop)
     ASSERT_THAT(NULL == newData); 
 END_UNIT
 
+#define HEAP_TEST_ITEMS (1000)
+
+UNIT(Heap_Push_Pop_Many_Beyond_Capacity)
+    size_t arr[HEAP_TEST_ITEMS];
+    size_t i = 0;
+    size_t seed = 12345;
+    size_t* data = NULL;
+    size_t* prev = NULL;
+    const void* top = NULL;
+    Heap* heap = HeapCreate(4, HEAP_TYPE_MIN, CompareSizeTHeap);
+    ASSERT_THAT(NULL != heap);
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        seed = seed * 1103515245 + 12345;
+        arr[i] = (seed >> 8) % 500;
+        ASSERT_THAT(DS_SUCCESS == HeapPush(heap, arr + i));
+    }
+    ASSERT_THAT(HEAP_TEST_ITEMS == HeapSize(heap));
+
+    /* pop half, push them back, then everything comes out sorted */
+    for (i = 0; i < HEAP_TEST_ITEMS / 2; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HeapPop(heap, (void**)&data));
+    }
+    for (i = 0; i < HEAP_TEST_ITEMS / 2; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HeapPush(heap, arr + i));
+    }
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        top = HeapGetTopValue(heap);
+        ASSERT_THAT(DS_SUCCESS == HeapPop(heap, (void**)&data) && top == data);
+        ASSERT_THAT(NULL == prev || *prev <= *data);
+        prev = data;
+    }
+    ASSERT_THAT(DS_OUT_OF_BOUNDS_ERROR == HeapPop(heap, (void**)&data));
+    ASSERT_THAT(NULL == HeapGetTopValue(heap));
+    HeapDestroy(&heap, NULL);
+END_UNIT
+
+UNIT(Heap_Create_From_Array_And_Push_Batch)
+    size_t arr[HEAP_TEST_ITEMS];
+    void* items[HEAP_TEST_ITEMS];
+    HeapHandle handles[10];
+    size_t i = 0;
+    size_t seed = 777;
+    size_t* data = NULL;
+    size_t* prev = NULL;
+    Heap* heap = NULL;
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        seed = seed * 1103515245 + 12345;
+        arr[i] = (seed >> 8) % 500;
+        items[i] = arr + i;
+    }
+
+    heap = HeapCreateFrom(items, HEAP_TEST_ITEMS / 2, HEAP_TYPE_MAX, CompareSizeTHeap);
+    ASSERT_THAT(NULL != heap && HEAP_TEST_ITEMS / 2 == HeapSize(heap));
+    /* a small batch is sifted in, a big one rebuilds the heap */
+    ASSERT_THAT(DS_SUCCESS == HeapPushBatch(heap, items + HEAP_TEST_ITEMS / 2, 10, handles));
+    ASSERT_THAT(DS_SUCCESS == HeapPushBatch(heap, items + HEAP_TEST_ITEMS / 2 + 10, HEAP_TEST_ITEMS / 2 - 10, NULL));
+    ASSERT_THAT(HEAP_TEST_ITEMS == HeapSize(heap));
+    /* the handles of a batch stay valid while the heap changes */
+    ASSERT_THAT(DS_SUCCESS == HeapRemove(heap, handles[3], (void**)&data) && items[HEAP_TEST_ITEMS / 2 + 3] == data);
+    ASSERT_THAT(DS_SUCCESS == HeapPush(heap, data));
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HeapPop(heap, (void**)&data));
+        ASSERT_THAT(NULL == prev || *prev >= *data);
+        prev = data;
+    }
+    HeapDestroy(&heap, NULL);
+
+    heap = HeapCreateFrom(items, 0, HEAP_TYPE_MIN, CompareSizeTHeap);
+    ASSERT_THAT(NULL != heap && 0 == HeapSize(heap));
+    items[3] = NULL;
+    ASSERT_THAT(DS_UNINITIALIZED_ITEM_ERROR == HeapPushBatch(heap, items, 10, NULL) && 0 == HeapSize(heap));
+    ASSERT_THAT(NULL == HeapCreateFrom(items, 10, HEAP_TYPE_MIN, CompareSizeTHeap));
+    HeapDestroy(&heap, NULL);
+END_UNIT
+
+UNIT(Heap_DAry_4_And_8_Way_Order)
+    size_t arr[HEAP_TEST_ITEMS];
+    void* items[HEAP_TEST_ITEMS];
+    HeapHandle handles[HEAP_TEST_ITEMS];
+    size_t arity = 0;
+    size_t i = 0;
+    size_t seed = 4242;
+    size_t* data = NULL;
+    size_t* prev = NULL;
+    Heap* heap = NULL;
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        seed = seed * 1103515245 + 12345;
+        arr[i] = (seed >> 8) % 500;
+        items[i] = arr + i;
+    }
+
+    for (arity = 4; arity <= 8; arity *= 2) {
+        heap = HeapCreateEx(1, HEAP_TYPE_MIN, CompareSizeTHeap, arity);
+        ASSERT_THAT(NULL != heap);
+        for (i = 0; i < 10; ++i) {
+            ASSERT_THAT(DS_SUCCESS == HeapPush(heap, items[i]));
+        }
+        /* the batch is larger than the heap so the heap is rebuilt, every item keeps its handle */
+        ASSERT_THAT(DS_SUCCESS == HeapPushBatch(heap, items + 10, HEAP_TEST_ITEMS - 10, handles));
+        ASSERT_THAT(HEAP_TEST_ITEMS == HeapSize(heap));
+        for (i = 0; i < HEAP_TEST_ITEMS - 10; i += 97) {
+            ASSERT_THAT(DS_SUCCESS == HeapRemove(heap, handles[i], (void**)&data) && items[10 + i] == data);
+            ASSERT_THAT(DS_SUCCESS == HeapPush(heap, data));
+        }
+        prev = NULL;
+        for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+            ASSERT_THAT(DS_SUCCESS == HeapPop(heap, (void**)&data));
+            ASSERT_THAT(NULL == prev || *prev <= *data);
+            prev = data;
+        }
+        HeapDestroy(&heap, NULL);
+    }
+    ASSERT_THAT(NULL == HeapCreateEx(10, HEAP_TYPE_MIN, CompareSizeTHeap, 3));
+    ASSERT_THAT(NULL == HeapCreateEx(10, HEAP_TYPE_MIN, CompareSizeTHeap, 16));
+END_UNIT
+
+UNIT(Heap_Handles_Update_Remove_DecreaseKey)
+    size_t arr[HEAP_TEST_ITEMS];
+    HeapHandle handles[HEAP_TEST_ITEMS];
+    size_t arity = 0;
+    size_t i = 0;
+    size_t seed = 99;
+    size_t* data = NULL;
+    size_t* prev = NULL;
+    size_t popped = 0;
+    Heap* heap = NULL;
+    for (arity = 2; arity <= 4; arity *= 2) {
+        heap = HeapCreateEx(2, HEAP_TYPE_MIN, CompareSizeTHeap, arity);
+        ASSERT_THAT(NULL != heap);
+        for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+            seed = seed * 1103515245 + 12345;
+            arr[i] = (seed >> 8) % 1000 + 1000;
+        }
+        /* the index is built when the first handle is asked for */
+        for (i = 0; i < 10; ++i) {
+            ASSERT_THAT(DS_SUCCESS == HeapPush(heap, arr + i));
+        }
+        for (i = 10; i < HEAP_TEST_ITEMS; ++i) {
+            ASSERT_THAT(DS_SUCCESS == HeapPushHandle(heap, arr + i, handles + i));
+        }
+
+        for (i = 10; i < HEAP_TEST_ITEMS; i += 3) {
+            arr[i] -= 1000;
+            ASSERT_THAT(DS_SUCCESS == HeapDecreaseKey(heap, handles[i]));
+        }
+        for (i = 11; i < HEAP_TEST_ITEMS; i += 3) {
+            arr[i] = (i % 2) ? arr[i] + 500 : arr[i] - 700;
+            ASSERT_THAT(DS_SUCCESS == HeapUpdate(heap, handles[i]));
+        }
+        for (i = 12; i < HEAP_TEST_ITEMS; i += 3) {
+            ASSERT_THAT(DS_SUCCESS == HeapRemove(heap, handles[i], (void**)&data) && data == arr + i);
+            ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == HeapRemove(heap, handles[i], (void**)&data));
+            *data = 0;
+        }
+        ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == HeapUpdate(heap, HEAP_TEST_ITEMS * 4));
+
+        prev = NULL;
+        popped = 0;
+        while (DS_SUCCESS == HeapPop(heap, (void**)&data)) {
+            ASSERT_THAT(0 != *data);
+            ASSERT_THAT(NULL == prev || *prev <= *data);
+            prev = data;
+            ++popped;
+        }
+        ASSERT_THAT(HEAP_TEST_ITEMS - (HEAP_TEST_ITEMS - 12 + 2) / 3 == popped);
+        ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == HeapDecreaseKey(heap, handles[10]));
+        HeapDestroy(&heap, NULL);
+    }
+END_UNIT
+
+UNIT(Heap_Bounded_Top_K_Offer_And_Extract)
+    size_t arr[HEAP_TEST_ITEMS];
+    void* best[10];
+    size_t i = 0;
+    size_t seed = 2024;
+    size_t evictions = 0;
+    size_t worstEvicted = 0;
+    size_t* evicted = NULL;
+    Heap* heap = HeapCreateBounded(10, HEAP_TYPE_MIN, CompareSizeTHeap);
+    ASSERT_THAT(NULL != heap);
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        seed = seed * 1103515245 + 12345;
+        arr[i] = (seed >> 8) % 5000;
+        ASSERT_THAT(DS_SUCCESS == HeapOffer(heap, arr + i, (void**)&evicted));
+        if (NULL != evicted) {
+            ++evictions;
+            worstEvicted = (*evicted > worstEvicted) ? *evicted : worstEvicted;
+        }
+        ASSERT_THAT(HeapSize(heap) <= 10);
+    }
+    ASSERT_THAT(10 == HeapSize(heap) && HEAP_TEST_ITEMS - 10 == evictions);
+    best[0] = arr;
+    ASSERT_THAT(DS_OVERFLOW_ERROR == HeapPush(heap, arr));
+    ASSERT_THAT(DS_OVERFLOW_ERROR == HeapPushBatch(heap, best, 1, NULL));
+
+    /* the 10 biggest come out biggest first, nothing turned away was bigger */
+    ASSERT_THAT(DS_SUCCESS == HeapExtractSorted(heap, best));
+    ASSERT_THAT(0 == HeapSize(heap));
+    for (i = 0; i < 10; ++i) {
+        ASSERT_THAT(worstEvicted <= *(size_t*)best[i]);
+        ASSERT_THAT(0 == i || *(size_t*)best[i - 1] >= *(size_t*)best[i]);
+    }
+    HeapDestroy(&heap, NULL);
+    ASSERT_THAT(NULL == HeapCreateBounded(0, HEAP_TYPE_MIN, CompareSizeTHeap));
+END_UNIT
+
+UNIT(KeyHeap_Min_Max_Inline_Priorities)
+    size_t arr[HEAP_TEST_ITEMS];
+    size_t i = 0;
+    size_t seed = 31337;
+    uint64_t priority = 0;
+    uint64_t prev = 0;
+    size_t* data = NULL;
+    KeyHeap* heap = KeyHeapCreate(3, HEAP_TYPE_MIN);
+    ASSERT_THAT(NULL != heap);
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        seed = seed * 1103515245 + 12345;
+        arr[i] = (seed >> 8) % 500;
+        ASSERT_THAT(DS_SUCCESS == KeyHeapPush(heap, arr[i], arr + i));
+    }
+    ASSERT_THAT(HEAP_TEST_ITEMS == KeyHeapSize(heap));
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == KeyHeapPop(heap, &priority, (void**)&data));
+        ASSERT_THAT(*data == priority && prev <= priority);
+        prev = priority;
+    }
+    ASSERT_THAT(DS_OUT_OF_BOUNDS_ERROR == KeyHeapTop(heap, &priority, (void**)&data));
+    KeyHeapDestroy(&heap, NULL);
+    ASSERT_THAT(NULL == heap);
+
+    /* a max heap keeps the full range of priorities in order */
+    heap = KeyHeapCreate(4, HEAP_TYPE_MAX);
+    ASSERT_THAT(NULL != heap);
+    ASSERT_THAT(DS_SUCCESS == KeyHeapPush(heap, 0, NULL));
+    ASSERT_THAT(DS_SUCCESS == KeyHeapPush(heap, ~(uint64_t)0, arr));
+    ASSERT_THAT(DS_SUCCESS == KeyHeapPush(heap, 7, arr + 7));
+    ASSERT_THAT(DS_SUCCESS == KeyHeapTop(heap, NULL, (void**)&data) && arr == data);
+    ASSERT_THAT(DS_SUCCESS == KeyHeapPop(heap, &priority, (void**)&data) && ~(uint64_t)0 == priority);
+    ASSERT_THAT(DS_SUCCESS == KeyHeapPop(heap, &priority, (void**)&data) && 7 == priority && arr + 7 == data);
+    ASSERT_THAT(DS_SUCCESS == KeyHeapPop(heap, &priority, (void**)&data) && 0 == priority && NULL == data);
+    ASSERT_THAT(0 == KeyHeapSize(heap));
+    KeyHeapDestroy(&heap, NULL);
+    ASSERT_THAT(NULL == KeyHeapCreate(0, HEAP_TYPE_MIN));
+END_UNIT
+
+void ZeroSizeT(void* _item) {
+    *(size_t*)_item = 0;
+}
+
+UNIT(PairingHeap_Push_Meld_DecreaseKey_Pop)
+    size_t arr[HEAP_TEST_ITEMS];
+    PairingNode* nodes[HEAP_TEST_ITEMS];
+    size_t i = 0;
+    size_t seed = 555;
+    size_t* data = NULL;
+    size_t* prev = NULL;
+    const void* top = NULL;
+    PairingHeap* even = PairingHeapCreate(8, HEAP_TYPE_MIN, CompareSizeTHeap);
+    PairingHeap* odd = PairingHeapCreate(0, HEAP_TYPE_MIN, CompareSizeTHeap);
+    PairingHeap* other = PairingHeapCreate(0, HEAP_TYPE_MAX, CompareSizeTHeap);
+    ASSERT_THAT(NULL != even && NULL != odd && NULL != other);
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        seed = seed * 1103515245 + 12345;
+        arr[i] = (seed >> 8) % 1000 + 1000;
+        ASSERT_THAT(DS_SUCCESS == PairingHeapPush((i % 2) ? odd : even, arr + i, nodes + i));
+    }
+    /* pop a few so the pools hold free nodes when they are melded */
+    for (i = 0; i < 10; ++i) {
+        ASSERT_THAT(DS_SUCCESS == PairingHeapPop(odd, (void**)&data));
+        ASSERT_THAT(NULL == prev || *prev <= *data);
+        prev = data;
+        *data = 0;
+    }
+    ASSERT_THAT(DS_INVALID_PARAM_ERROR == PairingHeapMeld(even, other));
+    ASSERT_THAT(DS_SUCCESS == PairingHeapMeld(even, odd));
+    ASSERT_THAT(HEAP_TEST_ITEMS - 10 == PairingHeapSize(even) && 0 == PairingHeapSize(odd));
+    ASSERT_THAT(NULL == PairingHeapGetTopValue(odd));
+
+    /* nodes of the melded heap are still valid */
+    for (i = 0; i < HEAP_TEST_ITEMS; i += 7) {
+        if (0 != arr[i]) {
+            arr[i] -= 1000;
+            ASSERT_THAT(DS_SUCCESS == PairingHeapDecreaseKey(even, nodes[i]));
+        }
+    }
+    ASSERT_THAT(DS_SUCCESS == PairingHeapPush(odd, arr, NULL) && 1 == PairingHeapSize(odd));
+
+    prev = NULL;
+    for (i = 0; i < HEAP_TEST_ITEMS - 10; ++i) {
+        top = PairingHeapGetTopValue(even);
+        ASSERT_THAT(DS_SUCCESS == PairingHeapPop(even, (void**)&data) && top == data);
+        ASSERT_THAT(0 != *data && (NULL == prev || *prev <= *data));
+        prev = data;
+    }
+    ASSERT_THAT(DS_OUT_OF_BOUNDS_ERROR == PairingHeapPop(even, (void**)&data));
+
+    /* destroy reaches every item of a deep tree */
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        arr[i] = i + 1;
+        ASSERT_THAT(DS_SUCCESS == PairingHeapPush(other, arr + i, NULL));
+    }
+    ASSERT_THAT(DS_SUCCESS == PairingHeapPop(other, (void**)&data) && HEAP_TEST_ITEMS == *data);
+    PairingHeapDestroy(&other, ZeroSizeT);
+    for (i = 0; i < HEAP_TEST_ITEMS - 1; ++i) {
+        ASSERT_THAT(0 == arr[i]);
+    }
+    PairingHeapDestroy(&even, NULL);
+    PairingHeapDestroy(&odd, NULL);
+    ASSERT_THAT(NULL == even && NULL == odd && NULL == other);
+END_UNIT
+
+UNIT(MultiQueue_Single_Lane_Order_And_Relaxed_Pop)
+    size_t arr[HEAP_TEST_ITEMS];
+    char seen[HEAP_TEST_ITEMS];
+    size_t i = 0;
+    size_t seed = 808;
+    uint64_t priority = 0;
+    uint64_t prev = 0;
+    size_t* data = NULL;
+    MultiQueue* queue = MultiQueueCreate(1, 4, HEAP_TYPE_MAX);
+    ASSERT_THAT(NULL != queue);
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        seed = seed * 1103515245 + 12345;
+        arr[i] = (seed >> 8) % 500;
+        ASSERT_THAT(DS_SUCCESS == MultiQueuePush(queue, arr[i], arr + i));
+    }
+    /* one lane is a plain locked heap, strictly ordered */
+    prev = ~(uint64_t)0;
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == MultiQueuePop(queue, &priority, (void**)&data));
+        ASSERT_THAT(*data == priority && prev >= priority);
+        prev = priority;
+    }
+    ASSERT_THAT(DS_OUT_OF_BOUNDS_ERROR == MultiQueuePop(queue, &priority, (void**)&data));
+    MultiQueueDestroy(&queue, NULL);
+    ASSERT_THAT(NULL == queue);
+
+    /* many lanes give every item back exactly once */
+    queue = MultiQueueCreate(8, 4, HEAP_TYPE_MIN);
+    ASSERT_THAT(NULL != queue);
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        seen[i] = 0;
+        ASSERT_THAT(DS_SUCCESS == MultiQueuePush(queue, arr[i], arr + i));
+    }
+    ASSERT_THAT(HEAP_TEST_ITEMS == MultiQueueSize(queue));
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == MultiQueuePop(queue, NULL, (void**)&data));
+        ASSERT_THAT(0 == seen[data - arr]);
+        seen[data - arr] = 1;
+    }
+    ASSERT_THAT(0 == MultiQueueSize(queue) && -1 == MultiQueueSize(NULL));
+    ASSERT_THAT(DS_OUT_OF_BOUNDS_ERROR == MultiQueuePop(queue, NULL, (void**)&data));
+    MultiQueueDestroy(&queue, NULL);
+    ASSERT_THAT(NULL == MultiQueueCreate(0, 4, HEAP_TYPE_MIN));
+END_UNIT
+
+#define MULTI_QUEUE_TEST_THREADS (4)
+
+typedef struct MultiQueueTestContext {
+    MultiQueue* m_queue;
+    size_t m_first;
+    size_t m_pushed;
+    size_t m_popped;
+    size_t m_sum;
+} MultiQueueTestContext;
+
+void* MultiQueueTestWorker(void* _context) {
+    MultiQueueTestContext* context = (MultiQueueTestContext*)_context;
+    size_t* data = NULL;
+    size_t i = 0;
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        if (DS_SUCCESS == MultiQueuePush(context->m_queue, context->m_first + i, (void*)(context->m_first + i + 1))) {
+            ++context->m_pushed;
+        }
+        if (0 == i % 3 && DS_SUCCESS == MultiQueuePop(context->m_queue, NULL, (void**)&data)) {
+            ++context->m_popped;
+            context->m_sum += (size_t)data;
+        }
+    }
+    return NULL;
+}
+
+UNIT(MultiQueue_Concurrent_Push_Pop)
+    MultiQueueTestContext contexts[MULTI_QUEUE_TEST_THREADS];
+    pthread_t workers[MULTI_QUEUE_TEST_THREADS];
+    size_t* data = NULL;
+    size_t popped = 0;
+    size_t sum = 0;
+    size_t i = 0;
+    MultiQueue* queue = MultiQueueCreate(2 * MULTI_QUEUE_TEST_THREADS, 16, HEAP_TYPE_MIN);
+    ASSERT_THAT(NULL != queue);
+    for (i = 0; i < MULTI_QUEUE_TEST_THREADS; ++i) {
+        contexts[i].m_queue = queue;
+        contexts[i].m_first = i * HEAP_TEST_ITEMS;
+        contexts[i].m_pushed = 0;
+        contexts[i].m_popped = 0;
+        contexts[i].m_sum = 0;
+        ASSERT_THAT(0 == pthread_create(workers + i, NULL, MultiQueueTestWorker, contexts + i));
+    }
+    for (i = 0; i < MULTI_QUEUE_TEST_THREADS; ++i) {
+        pthread_join(workers[i], NULL);
+        ASSERT_THAT(HEAP_TEST_ITEMS == contexts[i].m_pushed);
+        popped += contexts[i].m_popped;
+        sum += contexts[i].m_sum;
+    }
+
+    /* every payload pushed comes out once, by a worker or here */
+    ASSERT_THAT(MULTI_QUEUE_TEST_THREADS * HEAP_TEST_ITEMS - popped == MultiQueueSize(queue));
+    while (DS_SUCCESS == MultiQueuePop(queue, NULL, (void**)&data)) {
+        sum += (size_t)data;
+    }
+    ASSERT_THAT(MULTI_QUEUE_TEST_THREADS * HEAP_TEST_ITEMS * (MULTI_QUEUE_TEST_THREADS * HEAP_TEST_ITEMS + 1) / 2 == sum);
+    MultiQueueDestroy(&queue, NULL);
+END_UNIT
+
+UNIT(MinMaxHeap_Pop_Both_Ends)
+    size_t arr[HEAP_TEST_ITEMS];
+    size_t counts[100];
+    size_t i = 0;
+    size_t low = 0;
+    size_t high = 99;
+    size_t seed = 4711;
+    size_t* data = NULL;
+    MinMaxHeap* heap = MinMaxHeapCreate(2, CompareSizeTHeap);
+    ASSERT_THAT(NULL != heap);
+    ASSERT_THAT(NULL == MinMaxHeapGetMin(heap) && NULL == MinMaxHeapGetMax(heap));
+    ASSERT_THAT(DS_OUT_OF_BOUNDS_ERROR == MinMaxHeapPopMax(heap, (void**)&data));
+    for (i = 0; i < 100; ++i) {
+        counts[i] = 0;
+    }
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        seed = seed * 1103515245 + 12345;
+        arr[i] = (seed >> 8) % 100;
+        ++counts[arr[i]];
+        ASSERT_THAT(DS_SUCCESS == MinMaxHeapPush(heap, arr + i));
+    }
+    ASSERT_THAT(HEAP_TEST_ITEMS == MinMaxHeapSize(heap));
+
+    /* every pop takes the smallest or the biggest value still counted */
+    for (i = 0; i < HEAP_TEST_ITEMS; ++i) {
+        while (0 == counts[low]) {
+            ++low;
+        }
+        while (0 == counts[high]) {
+            --high;
+        }
+        ASSERT_THAT(low == *(const size_t*)MinMaxHeapGetMin(heap) && high == *(const size_t*)MinMaxHeapGetMax(heap));
+        if (0 == i % 3) {
+            ASSERT_THAT(DS_SUCCESS == MinMaxHeapPopMin(heap, (void**)&data) && low == *data);
+        } else {
+            ASSERT_THAT(DS_SUCCESS == MinMaxHeapPopMax(heap, (void**)&data) && high == *data);
+        }
+        --counts[*data];
+    }
+    ASSERT_THAT(0 == MinMaxHeapSize(heap));
+    ASSERT_THAT(DS_OUT_OF_BOUNDS_ERROR == MinMaxHeapPopMin(heap, (void**)&data));
+    MinMaxHeapDestroy(&heap, NULL);
+    ASSERT_THAT(NULL == heap);
+END_UNIT
+
+UNIT(RadixHeap_Monotone_Keys)
+    size_t arr[HEAP_TEST_ITEMS];
+    size_t i = 0;
+    size_t pushed = 0;
+    size_t seed = 1234;
+    uint64_t key = 0;
+    uint64_t prev = 0;
+    size_t* data = NULL;
+    RadixHeap* heap = RadixHeapCreate();
+    ASSERT_THAT(NULL != heap);
+    ASSERT_THAT(DS_OUT_OF_BOUNDS_ERROR == RadixHeapPop(heap, &key, (void**)&data));
+
+    /* like a shortest path search: every pop pushes keys a little above the popped one */
+    arr[0] = 0;
+    ASSERT_THAT(DS_SUCCESS == RadixHeapPush(heap, 0, arr));
+    pushed = 1;
+    while (DS_SUCCESS == RadixHeapPop(heap, &key, (void**)&data)) {
+        ASSERT_THAT(key == *data && prev <= key);
+        prev = key;
+        for (i = 0; i < 2 && pushed < HEAP_TEST_ITEMS; ++i, ++pushed) {
+            seed = seed * 1103515245 + 12345;
+            arr[pushed] = key + (seed >> 8) % 5000;
+            ASSERT_THAT(DS_SUCCESS == RadixHeapPush(heap, arr[pushed], arr + pushed));
+        }
+    }
+    ASSERT_THAT(HEAP_TEST_ITEMS == pushed && 0 == RadixHeapSize(heap));
+    ASSERT_THAT(DS_INVALID_PARAM_ERROR == RadixHeapPush(heap, prev - 1, arr));
+
+    /* keys far apart use the high buckets */
+    ASSERT_THAT(DS_SUCCESS == RadixHeapPush(heap, ~(uint64_t)0, NULL));
+    ASSERT_THAT(DS_SUCCESS == RadixHeapPush(heap, prev, arr));
+    ASSERT_THAT(DS_SUCCESS == RadixHeapPush(heap, prev + 1, arr + 1));
+    ASSERT_THAT(3 == RadixHeapSize(heap) && -1 == RadixHeapSize(NULL));
+    ASSERT_THAT(DS_SUCCESS == RadixHeapPop(heap, &key, (void**)&data) && prev == key && arr == data);
+    ASSERT_THAT(DS_SUCCESS == RadixHeapPop(heap, &key, (void**)&data) && prev + 1 == key);
+    ASSERT_THAT(DS_SUCCESS == RadixHeapPop(heap, NULL, (void**)&data) && NULL == data);
+    RadixHeapDestroy(&heap, NULL);
+    ASSERT_THAT(NULL == heap);
+END_UNIT
+
 UNIT(Allocate_Queue)
     CQueue* newDataS = CQueueCreate(10);
     ASSERT_THAT(NULL != newDataS);
@@ -442,6 +968,1035 @@ UNIT(BTree_Valid_Unit_Test)
 END_UNIT
 
 
+UNIT(RCUHashMap_Insert_Find_Remove)
+    size_t keys[] = {3, 17, 42, 1000, 7};
+    size_t values[] = {30, 170, 420, 10000, 70};
+    size_t missing = 5;
+    size_t i = 0;
+    size_t* value = NULL;
+    RCUReader* reader = NULL;
+    RCUHashMap* map = RCUHashMapCreate(2, 4, HashSizeT, EqualSizeT, NULL, NULL);
+    ASSERT_THAT(NULL != map);
+    reader = RCUHashMapReaderAttach(map);
+    ASSERT_THAT(NULL != reader);
+    for (i = 0; i < sizeof(keys) / sizeof(size_t); ++i) {
+        ASSERT_THAT(DS_SUCCESS == RCUHashMapInsert(map, keys + i, values + i));
+    }
+    ASSERT_THAT(DS_KEY_EXISTS_ERROR == RCUHashMapInsert(map, keys, values));
+    ASSERT_THAT(sizeof(keys) / sizeof(size_t) == RCUHashMapSize(map));
+
+    for (i = 0; i < sizeof(keys) / sizeof(size_t); ++i) {
+        ASSERT_THAT(DS_SUCCESS == RCUHashMapFind(reader, keys + i, (void**)&value));
+        ASSERT_THAT(values[i] == *value);
+    }
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == RCUHashMapFind(reader, &missing, (void**)&value));
+
+    RCUHashMapReadBegin(reader);
+    ASSERT_THAT(DS_SUCCESS == RCUHashMapFind(reader, keys + 2, (void**)&value));
+    ASSERT_THAT(DS_SUCCESS == RCUHashMapRemove(map, keys + 2));
+    ASSERT_THAT(420 == *value);
+    RCUHashMapReadEnd(reader);
+    RCUHashMapSynchronize(map);
+
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == RCUHashMapFind(reader, keys + 2, (void**)&value));
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == RCUHashMapRemove(map, keys + 2));
+    ASSERT_THAT(sizeof(keys) / sizeof(size_t) - 1 == RCUHashMapSize(map));
+
+    RCUHashMapReaderDetach(&reader);
+    ASSERT_THAT(NULL == reader);
+    RCUHashMapDestroy(&map);
+    ASSERT_THAT(NULL == map);
+END_UNIT
+
+#define RCU_TEST_KEYS (512)
+
+typedef struct RCUTestContext {
+    RCUHashMap* m_map;
+    size_t* m_keys;
+    size_t m_misses;
+} RCUTestContext;
+
+void* RCUTestReader(void* _context) {
+    RCUTestContext* context = (RCUTestContext*)_context;
+    RCUReader* reader = RCUHashMapReaderAttach(context->m_map);
+    size_t* value = NULL;
+    size_t round = 0;
+    size_t i = 0;
+    for (round = 0; round < 50; ++round) {
+        for (i = 0; i < RCU_TEST_KEYS; i += 2) {
+            if (DS_SUCCESS != RCUHashMapFind(reader, context->m_keys + i, (void**)&value) || *value != i) {
+                ++context->m_misses;
+            }
+        }
+    }
+    RCUHashMapReaderDetach(&reader);
+    return NULL;
+}
+
+UNIT(RCUHashMap_Concurrent_Readers_And_Writer)
+    size_t keys[RCU_TEST_KEYS];
+    RCUTestContext contexts[3];
+    pthread_t readers[3];
+    size_t i = 0;
+    size_t round = 0;
+    RCUHashMap* map = RCUHashMapCreate(16, 4, HashSizeT, EqualSizeT, NULL, NULL);
+    ASSERT_THAT(NULL != map);
+    for (i = 0; i < RCU_TEST_KEYS; ++i) {
+        keys[i] = i;
+    }
+    for (i = 0; i < RCU_TEST_KEYS; i += 2) {
+        ASSERT_THAT(DS_SUCCESS == RCUHashMapInsert(map, keys + i, keys + i));
+    }
+
+    for (i = 0; i < 3; ++i) {
+        contexts[i].m_map = map;
+        contexts[i].m_keys = keys;
+        contexts[i].m_misses = 0;
+        ASSERT_THAT(0 == pthread_create(readers + i, NULL, RCUTestReader, contexts + i));
+    }
+
+    /* odd keys churn and force rehashes while readers look up the even ones */
+    for (round = 0; round < 4; ++round) {
+        for (i = 1; i < RCU_TEST_KEYS; i += 2) {
+            RCUHashMapInsert(map, keys + i, keys + i);
+        }
+        for (i = 1; i < RCU_TEST_KEYS; i += 2) {
+            RCUHashMapRemove(map, keys + i);
+        }
+    }
+
+    for (i = 0; i < 3; ++i) {
+        pthread_join(readers[i], NULL);
+        ASSERT_THAT(0 == contexts[i].m_misses);
+    }
+    ASSERT_THAT(RCU_TEST_KEYS / 2 == RCUHashMapSize(map));
+    RCUHashMapDestroy(&map);
+END_UNIT
+
+
+size_t EncodeSizeT(const void* _item, void* _buffer, size_t _bufferSize) {
+    if (_bufferSize >= sizeof(size_t)) {
+        memcpy(_buffer, _item, sizeof(size_t));
+    }
+    return sizeof(size_t);
+}
+
+#define FROZEN_TEST_KEYS (1000)
+
+UNIT(FrozenHashMap_Freeze_Find_Dump_Load)
+    size_t keys[FROZEN_TEST_KEYS];
+    size_t values[FROZEN_TEST_KEYS];
+    size_t missing = FROZEN_TEST_KEYS * 7 + 1;
+    size_t i = 0;
+    size_t* value = NULL;
+    FrozenHashMap* frozen = NULL;
+    HashMap* map = HashMapCreate(FROZEN_TEST_KEYS, HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != map);
+    for (i = 0; i < FROZEN_TEST_KEYS; ++i) {
+        keys[i] = i * 7;
+        values[i] = i;
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, keys + i, values + i));
+    }
+    ASSERT_THAT(FROZEN_TEST_KEYS == HashMapSize(map));
+
+    frozen = HashMapFreeze(map);
+    ASSERT_THAT(NULL != frozen);
+    ASSERT_THAT(FROZEN_TEST_KEYS == FrozenHashMapSize(frozen));
+    for (i = 0; i < FROZEN_TEST_KEYS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == FrozenHashMapFind(frozen, keys + i, (void**)&value));
+        ASSERT_THAT(values + i == value);
+    }
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == FrozenHashMapFind(frozen, &missing, (void**)&value));
+
+    ASSERT_THAT(DS_SUCCESS == FrozenHashMapDump(frozen, "frozen_map_test.bin", EncodeSizeT, EncodeSizeT));
+    FrozenHashMapDestroy(&frozen);
+    ASSERT_THAT(NULL == frozen);
+    HashMapDestroy(&map, NULL, NULL);
+
+    frozen = FrozenHashMapLoad("frozen_map_test.bin", HashSizeT, EqualSizeT);
+    remove("frozen_map_test.bin");
+    ASSERT_THAT(NULL != frozen);
+    ASSERT_THAT(FROZEN_TEST_KEYS == FrozenHashMapSize(frozen));
+    for (i = 0; i < FROZEN_TEST_KEYS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == FrozenHashMapFind(frozen, keys + i, (void**)&value));
+        ASSERT_THAT(i == *value);
+    }
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == FrozenHashMapFind(frozen, &missing, (void**)&value));
+    FrozenHashMapDestroy(&frozen);
+END_UNIT
+
+
+/* a weak hash, every eighth key shares one value */
+size_t HashSizeTMod8(const void* _key) {
+    return *(const size_t*)_key % 8;
+}
+
+UNIT(FrozenHashMap_Equal_Hashes)
+    size_t keys[FROZEN_TEST_KEYS];
+    size_t missing = FROZEN_TEST_KEYS + 8;
+    size_t i = 0;
+    size_t* value = NULL;
+    FrozenHashMap* frozen = NULL;
+    HashMap* map = HashMapCreate(FROZEN_TEST_KEYS, HashSizeTMod8, EqualSizeT);
+    ASSERT_THAT(NULL != map);
+    for (i = 0; i < FROZEN_TEST_KEYS; ++i) {
+        keys[i] = i;
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, keys + i, keys + i));
+    }
+
+    frozen = HashMapFreeze(map);
+    ASSERT_THAT(NULL != frozen);
+    ASSERT_THAT(FROZEN_TEST_KEYS == FrozenHashMapSize(frozen));
+    for (i = 0; i < FROZEN_TEST_KEYS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == FrozenHashMapFind(frozen, keys + i, (void**)&value));
+        ASSERT_THAT(keys + i == value);
+    }
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == FrozenHashMapFind(frozen, &missing, (void**)&value));
+    FrozenHashMapDestroy(&frozen);
+
+    ASSERT_THAT(DS_SUCCESS == HashMapSave(map, "equal_hashes_test.bin", EncodeSizeT, EncodeSizeT));
+    HashMapDestroy(&map, NULL, NULL);
+    frozen = FrozenHashMapMap("equal_hashes_test.bin", HashSizeTMod8, EqualSizeT);
+    remove("equal_hashes_test.bin");
+    ASSERT_THAT(NULL != frozen);
+    for (i = 0; i < FROZEN_TEST_KEYS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == FrozenHashMapFind(frozen, keys + i, (void**)&value));
+        ASSERT_THAT(i == *value);
+    }
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == FrozenHashMapFind(frozen, &missing, (void**)&value));
+    FrozenHashMapDestroy(&frozen);
+END_UNIT
+
+
+/* rewrites one size_t of a dumped image in place */
+int PatchImage(const char* _fileName, long _offset, size_t _word) {
+    FILE* fp = fopen(_fileName, "r+b");
+    int result;
+    if (NULL == fp) {
+        return -1;
+    }
+    result = (0 == fseek(fp, _offset, SEEK_SET) && 1 == fwrite(&_word, sizeof(_word), 1, fp)) ? 0 : -1;
+    fclose(fp);
+    return result;
+}
+
+UNIT(FrozenHashMap_Load_Rejects_Corrupted_Image)
+    size_t keys[] = {3, 5, 8, 13};
+    size_t i = 0;
+    size_t slotsOffset = 0;
+    size_t corrupted = 0;
+    void* value = NULL;
+    aps_ds_error result = DS_SUCCESS;
+    FILE* fp = NULL;
+    FrozenHashMap* frozen = NULL;
+    HashMap* map = HashMapCreate(8, HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != map);
+    for (i = 0; i < sizeof(keys) / sizeof(size_t); ++i) {
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, keys + i, keys + i));
+    }
+
+    /* the header is nine words: magic, word size, items, hashes, buckets, seed, displacements, slots, image size */
+    ASSERT_THAT(DS_SUCCESS == HashMapSave(map, "corrupted_map_test.bin", EncodeSizeT, EncodeSizeT));
+    fp = fopen("corrupted_map_test.bin", "rb");
+    ASSERT_THAT(NULL != fp);
+    ASSERT_THAT(0 == fseek(fp, 7 * 8, SEEK_SET) && 1 == fread(&slotsOffset, sizeof(size_t), 1, fp));
+    fclose(fp);
+
+    /* a key offset past the end of the image is found by the lookup that probes its slot */
+    ASSERT_THAT(0 == PatchImage("corrupted_map_test.bin", (long)slotsOffset + sizeof(size_t), (size_t)1 << 40));
+    frozen = FrozenHashMapMap("corrupted_map_test.bin", HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != frozen);
+    for (i = 0; i < sizeof(keys) / sizeof(size_t); ++i) {
+        result = FrozenHashMapFind(frozen, keys + i, &value);
+        ASSERT_THAT(DS_SUCCESS == result || DS_GENERAL_ERROR == result);
+        corrupted += DS_GENERAL_ERROR == result;
+    }
+    ASSERT_THAT(1 == corrupted);
+    FrozenHashMapDestroy(&frozen);
+
+    /* a slots offset that wraps around when the slot array is added to it */
+    ASSERT_THAT(DS_SUCCESS == HashMapSave(map, "corrupted_map_test.bin", EncodeSizeT, EncodeSizeT));
+    ASSERT_THAT(0 == PatchImage("corrupted_map_test.bin", 7 * 8, (size_t)-8));
+    frozen = FrozenHashMapLoad("corrupted_map_test.bin", HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL == frozen);
+
+    ASSERT_THAT(DS_SUCCESS == HashMapSave(map, "corrupted_map_test.bin", EncodeSizeT, EncodeSizeT));
+    frozen = FrozenHashMapLoad("corrupted_map_test.bin", HashSizeT, EqualSizeT);
+    remove("corrupted_map_test.bin");
+    ASSERT_THAT(NULL != frozen);
+    FrozenHashMapDestroy(&frozen);
+    HashMapDestroy(&map, NULL, NULL);
+END_UNIT
+
+
+size_t HashString(const void* _key) {
+    const unsigned char* str = (const unsigned char*)_key;
+    size_t hash = 5381;
+    while ('\0' != *str) {
+        hash = hash * 33 + *str++;
+    }
+    return hash;
+}
+
+int EqualString(const void* _firstKey, const void* _secondKey) {
+    return 0 == strcmp((const char*)_firstKey, (const char*)_secondKey);
+}
+
+size_t EncodeString(const void* _item, void* _buffer, size_t _bufferSize) {
+    size_t size = strlen((const char*)_item) + 1;
+    if (_bufferSize >= size) {
+        memcpy(_buffer, _item, size);
+    }
+    return size;
+}
+
+UNIT(HashMap_Save_And_Map_Image)
+    const char* keys[] = {"routing", "config", "symbols", "log4c", "a fairly long key that does not fit any inline buffer"};
+    size_t values[] = {1, 2, 3, 4, 5};
+    size_t numOfKeys = sizeof(values) / sizeof(size_t);
+    size_t i = 0;
+    size_t* value = NULL;
+    FrozenHashMap* mapped = NULL;
+    HashMap* map = HashMapCreate(8, HashString, EqualString);
+    ASSERT_THAT(NULL != map);
+    for (i = 0; i < numOfKeys; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, keys[i], values + i));
+    }
+    ASSERT_THAT(DS_SUCCESS == HashMapSave(map, "mapped_map_test.bin", EncodeString, EncodeSizeT));
+    HashMapDestroy(&map, NULL, NULL);
+
+    mapped = FrozenHashMapMap("mapped_map_test.bin", HashString, EqualString);
+    remove("mapped_map_test.bin");
+    ASSERT_THAT(NULL != mapped);
+    ASSERT_THAT(numOfKeys == FrozenHashMapSize(mapped));
+    for (i = 0; i < numOfKeys; ++i) {
+        ASSERT_THAT(DS_SUCCESS == FrozenHashMapFind(mapped, keys[i], (void**)&value));
+        ASSERT_THAT(values[i] == *value);
+    }
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == FrozenHashMapFind(mapped, "missing", (void**)&value));
+    FrozenHashMapDestroy(&mapped);
+    ASSERT_THAT(NULL == mapped);
+    ASSERT_THAT(NULL == FrozenHashMapMap("no_such_image.bin", HashString, EqualString));
+END_UNIT
+
+
+int CountKeys(const void* _key, void* _context) {
+    (void)_key;
+    ++*(size_t*)_context;
+    return 1;
+}
+
+UNIT(HashSet_Insert_Contains_Remove_Set_Operations)
+    size_t keys[10];
+    size_t i = 0;
+    size_t count = 0;
+    size_t* removed = NULL;
+    HashSet* even = HashSetCreate(4, HashSizeT, EqualSizeT);
+    HashSet* low = HashSetCreate(4, HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != even && NULL != low);
+    for (i = 0; i < 10; ++i) {
+        keys[i] = i;
+        if (i % 2 == 0) {
+            ASSERT_THAT(DS_SUCCESS == HashSetInsert(even, keys + i));
+        }
+        if (i < 5) {
+            ASSERT_THAT(DS_SUCCESS == HashSetInsert(low, keys + i));
+        }
+    }
+    ASSERT_THAT(DS_KEY_EXISTS_ERROR == HashSetInsert(even, keys + 4));
+    ASSERT_THAT(5 == HashSetSize(even));
+    ASSERT_THAT(HashSetContains(even, keys + 8));
+    ASSERT_THAT(!HashSetContains(even, keys + 7));
+    ASSERT_THAT(5 == HashSetForEach(even, CountKeys, &count) && 5 == count);
+
+    /* {0,2,4,6,8} - {0,1,2,3,4} = {6,8} */
+    ASSERT_THAT(DS_SUCCESS == HashSetDifference(even, low, NULL));
+    ASSERT_THAT(2 == HashSetSize(even));
+    ASSERT_THAT(HashSetContains(even, keys + 6) && !HashSetContains(even, keys + 2));
+
+    /* {6,8} + {0,1,2,3,4} */
+    ASSERT_THAT(DS_SUCCESS == HashSetUnion(even, low));
+    ASSERT_THAT(7 == HashSetSize(even));
+
+    /* {0,1,2,3,4} & {0,1,2,3,4,6,8} */
+    ASSERT_THAT(DS_SUCCESS == HashSetRemove(low, keys + 3, (void**)&removed) && keys + 3 == removed);
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == HashSetRemove(low, keys + 3, (void**)&removed));
+    ASSERT_THAT(DS_SUCCESS == HashSetIntersection(even, low, NULL));
+    ASSERT_THAT(4 == HashSetSize(even));
+    ASSERT_THAT(!HashSetContains(even, keys + 3) && !HashSetContains(even, keys + 6));
+
+    HashSetDestroy(&even, NULL);
+    HashSetDestroy(&low, NULL);
+    ASSERT_THAT(NULL == even && NULL == low);
+END_UNIT
+
+
+int SumValues(const void* _key, void* _value, void* _context) {
+    (void)_key;
+    __sync_fetch_and_add((size_t*)_context, *(size_t*)_value);
+    return 1;
+}
+
+int StopAtFive(const void* _key, void* _value, void* _context) {
+    (void)_key;
+    (void)_value;
+    return ++*(size_t*)_context < 5;
+}
+
+UNIT(HashMap_Iterator_And_Parallel_ForEach)
+    size_t values[1000];
+    size_t i = 0;
+    size_t sum = 0;
+    size_t expected = 0;
+    HashMapItr itr;
+    HashMap* map = HashMapCreate(100, HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != map);
+    ASSERT_THAT(HashMapItrIsEnd(HashMapItrBegin(map)));
+    for (i = 0; i < 1000; ++i) {
+        values[i] = i;
+        expected += i;
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, values + i, values + i));
+    }
+
+    for (itr = HashMapItrBegin(map); !HashMapItrIsEnd(itr); itr = HashMapItrNext(itr)) {
+        ASSERT_THAT(HashMapItrKey(itr) == HashMapItrValue(itr));
+        sum += *(size_t*)HashMapItrValue(itr);
+    }
+    ASSERT_THAT(expected == sum);
+    ASSERT_THAT(NULL == HashMapItrKey(itr) && NULL == HashMapItrValue(itr));
+
+    sum = 0;
+    ASSERT_THAT(1000 == HashMapForEach(map, SumValues, &sum));
+    ASSERT_THAT(expected == sum);
+    sum = 0;
+    ASSERT_THAT(5 == HashMapForEach(map, StopAtFive, &sum));
+
+    sum = 0;
+    ASSERT_THAT(1000 == HashMapForEachParallel(map, 4, SumValues, &sum));
+    ASSERT_THAT(expected == sum);
+    sum = 0;
+    ASSERT_THAT(1000 == HashMapForEachParallel(map, 1000, SumValues, &sum));
+    ASSERT_THAT(expected == sum);
+    HashMapDestroy(&map, NULL, NULL);
+END_UNIT
+
+
+UNIT(HashMap_Statistics_Histogram_And_Sampling)
+    size_t keys[33];
+    size_t i = 0;
+    Map_Stats stats;
+    HashMap* map = HashMapCreate(11, HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != map);
+
+    stats = HashMapGetStatistics(map);
+    ASSERT_THAT(11 == stats.numberOfBuckets && 0 == stats.numberOfChains);
+    ASSERT_THAT(0 == stats.averageChainLength && 0 == stats.expectedProbesHit);
+    ASSERT_THAT(11 == stats.chainLengthHistogram[0]);
+
+    /* buckets 0..10 get 3 keys each */
+    for (i = 0; i < 33; ++i) {
+        keys[i] = i;
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, keys + i, keys + i));
+    }
+    stats = HashMapGetStatistics(map);
+    ASSERT_THAT(11 == stats.numberOfChains && 3 == stats.maxChainLength && 3 == stats.averageChainLength);
+    ASSERT_THAT(33 == stats.numberOfItems && 3.0 == stats.loadFactor);
+    ASSERT_THAT(2.0 == stats.expectedProbesHit && 3.0 == stats.expectedProbesMiss);
+    ASSERT_THAT(11 == stats.chainLengthHistogram[3] && 0 == stats.chainLengthHistogram[0]);
+    ASSERT_THAT(stats.bytesAllocated > 33 * 2 * sizeof(void*));
+    ASSERT_THAT(0 == stats.numberOfRehashes);
+
+    stats = HashMapSampleStatistics(map, 4);
+    ASSERT_THAT(11 == stats.numberOfBuckets && 11 == stats.numberOfChains);
+    ASSERT_THAT(11 == stats.chainLengthHistogram[3] && 3.0 == stats.expectedProbesMiss);
+    ASSERT_THAT(33 == stats.numberOfItems);
+
+    stats = HashMapGetStatistics(NULL);
+    ASSERT_THAT(0 == stats.numberOfBuckets);
+    HashMapDestroy(&map, NULL, NULL);
+END_UNIT
+
+#define FLOOD_TEST_KEYS (500)
+
+UNIT(HashMap_Rehash_And_Flood_Reseed)
+    size_t keys[FLOOD_TEST_KEYS];
+    size_t i = 0;
+    size_t* value = NULL;
+    Map_Stats stats;
+    HashMap* map = HashMapCreate(11, HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != map);
+
+    /* rehash keeps every pair and moves it to its new bucket */
+    for (i = 0; i < 33; ++i) {
+        keys[i] = i;
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, keys + i, keys + i));
+    }
+    ASSERT_THAT(DS_SUCCESS == HashMapRehash(map, 100));
+    stats = HashMapGetStatistics(map);
+    ASSERT_THAT(101 == stats.numberOfBuckets && 33 == stats.numberOfChains && 1 == stats.maxChainLength);
+    ASSERT_THAT(1 == stats.numberOfRehashes && 33 == HashMapSize(map));
+    for (i = 0; i < 33; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HashMapFind(map, keys + i, (void**)&value) && keys + i == value);
+    }
+    HashMapDestroy(&map, NULL, NULL);
+
+    /* multiples of the capacity all land in bucket 0 until the map reseeds */
+    map = HashMapCreate(11, HashSizeT, EqualSizeT);
+    for (i = 0; i < FLOOD_TEST_KEYS; ++i) {
+        keys[i] = i * 11;
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, keys + i, keys + i));
+    }
+    stats = HashMapGetStatistics(map);
+    ASSERT_THAT(stats.numberOfRehashes >= 1 && stats.numberOfBuckets >= 17 && 0 == stats.numberOfFloodWarnings);
+    ASSERT_THAT(stats.maxChainLength <= 16 + 2 * FLOOD_TEST_KEYS / stats.numberOfBuckets);
+    ASSERT_THAT(FLOOD_TEST_KEYS == HashMapSize(map));
+    for (i = 0; i < FLOOD_TEST_KEYS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HashMapFind(map, keys + i, (void**)&value) && keys + i == value);
+    }
+    HashMapDestroy(&map, NULL, NULL);
+END_UNIT
+
+
+/* 2^12 strings of twelve "bA" or "ab" blocks, both blocks add the same to djb2 */
+#define COLLIDING_TEST_BLOCKS (12)
+#define COLLIDING_TEST_KEYS (1 << COLLIDING_TEST_BLOCKS)
+
+UNIT(HashMap_Seeded_Hash_Scatters_Equal_Hashes)
+    static char keys[COLLIDING_TEST_KEYS][2 * COLLIDING_TEST_BLOCKS + 1];
+    size_t numbers[FLOOD_TEST_KEYS];
+    size_t i = 0;
+    size_t block = 0;
+    char* value = NULL;
+    Map_Stats stats;
+    HashMap* plain = HashMapCreate(COLLIDING_TEST_KEYS, HashString, EqualString);
+    HashMap* seeded = HashMapCreateSeeded(COLLIDING_TEST_KEYS, HashStringSeeded, EqualString);
+    ASSERT_THAT(NULL != plain && NULL != seeded);
+    ASSERT_THAT(NULL == HashMapCreateSeeded(8, NULL, EqualString));
+
+    for (i = 0; i < COLLIDING_TEST_KEYS; ++i) {
+        for (block = 0; block < COLLIDING_TEST_BLOCKS; ++block) {
+            memcpy(keys[i] + 2 * block, (i >> block) & 1 ? "bA" : "ab", 2);
+        }
+        keys[i][2 * COLLIDING_TEST_BLOCKS] = '\0';
+        ASSERT_THAT(HashString(keys[0]) == HashString(keys[i]));
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(plain, keys[i], keys[i]));
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(seeded, keys[i], keys[i]));
+    }
+
+    /* no seed mixed in after djb2 can split the chain, the plain map only warns */
+    stats = HashMapGetStatistics(plain);
+    ASSERT_THAT(COLLIDING_TEST_KEYS == stats.maxChainLength && 0 == stats.numberOfRehashes);
+    ASSERT_THAT(stats.numberOfFloodWarnings >= 1);
+
+    stats = HashMapGetStatistics(seeded);
+    ASSERT_THAT(stats.maxChainLength <= 16 && 0 == stats.numberOfRehashes && 0 == stats.numberOfFloodWarnings);
+    for (i = 0; i < COLLIDING_TEST_KEYS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HashMapFind(seeded, keys[i], (void**)&value) && keys[i] == value);
+    }
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == HashMapFind(seeded, "abab", (void**)&value));
+    ASSERT_THAT(NULL == HashMapFreeze(seeded));
+    HashMapDestroy(&plain, NULL, NULL);
+    HashMapDestroy(&seeded, NULL, NULL);
+
+    /* multiples of the capacity are spread from the first insert */
+    seeded = HashMapCreateSeeded(11, HashSizeTSeeded, EqualSizeT);
+    ASSERT_THAT(NULL != seeded);
+    for (i = 0; i < FLOOD_TEST_KEYS; ++i) {
+        numbers[i] = i * 11;
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(seeded, numbers + i, numbers + i));
+    }
+    ASSERT_THAT(HashSizeTSeeded(numbers + 1, 1) != HashSizeTSeeded(numbers + 1, 2));
+    stats = HashMapGetStatistics(seeded);
+    ASSERT_THAT(0 == stats.numberOfRehashes && 11 == stats.numberOfBuckets);
+    ASSERT_THAT(stats.maxChainLength < FLOOD_TEST_KEYS / 4);
+    for (i = 0; i < FLOOD_TEST_KEYS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HashMapFind(seeded, numbers + i, (void**)&value) && (char*)(numbers + i) == value);
+    }
+    HashMapDestroy(&seeded, NULL, NULL);
+END_UNIT
+
+
+#define BLOOM_TEST_KEYS (10000)
+
+UNIT(Bloom_Add_Query_Batch_Serialize)
+    size_t hashes[BLOOM_TEST_KEYS];
+    unsigned char results[BLOOM_TEST_KEYS];
+    size_t falsePositives = 0;
+    size_t i = 0;
+    size_t size = 0;
+    void* buffer = NULL;
+    Bloom* copy = NULL;
+    Bloom* bloom = BloomCreate(BLOOM_TEST_KEYS, 0.01);
+    ASSERT_THAT(NULL != bloom);
+    ASSERT_THAT(NULL == BloomCreate(BLOOM_TEST_KEYS, 1.5));
+    ASSERT_THAT(!BloomMayContain(bloom, 42));
+
+    for (i = 0; i < BLOOM_TEST_KEYS; ++i) {
+        hashes[i] = i * 7919;
+        ASSERT_THAT(DS_SUCCESS == BloomAdd(bloom, hashes[i]));
+    }
+    ASSERT_THAT(BLOOM_TEST_KEYS == BloomSize(bloom));
+    ASSERT_THAT(BLOOM_TEST_KEYS == BloomMayContainBatch(bloom, hashes, BLOOM_TEST_KEYS, results));
+
+    for (i = 0; i < BLOOM_TEST_KEYS; ++i) {
+        hashes[i] = i * 7919 + 1;
+    }
+    falsePositives = BloomMayContainBatch(bloom, hashes, BLOOM_TEST_KEYS, results);
+    ASSERT_THAT(falsePositives < BLOOM_TEST_KEYS / 50);
+
+    size = BloomSerialize(bloom, NULL, 0);
+    buffer = malloc(size);
+    ASSERT_THAT(NULL != buffer);
+    ASSERT_THAT(size == BloomSerialize(bloom, buffer, size));
+    ASSERT_THAT(NULL == BloomDeserialize(buffer, size - 1));
+    copy = BloomDeserialize(buffer, size);
+    free(buffer);
+    ASSERT_THAT(NULL != copy);
+    ASSERT_THAT(BLOOM_TEST_KEYS == BloomSize(copy));
+    ASSERT_THAT(falsePositives == BloomMayContainBatch(copy, hashes, BLOOM_TEST_KEYS, results));
+    ASSERT_THAT(BloomMayContain(copy, 7919));
+
+    BloomDestroy(&bloom);
+    BloomDestroy(&copy);
+    ASSERT_THAT(NULL == bloom && NULL == copy);
+END_UNIT
+
+UNIT(HashMap_Attached_Bloom_Rejects_Missing_Keys)
+    size_t keys[100];
+    size_t missing = 1000;
+    size_t i = 0;
+    size_t* value = NULL;
+    Bloom* bloom = BloomCreate(100, 0.001);
+    HashMap* map = HashMapCreate(50, HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != map && NULL != bloom);
+    for (i = 0; i < 100; ++i) {
+        keys[i] = i;
+        if (i < 50) {
+            ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, keys + i, keys + i));
+        }
+    }
+    ASSERT_THAT(DS_SUCCESS == HashMapAttachBloom(map, bloom));
+    ASSERT_THAT(50 == BloomSize(bloom));
+    for (i = 50; i < 100; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, keys + i, keys + i));
+    }
+    ASSERT_THAT(100 == BloomSize(bloom));
+    for (i = 0; i < 100; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HashMapFind(map, keys + i, (void**)&value) && keys[i] == *value);
+    }
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == HashMapFind(map, &missing, (void**)&value));
+    ASSERT_THAT(DS_SUCCESS == HashMapAttachBloom(map, NULL));
+    HashMapDestroy(&map, NULL, NULL);
+    BloomDestroy(&bloom);
+END_UNIT
+
+UNIT(HashMap_Parallel_Build_From_Arrays)
+    size_t keys[3000];
+    void* keyPtrs[3000];
+    void* valPtrs[3000];
+    size_t floods[40];
+    size_t i = 0;
+    size_t* value = NULL;
+    Map_Stats stats;
+    HashMap* map = NULL;
+    /* keys repeat every 1000 pairs, the first pair of a key must win */
+    for (i = 0; i < 3000; ++i) {
+        keys[i] = i % 1000;
+        keyPtrs[i] = keys + i;
+        valPtrs[i] = keys + i;
+    }
+
+    map = HashMapBuildFromArrays(keyPtrs, valPtrs, 3000, 4, HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != map);
+    ASSERT_THAT(1000 == HashMapSize(map));
+    for (i = 0; i < 1000; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HashMapFind(map, keys + i, (void**)&value) && keys + i == value);
+    }
+
+    /* the bulk loaded pairs count towards the flood check, a flood right after the build reseeds */
+    stats = HashMapGetStatistics(map);
+    for (i = 0; i < sizeof(floods) / sizeof(size_t); ++i) {
+        floods[i] = (i + 1) * stats.numberOfBuckets;
+        ASSERT_THAT(DS_SUCCESS == HashMapInsert(map, floods + i, floods + i));
+    }
+    stats = HashMapGetStatistics(map);
+    ASSERT_THAT(stats.numberOfRehashes >= 1 && stats.maxChainLength <= 16 + 2 * 1040 / stats.numberOfBuckets);
+    HashMapDestroy(&map, NULL, NULL);
+
+    map = HashMapBuildFromArrays(keyPtrs, valPtrs, 1, 8, HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != map && 1 == HashMapSize(map));
+    HashMapDestroy(&map, NULL, NULL);
+
+    valPtrs[2500] = NULL;
+    ASSERT_THAT(NULL == HashMapBuildFromArrays(keyPtrs, valPtrs, 3000, 4, HashSizeT, EqualSizeT));
+    ASSERT_THAT(NULL == HashMapBuildFromArrays(keyPtrs, valPtrs, 3000, 0, HashSizeT, EqualSizeT));
+END_UNIT
+
+
+int SumU64Keys(uint64_t _key, uint64_t _value, void* _context) {
+    (void)_value;
+    *(uint64_t*)_context += _key;
+    return 1;
+}
+
+#define U64_TEST_KEYS (100000)
+
+UNIT(U64Map_Insert_Find_Remove_Grow)
+    uint64_t i = 0;
+    uint64_t value = 0;
+    uint64_t sum = 0;
+    uint64_t expected = 0;
+    U64Map* map = U64MapCreate(4);
+    ASSERT_THAT(NULL != map);
+
+    /* keys 0, 3, 6, ... including the key 0 kept outside the table */
+    for (i = 0; i < U64_TEST_KEYS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == U64MapInsert(map, i * 3, i));
+    }
+    ASSERT_THAT(DS_KEY_EXISTS_ERROR == U64MapInsert(map, 0, 1));
+    ASSERT_THAT(DS_KEY_EXISTS_ERROR == U64MapInsert(map, 30, 1));
+    ASSERT_THAT(U64_TEST_KEYS == U64MapSize(map));
+
+    for (i = 0; i < U64_TEST_KEYS; i += 2) {
+        ASSERT_THAT(DS_SUCCESS == U64MapRemove(map, i * 3, &value) && i == value);
+    }
+    ASSERT_THAT(U64_TEST_KEYS / 2 == U64MapSize(map));
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == U64MapRemove(map, 0, NULL));
+
+    for (i = 0; i < U64_TEST_KEYS; ++i) {
+        if (i % 2 == 0) {
+            ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == U64MapFind(map, i * 3, &value));
+        } else {
+            ASSERT_THAT(DS_SUCCESS == U64MapFind(map, i * 3, &value) && i == value);
+            expected += i * 3;
+        }
+        ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == U64MapFind(map, i * 3 + 1, &value));
+    }
+    ASSERT_THAT(U64_TEST_KEYS / 2 == U64MapForEach(map, SumU64Keys, &sum) && expected == sum);
+
+    U64MapDestroy(&map);
+    ASSERT_THAT(NULL == map);
+END_UNIT
+
+
+int CountKeyBytes(const char* _key, size_t _keyLength, void* _value, void* _context) {
+    (void)_key;
+    (void)_value;
+    *(size_t*)_context += _keyLength;
+    return 1;
+}
+
+UNIT(StrMap_Inline_And_Arena_Keys)
+    char key[64];
+    char longKey[5000];
+    size_t values[1000];
+    size_t i = 0;
+    size_t bytes = 0;
+    size_t expectedBytes = 0;
+    size_t* value = NULL;
+    StrMap* map = StrMapCreate(2);
+    ASSERT_THAT(NULL != map);
+
+    /* short keys stay inline, keys longer than STR_MAP_INLINE_KEY go to the arena */
+    for (i = 0; i < 1000; ++i) {
+        values[i] = i;
+        sprintf(key, (i % 2) ? "k%lu" : "a rather long key number %lu", (unsigned long)i);
+        expectedBytes += strlen(key);
+        ASSERT_THAT(DS_SUCCESS == StrMapInsert(map, key, strlen(key), values + i));
+    }
+    memset(longKey, 'x', sizeof(longKey));
+    ASSERT_THAT(DS_SUCCESS == StrMapInsert(map, longKey, sizeof(longKey), values));
+    ASSERT_THAT(DS_SUCCESS == StrMapInsert(map, "", 0, values + 1));
+    ASSERT_THAT(DS_KEY_EXISTS_ERROR == StrMapInsert(map, "k1", 2, values));
+    ASSERT_THAT(1002 == StrMapSize(map));
+
+    /* the map owns its copies, the caller buffer is reused */
+    strcpy(key, "k1 and more");
+    ASSERT_THAT(DS_SUCCESS == StrMapFind(map, key, 2, (void**)&value) && 1 == *value);
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == StrMapFind(map, key, 3, (void**)&value));
+    ASSERT_THAT(DS_SUCCESS == StrMapFind(map, longKey, sizeof(longKey), (void**)&value) && 0 == *value);
+    ASSERT_THAT(DS_SUCCESS == StrMapFind(map, "", 0, (void**)&value) && 1 == *value);
+
+    for (i = 0; i < 1000; i += 3) {
+        sprintf(key, (i % 2) ? "k%lu" : "a rather long key number %lu", (unsigned long)i);
+        expectedBytes -= strlen(key);
+        ASSERT_THAT(DS_SUCCESS == StrMapRemove(map, key, strlen(key), (void**)&value) && i == *value);
+    }
+    for (i = 0; i < 1000; ++i) {
+        sprintf(key, (i % 2) ? "k%lu" : "a rather long key number %lu", (unsigned long)i);
+        ASSERT_THAT((i % 3 == 0) == (DS_ELEMENT_NOT_FOUND_ERROR == StrMapFind(map, key, strlen(key), (void**)&value)));
+    }
+    StrMapRemove(map, "", 0, NULL);
+    StrMapRemove(map, longKey, sizeof(longKey), NULL);
+    ASSERT_THAT(StrMapSize(map) == StrMapForEach(map, CountKeyBytes, &bytes));
+    ASSERT_THAT(expectedBytes == bytes);
+
+    /* churn of long keys compacts the arena, the keys left in the map must move with it */
+    for (i = 0; i < 20000; ++i) {
+        sprintf(key, "a churned key that lives in the arena %lu", (unsigned long)i);
+        ASSERT_THAT(DS_SUCCESS == StrMapInsert(map, key, strlen(key), values));
+        ASSERT_THAT(DS_SUCCESS == StrMapRemove(map, key, strlen(key), NULL));
+    }
+    for (i = 0; i < 1000; ++i) {
+        sprintf(key, (i % 2) ? "k%lu" : "a rather long key number %lu", (unsigned long)i);
+        ASSERT_THAT((i % 3 == 0) == (DS_ELEMENT_NOT_FOUND_ERROR == StrMapFind(map, key, strlen(key), (void**)&value)));
+        ASSERT_THAT(i % 3 == 0 || i == *value);
+    }
+
+    StrMapDestroy(&map, NULL);
+    ASSERT_THAT(NULL == map);
+END_UNIT
+
+
+/* a replaced pair whose key the new pair reuses comes with a NULL key */
+void CountEvicted(void* _key, void* _value, void* _context) {
+    (void)_value;
+    if (NULL != _key) {
+        ++((size_t*)_context)[*(size_t*)_key];
+    }
+}
+
+size_t WeighByKey(const void* _key, const void* _value) {
+    (void)_value;
+    return *(const size_t*)_key;
+}
+
+UNIT(LRUCache_Count_Limit_Recency_And_Counters)
+    size_t keys[10];
+    size_t evicted[10] = {0};
+    size_t two = 2;
+    size_t i = 0;
+    size_t* value = NULL;
+    size_t* key = NULL;
+    LRU_Stats stats;
+    LRUCache* cache = LRUCacheCreate(3, 0, HashSizeT, EqualSizeT, NULL, CountEvicted, evicted);
+    ASSERT_THAT(NULL != cache);
+    ASSERT_THAT(NULL == LRUCacheCreate(0, 0, HashSizeT, EqualSizeT, NULL, NULL, NULL));
+    for (i = 0; i < 10; ++i) {
+        keys[i] = i;
+    }
+
+    ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, keys + 0, keys + 0));
+    ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, keys + 1, keys + 1));
+    ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, keys + 2, keys + 2));
+    /* 0 becomes the most recent, peek does not save 1 */
+    ASSERT_THAT(DS_SUCCESS == LRUCacheGet(cache, keys + 0, (void**)&value) && 0 == *value);
+    ASSERT_THAT(DS_SUCCESS == LRUCachePeek(cache, keys + 1, (void**)&value) && 1 == *value);
+    ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, keys + 3, keys + 3));
+    ASSERT_THAT(1 == evicted[1] && 0 == evicted[0] && 0 == evicted[2]);
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == LRUCacheGet(cache, keys + 1, (void**)&value));
+    ASSERT_THAT(3 == LRUCacheSize(cache));
+
+    /* replacing hands the old pair to the evict function but is no eviction,
+     * the key object still in use is not handed over */
+    ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, keys + 2, keys + 5));
+    ASSERT_THAT(0 == evicted[2]);
+    ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, &two, keys + 5));
+    ASSERT_THAT(1 == evicted[2]);
+    ASSERT_THAT(DS_SUCCESS == LRUCachePeek(cache, keys + 2, (void**)&value) && keys + 5 == value);
+    ASSERT_THAT(DS_SUCCESS == LRUCacheRemove(cache, keys + 3, (void**)&key, (void**)&value) && keys + 3 == key);
+
+    stats = LRUCacheGetStatistics(cache);
+    ASSERT_THAT(1 == stats.hits && 1 == stats.misses && 1 == stats.evictions);
+    ASSERT_THAT(2 == stats.size && 2 == stats.weight);
+
+    LRUCacheDestroy(&cache);
+    ASSERT_THAT(NULL == cache);
+    ASSERT_THAT(1 == evicted[0] && 2 == evicted[2] && 0 == evicted[3]);
+END_UNIT
+
+UNIT(LRUCache_Weight_Limit)
+    size_t keys[10];
+    size_t evicted[10] = {0};
+    size_t many[HEAP_TEST_ITEMS * 5];
+    size_t i = 0;
+    size_t* value = NULL;
+    LRU_Stats stats;
+    LRUCache* cache = LRUCacheCreate(0, 10, HashSizeT, EqualSizeT, WeighByKey, CountEvicted, evicted);
+    ASSERT_THAT(NULL != cache);
+    for (i = 0; i < 10; ++i) {
+        keys[i] = i;
+    }
+    ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, keys + 4, NULL));
+    ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, keys + 5, NULL));
+    ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, keys + 1, NULL));
+    ASSERT_THAT(10 == LRUCacheGetStatistics(cache).weight);
+    /* 9 pushes out 4 and 5 but 1 still fits */
+    ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, keys + 9, NULL));
+    stats = LRUCacheGetStatistics(cache);
+    ASSERT_THAT(2 == stats.evictions && 10 == stats.weight && 2 == stats.size);
+    ASSERT_THAT(1 == evicted[4] && 1 == evicted[5] && 0 == evicted[1]);
+    LRUCacheDestroy(&cache);
+
+    /* a weight limit alone does not size the map, it has to grow with the pairs */
+    cache = LRUCacheCreate(0, HEAP_TEST_ITEMS * 5, HashSizeT, EqualSizeT, NULL, NULL, NULL);
+    ASSERT_THAT(NULL != cache);
+    for (i = 0; i < HEAP_TEST_ITEMS * 5; ++i) {
+        many[i] = i;
+        ASSERT_THAT(DS_SUCCESS == LRUCachePut(cache, many + i, many + i));
+    }
+    for (i = 0; i < HEAP_TEST_ITEMS * 5; ++i) {
+        ASSERT_THAT(DS_SUCCESS == LRUCacheGet(cache, many + i, (void**)&value) && many + i == value);
+    }
+    ASSERT_THAT(HEAP_TEST_ITEMS * 5 == LRUCacheSize(cache));
+    LRUCacheDestroy(&cache);
+END_UNIT
+
+UNIT(TTLMap_Timing_Wheel_Levels_And_Lazy_Expiry)
+    size_t keys[10];
+    size_t expired[10] = {0};
+    size_t i = 0;
+    size_t* value = NULL;
+    size_t* key = NULL;
+    TTLMap* map = TTLMapCreate(16, 100, HashSizeT, EqualSizeT, CountEvicted, expired, 0);
+    ASSERT_THAT(NULL != map);
+    for (i = 0; i < 10; ++i) {
+        keys[i] = i;
+    }
+
+    /* one pair for every wheel level and one beyond the wheel */
+    ASSERT_THAT(DS_SUCCESS == TTLMapInsert(map, keys + 0, keys + 0, 0));
+    ASSERT_THAT(DS_SUCCESS == TTLMapInsert(map, keys + 1, keys + 1, 5));
+    ASSERT_THAT(DS_SUCCESS == TTLMapInsert(map, keys + 2, keys + 2, 70));
+    ASSERT_THAT(DS_SUCCESS == TTLMapInsert(map, keys + 3, keys + 3, 5000));
+    ASSERT_THAT(DS_SUCCESS == TTLMapInsert(map, keys + 4, keys + 4, 300000));
+    ASSERT_THAT(DS_SUCCESS == TTLMapInsert(map, keys + 5, keys + 5, 40000000));
+    ASSERT_THAT(DS_KEY_EXISTS_ERROR == TTLMapInsert(map, keys + 5, keys + 5, 1));
+    ASSERT_THAT(6 == TTLMapSize(map));
+
+    ASSERT_THAT(0 == TTLMapTick(map, 100));
+    ASSERT_THAT(1 == TTLMapTick(map, 101) && 1 == expired[0]);
+    ASSERT_THAT(DS_SUCCESS == TTLMapFind(map, keys + 1, 104, (void**)&value) && 1 == *value);
+    /* out of date but kept until the tick reaches it */
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == TTLMapFind(map, keys + 1, 105, (void**)&value));
+    ASSERT_THAT(5 == TTLMapSize(map) && 0 == expired[1]);
+    ASSERT_THAT(1 == TTLMapTick(map, 105) && 1 == expired[1]);
+    ASSERT_THAT(0 == TTLMapTick(map, 169));
+    ASSERT_THAT(1 == TTLMapTick(map, 170) && 1 == expired[2]);
+
+    /* removing does not expire, a new ttl counts from the last tick */
+    ASSERT_THAT(DS_SUCCESS == TTLMapRemove(map, keys + 3, (void**)&key, (void**)&value) && keys + 3 == key);
+    ASSERT_THAT(0 == expired[3]);
+    ASSERT_THAT(DS_SUCCESS == TTLMapInsert(map, keys + 3, keys + 3, 5000));
+    ASSERT_THAT(0 == TTLMapTick(map, 5169));
+    ASSERT_THAT(1 == TTLMapTick(map, 5170) && 1 == expired[3]);
+    ASSERT_THAT(0 == TTLMapTick(map, 300099));
+    ASSERT_THAT(1 == TTLMapTick(map, 300100) && 1 == expired[4]);
+    ASSERT_THAT(0 == TTLMapTick(map, 40000099));
+    ASSERT_THAT(1 == TTLMapTick(map, 40000100) && 1 == expired[5]);
+    ASSERT_THAT(0 == TTLMapSize(map));
+    TTLMapDestroy(&map, NULL, NULL);
+    ASSERT_THAT(NULL == map);
+
+    /* lazy expiry drops the pair on the find that sees it out of date */
+    map = TTLMapCreate(16, 0, HashSizeT, EqualSizeT, CountEvicted, expired, 1);
+    ASSERT_THAT(DS_SUCCESS == TTLMapInsert(map, keys + 6, keys + 6, 10));
+    ASSERT_THAT(DS_SUCCESS == TTLMapInsert(map, keys + 7, keys + 7, 10));
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == TTLMapFind(map, keys + 6, 10, (void**)&value));
+    ASSERT_THAT(1 == expired[6] && 1 == TTLMapSize(map));
+    ASSERT_THAT(1 == TTLMapTick(map, 20) && 1 == expired[7]);
+    ASSERT_THAT(1 == expired[6]);
+    TTLMapDestroy(&map, NULL, NULL);
+END_UNIT
+
+UNIT(HashMultiMap_Contiguous_Values_Per_Key)
+    size_t keys[10];
+    size_t otherKey = 1;
+    size_t i = 0;
+    size_t* key = NULL;
+    MultiValues span;
+    HashMultiMap* map = HashMultiMapCreate(8, HashSizeT, EqualSizeT);
+    ASSERT_THAT(NULL != map);
+    for (i = 0; i < 10; ++i) {
+        keys[i] = i;
+    }
+
+    /* key 1 gets a skewed fan out, values keep insertion order and duplicates */
+    for (i = 0; i < 100; ++i) {
+        ASSERT_THAT(DS_SUCCESS == HashMultiMapInsertMulti(map, keys + 1, keys + i % 10));
+    }
+    ASSERT_THAT(DS_SUCCESS == HashMultiMapInsertMulti(map, &otherKey, keys + 7));
+    ASSERT_THAT(DS_SUCCESS == HashMultiMapInsertMulti(map, keys + 2, keys + 2));
+    ASSERT_THAT(DS_INVALID_PARAM_ERROR == HashMultiMapInsertMulti(map, NULL, keys + 2));
+    ASSERT_THAT(102 == HashMultiMapSize(map) && 2 == HashMultiMapKeys(map));
+
+    span = HashMultiMapFindAll(map, &otherKey);
+    ASSERT_THAT(101 == span.m_count && 101 == HashMultiMapCountKey(map, keys + 1));
+    for (i = 0; i < 100; ++i) {
+        ASSERT_THAT(keys + i % 10 == span.m_values[i]);
+    }
+    ASSERT_THAT(keys + 7 == span.m_values[100]);
+    ASSERT_THAT(0 == HashMultiMapFindAll(map, keys + 3).m_count);
+    ASSERT_THAT(0 == HashMultiMapCountKey(map, keys + 3));
+
+    /* the key of the first insert is the stored one */
+    ASSERT_THAT(DS_SUCCESS == HashMultiMapRemoveAll(map, &otherKey, (void**)&key, NULL) && keys + 1 == key);
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == HashMultiMapRemoveAll(map, keys + 1, (void**)&key, NULL));
+    ASSERT_THAT(1 == HashMultiMapSize(map) && 1 == HashMultiMapKeys(map));
+    ASSERT_THAT(1 == HashMultiMapCountKey(map, keys + 2));
+    HashMultiMapDestroy(&map, NULL, NULL);
+    ASSERT_THAT(NULL == map);
+END_UNIT
+
+#define CUCKOO_TEST_KEYS (10000)
+
+UNIT(CuckooFilter_Add_Contains_Delete_Overflow)
+    size_t i = 0;
+    size_t falsePositives = 0;
+    size_t added = 0;
+    aps_ds_error err = DS_SUCCESS;
+    CuckooFilter* filter = CuckooFilterCreate(CUCKOO_TEST_KEYS);
+    ASSERT_THAT(NULL != filter);
+    ASSERT_THAT(NULL == CuckooFilterCreate(0));
+
+    for (i = 0; i < CUCKOO_TEST_KEYS; ++i) {
+        ASSERT_THAT(DS_SUCCESS == CuckooFilterAdd(filter, i * 7919));
+    }
+    ASSERT_THAT(CUCKOO_TEST_KEYS == CuckooFilterSize(filter));
+    for (i = 0; i < CUCKOO_TEST_KEYS; ++i) {
+        ASSERT_THAT(CuckooFilterContains(filter, i * 7919));
+        falsePositives += (size_t)(0 != CuckooFilterContains(filter, i * 7919 + 1));
+    }
+    /* about 8 in 65536 */
+    ASSERT_THAT(falsePositives < 20);
+
+    /* deleting half keeps the other half */
+    for (i = 0; i < CUCKOO_TEST_KEYS; i += 2) {
+        ASSERT_THAT(DS_SUCCESS == CuckooFilterDelete(filter, i * 7919));
+    }
+    falsePositives = 0;
+    for (i = 0; i < CUCKOO_TEST_KEYS; ++i) {
+        if (i % 2 == 1) {
+            ASSERT_THAT(CuckooFilterContains(filter, i * 7919));
+        } else {
+            falsePositives += (size_t)(0 != CuckooFilterContains(filter, i * 7919));
+        }
+    }
+    ASSERT_THAT(falsePositives < 20);
+    ASSERT_THAT(CUCKOO_TEST_KEYS / 2 == CuckooFilterSize(filter));
+    ASSERT_THAT(DS_ELEMENT_NOT_FOUND_ERROR == CuckooFilterDelete(filter, 1));
+    CuckooFilterDestroy(&filter);
+    ASSERT_THAT(NULL == filter);
+
+    /* a full filter refuses adds but never forgets one it accepted */
+    filter = CuckooFilterCreate(100);
+    for (i = 0; err == DS_SUCCESS; ++i) {
+        err = CuckooFilterAdd(filter, i);
+        added += (err == DS_SUCCESS);
+    }
+    ASSERT_THAT(DS_OVERFLOW_ERROR == err && added >= 100 && added == CuckooFilterSize(filter));
+    for (i = 0; i < added; ++i) {
+        ASSERT_THAT(CuckooFilterContains(filter, i));
+    }
+    ASSERT_THAT(DS_SUCCESS == CuckooFilterDelete(filter, 0));
+    ASSERT_THAT(DS_SUCCESS == CuckooFilterDelete(filter, 1));
+    for (i = 2; i < added; ++i) {
+        ASSERT_THAT(CuckooFilterContains(filter, i));
+    }
+    CuckooFilterDestroy(&filter);
+END_UNIT
+
+
 TEST_SUITE(Test DataStructures)
     /* bubble Sort Tests */
 	TEST(basic_valid_size_t_pointer_bubble_sort_test)
@@ -459,6 +2014,17 @@ TEST_SUITE(Test DataStructures)
     TEST(Append_To_Heap_Max_Elements_Expect_No_Crash)
     TEST(Append_To_Heap_Min_Elements_And_Pop)
     TEST(Append_To_Heap_Max_Elements_And_Pop)
+    TEST(Heap_Push_Pop_Many_Beyond_Capacity)
+    TEST(Heap_Create_From_Array_And_Push_Batch)
+    TEST(Heap_DAry_4_And_8_Way_Order)
+    TEST(Heap_Handles_Update_Remove_DecreaseKey)
+    TEST(Heap_Bounded_Top_K_Offer_And_Extract)
+    TEST(KeyHeap_Min_Max_Inline_Priorities)
+    TEST(PairingHeap_Push_Meld_DecreaseKey_Pop)
+    TEST(MultiQueue_Single_Lane_Order_And_Relaxed_Pop)
+    TEST(MultiQueue_Concurrent_Push_Pop)
+    TEST(MinMaxHeap_Pop_Both_Ends)
+    TEST(RadixHeap_Monotone_Keys)
     
     /* Queue Tests */
     TEST(Allocate_Queue)
@@ -475,4 +2041,47 @@ TEST_SUITE(Test DataStructures)
     /* Binary Tree Tests */
     TEST(Allocate_BTree)
     TEST(BTree_Valid_Unit_Test)
+
+    /* Hash Map Tests */
+    TEST(HashMap_Iterator_And_Parallel_ForEach)
+    TEST(HashMap_Statistics_Histogram_And_Sampling)
+    TEST(HashMap_Rehash_And_Flood_Reseed)
+    TEST(HashMap_Seeded_Hash_Scatters_Equal_Hashes)
+    TEST(HashMap_Attached_Bloom_Rejects_Missing_Keys)
+    TEST(HashMap_Parallel_Build_From_Arrays)
+
+    /* Hash Multi Map Tests */
+    TEST(HashMultiMap_Contiguous_Values_Per_Key)
+
+    /* Integer Key Map Tests */
+    TEST(U64Map_Insert_Find_Remove_Grow)
+
+    /* String Key Map Tests */
+    TEST(StrMap_Inline_And_Arena_Keys)
+
+    /* LRU Cache Tests */
+    TEST(LRUCache_Count_Limit_Recency_And_Counters)
+    TEST(LRUCache_Weight_Limit)
+
+    /* TTL Map Tests */
+    TEST(TTLMap_Timing_Wheel_Levels_And_Lazy_Expiry)
+
+    /* Bloom Filter Tests */
+    TEST(Bloom_Add_Query_Batch_Serialize)
+
+    /* Cuckoo Filter Tests */
+    TEST(CuckooFilter_Add_Contains_Delete_Overflow)
+
+    /* Read-mostly Hash Map Tests */
+    TEST(RCUHashMap_Insert_Find_Remove)
+    TEST(RCUHashMap_Concurrent_Readers_And_Writer)
+
+    /* Frozen Hash Map Tests */
+    TEST(FrozenHashMap_Freeze_Find_Dump_Load)
+    TEST(FrozenHashMap_Equal_Hashes)
+    TEST(FrozenHashMap_Load_Rejects_Corrupted_Image)
+    TEST(HashMap_Save_And_Map_Image)
+
+    /* Hash Set Tests */
+    TEST(HashSet_Insert_Contains_Remove_Set_Operations)
 END_SUITE